@@ -79,6 +79,61 @@
 		LeaveCriticalSection(&CSMutex);
 	}
 
+	bool Condition::TimedWait(unsigned long usec)
+	{
+		EnterCriticalSection(&CSMutex);
+
+		m_waiters++;
+
+
+		LeaveCriticalSection(&CSMutex);
+		int result = WaitForMultipleObjects (_eventCount, m_events, FALSE, usec / 1000);
+		EnterCriticalSection(&CSMutex);
+
+		m_waiters--;
+
+		//see if we are the last person waiting on the condition, and there was a broadcast
+		//if so, we need to reset the broadcast event.
+		if(m_waiters == 0 && result == (WAIT_OBJECT_0+BroadcastEvent))
+			ResetEvent(m_events[BroadcastEvent]);
+
+		LeaveCriticalSection(&CSMutex);
+
+		return result != WAIT_TIMEOUT;
+	}
+
+	void Condition::Lock()
+	{
+		EnterCriticalSection(&CSMutex);
+	}
+
+	void Condition::Unlock()
+	{
+		LeaveCriticalSection(&CSMutex);
+	}
+
+	void Condition::SignalLocked()
+	{
+		if(m_waiters > 0)
+			SetEvent(m_events[SignalEvent]);
+	}
+
+	void Condition::WaitLocked()
+	{
+		//counted as a waiter before the lock is let go, so a signal sent before
+		//we reach the wait leaves the event set instead of being dropped
+		m_waiters++;
+
+		LeaveCriticalSection(&CSMutex);
+		int result = WaitForMultipleObjects (_eventCount, m_events, FALSE, INFINITE);
+		EnterCriticalSection(&CSMutex);
+
+		m_waiters--;
+
+		if(m_waiters == 0 && result == (WAIT_OBJECT_0+BroadcastEvent))
+			ResetEvent(m_events[BroadcastEvent]);
+	}
+
 #else
 	#include <pthread.h>
 	#include <sys/time.h>
@@ -111,12 +166,6 @@
 		pthread_mutex_unlock(&mutex);
 	}
 
-	/*
-	I commented this specifically because I think it might be very
-	difficult to write a windows counterpart to it, so I would like
-	to discourage its use until we can confirm that it can be reasonably
-	implemented on windows.
-
 	bool Condition::TimedWait(unsigned long usec)
 	{
 	struct timeval now;
@@ -127,14 +176,31 @@
 		now.tv_usec+=usec;
 		timeout.tv_sec = now.tv_sec + (now.tv_usec/1000000);
 		timeout.tv_nsec = (now.tv_usec%1000000) *1000;
-		//cout << "now=" << now.tv_sec << "."<<now.tv_usec << endl;
-		//cout << "timeout=" << timeout.tv_sec << "."<<timeout.tv_nsec << endl;
 		retcode=pthread_cond_timedwait(&cond,&mutex,&timeout);
 		pthread_mutex_unlock(&mutex);
 
 		return retcode!=ETIMEDOUT;
 	}
-	*/
+
+	void Condition::Lock()
+	{
+		pthread_mutex_lock(&mutex);
+	}
+
+	void Condition::Unlock()
+	{
+		pthread_mutex_unlock(&mutex);
+	}
+
+	void Condition::SignalLocked()
+	{
+		pthread_cond_signal(&cond);
+	}
+
+	void Condition::WaitLocked()
+	{
+		pthread_cond_wait(&cond,&mutex);
+	}
 
 	Condition::~Condition()
 	{
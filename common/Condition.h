@@ -48,7 +48,14 @@ class Condition {
 		void Signal();
 		void SignalAll();
 		void Wait();
-//		bool TimedWait(unsigned long usec);
+		//returns false if usec passed without a signal
+		bool TimedWait(unsigned long usec);
+		//to wait for some state without missing a signal, keep the state under Lock(), check it
+		//and WaitLocked() without unlocking in between, and change it under Lock() before SignalLocked()
+		void Lock();
+		void Unlock();
+		void SignalLocked();
+		void WaitLocked();
 		~Condition();
 };
 
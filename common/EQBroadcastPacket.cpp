@@ -0,0 +1,111 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "debug.h"
+#include "EQBroadcastPacket.h"
+#include "EQPacket.h"
+#include "EQStreamIntf.h"
+#include "StructStrategy.h"
+
+//a stream that only collects what an encoder queues into it, used to capture the
+//output of a struct strategy without sending anything.
+class EncodeCollectorStream : public EQStreamInterface {
+public:
+	EncodeCollectorStream(std::vector<EQBroadcastPacket::EncodedPacket> &out) : m_out(out) { }
+
+	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true) {
+		if(p == nullptr)
+			return;
+		EQBroadcastPacket::EncodedPacket e;
+		e.packet = p->Copy();
+		e.ack_req = ack_req;
+		m_out.push_back(e);
+	}
+	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req=true) {
+		if(p == nullptr || *p == nullptr)
+			return;
+		EQBroadcastPacket::EncodedPacket e;
+		e.packet = *p;
+		e.ack_req = ack_req;
+		*p = nullptr;
+		m_out.push_back(e);
+	}
+	virtual EQApplicationPacket *PopPacket() { return(nullptr); }
+	virtual void Close() { }
+	virtual void ReleaseFromUse() { }
+	virtual void RemoveData() { }
+	virtual uint32 GetRemoteIP() const { return(0); }
+	virtual uint16 GetRemotePort() const { return(0); }
+	virtual bool CheckState(EQStreamState state) { return(state == ESTABLISHED); }
+	virtual std::string Describe() const { return("Encode Collector"); }
+	virtual bool IsInUse() { return(true); }
+
+protected:
+	std::vector<EQBroadcastPacket::EncodedPacket> &m_out;
+};
+
+EQBroadcastPacket::EQBroadcastPacket(const EQApplicationPacket *app)
+:	m_app(app),
+	m_encodes(0)
+{
+}
+
+EQBroadcastPacket::~EQBroadcastPacket() {
+	std::vector<EncodedVersion>::iterator cur, end;
+	cur = m_versions.begin();
+	end = m_versions.end();
+	for(; cur != end; ++cur) {
+		std::vector<EncodedPacket>::iterator pcur, pend;
+		pcur = cur->packets.begin();
+		pend = cur->packets.end();
+		for(; pcur != pend; ++pcur) {
+			safe_delete(pcur->packet);
+		}
+	}
+}
+
+const std::vector<EQBroadcastPacket::EncodedPacket> &EQBroadcastPacket::Encode(const StructStrategy *structs, bool ack_req) {
+	//only a handful of client versions, a linear search is fine.
+	std::vector<EncodedVersion>::iterator cur, end;
+	cur = m_versions.begin();
+	end = m_versions.end();
+	for(; cur != end; ++cur) {
+		if(cur->structs == structs && cur->ack_req == ack_req)
+			return(cur->packets);
+	}
+
+	EncodedVersion v;
+	v.structs = structs;
+	v.ack_req = ack_req;
+	m_versions.push_back(v);
+	EncodedVersion &res = m_versions.back();
+
+	if(m_app == nullptr)
+		return(res.packets);
+
+	//the encoders consume their input, so they get a copy of the original.
+	EQApplicationPacket *p = m_app->Copy();
+	EncodeCollectorStream collector(res.packets);
+	if(structs != nullptr)
+		structs->Encode(&p, &collector, ack_req);
+	else
+		collector.FastQueuePacket(&p, ack_req);
+	safe_delete(p);
+	m_encodes++;
+
+	return(res.packets);
+}
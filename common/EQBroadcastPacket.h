@@ -0,0 +1,68 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef EQBROADCASTPACKET_H_
+#define EQBROADCASTPACKET_H_
+
+#include "types.h"
+#include <vector>
+
+class EQApplicationPacket;
+class StructStrategy;
+
+//A packet that is about to be sent to many streams. Each struct strategy only encodes
+//it once, every stream using that strategy then queues the same encoded packets, so
+//the only per stream work left is the stream's own framing/sequencing copy.
+//
+//The encoded packets live as long as this object; streams copy what they need when
+//the packet is queued so it is only meant to live for the duration of one fan-out.
+class EQBroadcastPacket {
+public:
+	//does NOT take ownership of the supplied packet, it must outlive this object.
+	EQBroadcastPacket(const EQApplicationPacket *app);
+	~EQBroadcastPacket();
+
+	struct EncodedPacket {
+		EQApplicationPacket *packet;
+		bool ack_req;
+	};
+
+	const EQApplicationPacket *GetPacket() const { return(m_app); }
+
+	//returns the packets this strategy produces for m_app, encoding them on first use.
+	//the returned reference is only valid until the next call.
+	const std::vector<EncodedPacket> &Encode(const StructStrategy *structs, bool ack_req);
+
+	uint32 GetEncodeCount() const { return(m_encodes); }
+
+protected:
+	struct EncodedVersion {
+		const StructStrategy *structs;
+		bool ack_req;
+		std::vector<EncodedPacket> packets;
+	};
+
+	const EQApplicationPacket *m_app;
+	std::vector<EncodedVersion> m_versions;
+	uint32 m_encodes;
+
+private:
+	EQBroadcastPacket(const EQBroadcastPacket &);
+	EQBroadcastPacket &operator=(const EQBroadcastPacket &);
+};
+
+#endif /*EQBROADCASTPACKET_H_*/
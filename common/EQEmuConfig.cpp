@@ -129,6 +129,16 @@ void EQEmuConfig::do_world(TiXmlElement *ele) {
 
 	}
 
+	// Get the <udp> element
+	sub_ele = ele->FirstChildElement("udp");
+	if(sub_ele != nullptr) {
+
+		text = sub_ele->Attribute("readers");
+		if (text)
+			WorldUDPReaders=atoi(text);
+
+	}
+
 	// Get the <http> element
 	sub_ele = ele->FirstChildElement("http");
 	if(sub_ele != nullptr) {
@@ -198,6 +208,10 @@ void EQEmuConfig::do_database(TiXmlElement *ele) {
 	text=ParseTextBlock(ele,"db",true);
 	if (text)
 		DatabaseDB=text;
+
+	text=ParseTextBlock(ele,"asyncworkers",true);
+	if (text)
+		DatabaseAsyncWorkers=atoi(text);
 }
 
 
@@ -338,6 +352,14 @@ void EQEmuConfig::do_launcher(TiXmlElement *ele) {
 		if (text)
 			ZoneBootInterval = atoi(text);
 	}
+
+	// Get the <prewarm> element
+	sub_ele = ele->FirstChildElement("prewarm");
+	if(sub_ele != nullptr) {
+		text = sub_ele->Attribute("count");
+		if (text)
+			PrewarmZones = atoi(text);
+	}
 }
 
 std::string EQEmuConfig::GetByName(const std::string &var_name) const {
@@ -365,6 +387,8 @@ std::string EQEmuConfig::GetByName(const std::string &var_name) const {
 		return(WorldIP);
 	if(var_name == "TelnetEnabled")
 		return(TelnetEnabled?"true":"false");
+	if(var_name == "WorldUDPReaders")
+		return(itoa(WorldUDPReaders));
 	if(var_name == "WorldHTTPPort")
 		return(itoa(WorldHTTPPort));
 	if(var_name == "WorldHTTPMimeFile")
@@ -389,6 +413,8 @@ std::string EQEmuConfig::GetByName(const std::string &var_name) const {
 		return(DatabaseDB);
 	if(var_name == "DatabasePort")
 		return(itoa(DatabasePort));
+	if(var_name == "DatabaseAsyncWorkers")
+		return(itoa(DatabaseAsyncWorkers));
 	if(var_name == "QSDatabaseHost")
 		return(QSDatabaseHost);
 	if(var_name == "QSDatabaseUsername")
@@ -450,6 +476,7 @@ void EQEmuConfig::Dump() const
 	std::cout << "WorldTCPPort = " << WorldTCPPort << std::endl;
 	std::cout << "WorldIP = " << WorldIP << std::endl;
 	std::cout << "TelnetEnabled = " << TelnetEnabled << std::endl;
+	std::cout << "WorldUDPReaders = " << WorldUDPReaders << std::endl;
 	std::cout << "WorldHTTPPort = " << WorldHTTPPort << std::endl;
 	std::cout << "WorldHTTPMimeFile = " << WorldHTTPMimeFile << std::endl;
 	std::cout << "WorldHTTPEnabled = " << WorldHTTPEnabled << std::endl;
@@ -462,6 +489,7 @@ void EQEmuConfig::Dump() const
 	std::cout << "DatabasePassword = " << DatabasePassword << std::endl;
 	std::cout << "DatabaseDB = " << DatabaseDB << std::endl;
 	std::cout << "DatabasePort = " << DatabasePort << std::endl;
+	std::cout << "DatabaseAsyncWorkers = " << DatabaseAsyncWorkers << std::endl;
 	std::cout << "QSDatabaseHost = " << QSDatabaseHost << std::endl;
 	std::cout << "QSDatabaseUsername = " << QSDatabaseUsername << std::endl;
 	std::cout << "QSDatabasePassword = " << QSDatabasePassword << std::endl;
@@ -54,6 +54,7 @@ public:
 	uint16 WorldHTTPPort;
 	std::string WorldHTTPMimeFile;
 	std::string SharedKey;
+	uint16 WorldUDPReaders;
 
 	// From <chatserver/>
 	std::string ChatHost;
@@ -69,6 +70,7 @@ public:
 	std::string DatabasePassword;
 	std::string DatabaseDB;
 	uint16 DatabasePort;
+	uint16 DatabaseAsyncWorkers;
 
 	// From <qsdatabase> // QueryServ
 	std::string QSDatabaseHost;
@@ -101,6 +103,7 @@ public:
 	uint32 TerminateWait;
 	uint32 InitialBootWait;
 	uint32 ZoneBootInterval;
+	uint32 PrewarmZones;	//idle zone processes kept ready for static zones to attach to
 
 	// From <zones/>
 	uint16 ZonePortLow;
@@ -143,6 +146,7 @@ protected:
 		WorldHTTPPort=9080;
 		WorldHTTPMimeFile="mime.types";
 		SharedKey = "";	//blank disables authentication
+		WorldUDPReaders=1;
 
 		// Mail
 		ChatHost="eqchat.eqemulator.net";
@@ -155,6 +159,7 @@ protected:
 		// Mysql
 		DatabaseHost="localhost";
 		DatabasePort=3306;
+		DatabaseAsyncWorkers=2;
 		DatabaseUsername="eq";
 		DatabasePassword="eq";
 		DatabaseDB="eq";
@@ -189,6 +194,7 @@ protected:
 		TerminateWait = 10000;		//milliseconds
 		InitialBootWait = 20000;	//milliseconds
 		ZoneBootInterval = 2000;	//milliseconds
+		PrewarmZones = 0;
 #ifdef WIN32
 		ZoneExe = "zone.exe";
 #else
@@ -19,6 +19,7 @@
 #include "debug.h"
 #include "EQPacket.h"
 #include "EQStream.h"
+#include "EQStreamFactory.h"
 #include "misc.h"
 #include "Mutex.h"
 #include "op_codes.h"
@@ -69,6 +70,9 @@ void EQStream::init() {
 	BytesWritten=0;
 	SequencedBase = 0;
 	NextSequencedSend = 0;
+	Factory = nullptr;
+	WritePending = false;
+	WriteReadyTime = 0;
 
 	if(GetExecutablePlatform() == ExePlatformWorld || GetExecutablePlatform() == ExePlatformZone) {
 		retransmittimer = Timer::GetCurrentTime();
@@ -542,6 +546,8 @@ void EQStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
 	} else {
 		SendPacket(opcode, pack);
 	}
+	if (Factory)
+		Factory->StreamReady(this);
 }
 
 void EQStream::SendPacket(uint16 opcode, EQApplicationPacket *p)
@@ -1636,6 +1642,9 @@ EQOldStream::EQOldStream(sockaddr_in in, int fd_sock)
 	RateThreshold=RATEBASE/250;
 	DecayRate=DECAYBASE/250;
 	bTimeoutTrigger = false;
+	Factory = nullptr;
+	WritePending = false;
+	WriteReadyTime = 0;
 }
 
 EQOldStream::EQOldStream()
@@ -1678,6 +1687,9 @@ EQOldStream::EQOldStream()
 	active_users = 0;
 	LastPacket=0;
 	isWriting = false;
+	Factory = nullptr;
+	WritePending = false;
+	WriteReadyTime = 0;
 	RateThreshold=RATEBASE/250;
 	DecayRate=DECAYBASE/250;
 }
@@ -2252,15 +2264,17 @@ void EQOldStream::QueuePacket(const EQApplicationPacket *p, bool ack_req)
 	if(p == nullptr)
 		return;
 
+	//the caller still owns p (broadcast packets are queued to many streams), only drop it
 	if(OpMgr == nullptr || *OpMgr == nullptr) {
 		_log(NET__DEBUG, _L "Packet enqueued into a stream with no opcode manager, dropping.");
-		delete p;
 		return;
 	}
 	uint16 opcode = (*OpMgr)->EmuToEQ(p->emu_opcode);
 	EQProtocolPacket* pack2 = new EQProtocolPacket(opcode, p->pBuffer, p->size);
 	MakeEQPacket( pack2, ack_req);
 	delete pack2;
+	if (Factory)
+		Factory->StreamReady(this);
 }
 
 void EQOldStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
@@ -2291,6 +2305,8 @@ void EQOldStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
 	MakeEQPacket(pack2, ack_req);
 	delete pack;
 	delete pack2;
+	if (Factory)
+		Factory->StreamReady(this);
 }
 
 EQApplicationPacket *EQOldStream::PopPacket()
@@ -19,6 +19,8 @@
 #include "../common/timer.h"
 #include "queue.h"
 
+class EQStreamFactory;
+
 #define FLAG_COMPRESSED	0x01
 #define FLAG_ENCODED	0x04
 
@@ -190,6 +192,7 @@ private:
 
 class EQStream : public EQStreamInterface {
 	friend class EQStreamPair;	//for collector.
+	friend class EQStreamFactory;	//for the writer's ready queue.
 	protected:
 		typedef enum {
 			SeqPast,
@@ -262,6 +265,11 @@ class EQStream : public EQStreamInterface {
 
 		OpcodeManager **OpMgr;
 
+		//the factory that writes this stream, told whenever something is queued
+		EQStreamFactory *Factory;
+		bool WritePending;	//protected by the factory's ready queue lock
+		uint64 WriteReadyTime;
+
 		EQRawApplicationPacket *MakeApplicationPacket(EQProtocolPacket *p);
 		EQRawApplicationPacket *MakeApplicationPacket(const unsigned char *buf, uint32 len);
 		EQProtocolPacket *MakeProtocolPacket(const unsigned char *buf, uint32 len);
@@ -321,6 +329,7 @@ class EQStream : public EQStreamInterface {
 		virtual std::string Describe() const { return("Direct EQStream"); }
 
 		void SetOpcodeManager(OpcodeManager **opm) { OpMgr = opm; }
+		void SetFactory(EQStreamFactory *f) { Factory = f; }
 
 		void CheckTimeout(uint32 now, uint32 timeout=30);
 		bool HasOutgoingData();
@@ -397,6 +406,7 @@ class EQStream : public EQStreamInterface {
 class EQOldStream : public EQStreamInterface {
 	friend class EQStreamPair;	//for collector.
 	friend class EQStream;
+	friend class EQStreamFactory;	//for the writer's ready queue.
 
 	public:
 		EQOldStream();
@@ -521,6 +531,11 @@ class EQOldStream : public EQStreamInterface {
 		Mutex MVarlock;
 		bool sent_Fin;
 
+		//the factory that writes this stream, told whenever something is queued
+		EQStreamFactory *Factory;
+		bool WritePending;	//protected by the factory's ready queue lock
+		uint64 WriteReadyTime;
+
 	public:
 		//interface used by application (EQStreamInterface)
 		virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true);
@@ -553,6 +568,7 @@ class EQOldStream : public EQStreamInterface {
 		void SetLastPacketTime(uint32 t) {LastPacket=t;}
 		bool Stale(uint32 now, uint32 timeout=30) { return (LastPacket && (now-LastPacket) > timeout); }
 		void SetOpcodeManager(OpcodeManager **opm) { OpMgr = opm; }
+		void SetFactory(EQStreamFactory *f) { Factory = f; }
 		void _SendDisconnect();
 		void SetTimeOut(bool time) { bTimeout = time; }
 		bool GetTimeOut() { return bTimeout; }
@@ -5,29 +5,63 @@
 	#include <process.h>
 	#include <io.h>
 	#include <stdio.h>
+	int gettimeofday (timeval *tp, ...);
 #else
 	#include <sys/socket.h>
 	#include <netinet/in.h>
 	#include <sys/select.h>
+	#ifdef __linux__
+		#include <sys/epoll.h>
+		#define EQSTREAM_EPOLL
+	#endif
 	#include <arpa/inet.h>
 	#include <netdb.h>
 	#include <pthread.h>
+	#include <sys/time.h>
 #endif
 #include <fcntl.h>
+#include <errno.h>
+#include <string.h>
 #include <iostream>
+#include <algorithm>
 #include "op_codes.h"
 #include "EQStream.h"
 #include "logsys.h"
 
+//recvmmsg batch size for the epoll reader
+#define EQSTREAM_READ_BATCH 32
+
+//the writer wakes at least this often for rate decay, retransmits and old stream timers
+#define EQSTREAM_WRITER_SWEEP 20
+
+//number of latency samples kept, and how often (ms) their percentiles are logged
+#define EQSTREAM_LATENCY_SAMPLES 4096
+#define EQSTREAM_LATENCY_REPORT 60000
+
+static uint64 WriterTimeUS()
+{
+	struct timeval tv;
+	gettimeofday(&tv, nullptr);
+	return (uint64)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+struct EQStreamFactoryReader {
+	EQStreamFactory *fs;
+	int sock;
+};
+
 ThreadReturnType EQStreamFactoryReaderLoop(void *eqfs)
 {
-EQStreamFactory *fs=(EQStreamFactory *)eqfs;
+EQStreamFactoryReader *reader=(EQStreamFactoryReader *)eqfs;
+EQStreamFactory *fs=reader->fs;
+int sock=reader->sock;
+	delete reader;
 
 #ifndef WIN32
 	_log(COMMON__THREADS, "Starting EQStreamFactoryReaderLoop with thread ID %d", pthread_self());
 #endif
 
-	fs->ReaderLoop();
+	fs->ReaderLoop(sock);
 
 #ifndef WIN32
 	_log(COMMON__THREADS, "Ending EQStreamFactoryReaderLoop with thread ID %d", pthread_self());
@@ -62,17 +96,25 @@ EQStreamFactory::EQStreamFactory(EQStreamType type, int port, uint32 timeout)
 	StreamType=type;
 	Port=port;
 	sock=-1;
+	ReaderThreads=1;
+	ReaderRunning=false;
+	WriterRunning=false;
+	WriteLatencyNext=0;
 }
 
 void EQStreamFactory::Close()
 {
 	Stop();
 
+	std::vector<int>::iterator cur=ReaderSocks.begin();
+	for(; cur != ReaderSocks.end(); cur++) {
 #ifdef _WINDOWS
-	closesocket(sock);
+		closesocket(*cur);
 #else
-	close(sock);
+		close(*cur);
 #endif
+	}
+	ReaderSocks.clear();
 	sock=-1;
 }
 
@@ -89,31 +131,75 @@ struct sockaddr_in address;
 	address.sin_port = htons(Port);
 	address.sin_addr.s_addr = htonl(INADDR_ANY);
 
+	int socket_count = ReaderThreads;
+#ifndef SO_REUSEPORT
+	if (socket_count > 1) {
+		_log(NET__ERROR, "SO_REUSEPORT is not available, using a single reader for port %d", Port);
+		socket_count = 1;
+	}
+#endif
+
 	/* Setting up UDP port for new clients */
-	sock = socket(AF_INET, SOCK_DGRAM, 0);
-	if (sock < 0) {
-		return false;
+	for (int i = 0; i < socket_count; i++) {
+		int new_sock = socket(AF_INET, SOCK_DGRAM, 0);
+		if (new_sock < 0) {
+			break;
+		}
+
+#ifdef SO_REUSEPORT
+		//the kernel hashes each client onto one of the sockets, so a stream always arrives on the same reader
+		if (socket_count > 1) {
+			int reuse = 1;
+			if (setsockopt(new_sock, SOL_SOCKET, SO_REUSEPORT, (char *) &reuse, sizeof(reuse)) < 0) {
+				_log(NET__ERROR, "Unable to set SO_REUSEPORT on port %d, using %d reader(s)", Port, i > 0 ? i : 1);
+				if (i > 0) {
+					close(new_sock);
+					break;
+				}
+				socket_count = 1;
+			}
+		}
+#endif
+
+		if (bind(new_sock, (struct sockaddr *) &address, sizeof(address)) < 0) {
+			close(new_sock);
+			break;
+		}
+		#ifdef _WINDOWS
+			unsigned long nonblock = 1;
+			ioctlsocket(new_sock, FIONBIO, &nonblock);
+		#else
+			fcntl(new_sock, F_SETFL, O_NONBLOCK);
+		#endif
+		ReaderSocks.push_back(new_sock);
 	}
 
-	if (bind(sock, (struct sockaddr *) &address, sizeof(address)) < 0) {
-		close(sock);
+	if (ReaderSocks.empty()) {
 		sock=-1;
 		return false;
 	}
-	#ifdef _WINDOWS
-		unsigned long nonblock = 1;
-		ioctlsocket(sock, FIONBIO, &nonblock);
-	#else
-		fcntl(sock, F_SETFL, O_NONBLOCK);
-	#endif
+
+	//everything is written out through the first socket, it has the same local port as the others
+	sock = ReaderSocks[0];
+	ReaderRunning=true;
+
 	//moved these because on windows the output was delayed and causing the console window to look bad
 	//std::cout << "Starting factory Reader" << std::endl;
 	//std::cout << "Starting factory Writer" << std::endl;
+	std::vector<int>::iterator cur=ReaderSocks.begin();
+	for(; cur != ReaderSocks.end(); cur++) {
+		EQStreamFactoryReader *reader = new EQStreamFactoryReader;
+		reader->fs = this;
+		reader->sock = *cur;
+	#ifdef _WINDOWS
+		_beginthread(EQStreamFactoryReaderLoop,0, reader);
+	#else
+		pthread_create(&t1,nullptr,EQStreamFactoryReaderLoop,reader);
+	#endif
+	}
 	#ifdef _WINDOWS
-		_beginthread(EQStreamFactoryReaderLoop,0, this);
 		_beginthread(EQStreamFactoryWriterLoop,0, this);
 	#else
-		pthread_create(&t1,nullptr,EQStreamFactoryReaderLoop,this);
 		pthread_create(&t2,nullptr,EQStreamFactoryWriterLoop,this);
 	#endif
 	return true;
@@ -171,11 +257,78 @@ EQOldStream *s=nullptr;
 	return s;
 }
 
-void EQStreamFactory::ReaderLoop()
+void EQStreamFactory::ReaderLoop(int reader_sock)
 {
+#ifdef EQSTREAM_EPOLL
+	int epoll_fd = epoll_create(1);
+	if (epoll_fd < 0) {
+		_log(NET__ERROR, "Unable to create epoll instance for port %d: %s", Port, strerror(errno));
+		return;
+	}
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = reader_sock;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, reader_sock, &ev) < 0) {
+		_log(NET__ERROR, "Unable to add socket to epoll for port %d: %s", Port, strerror(errno));
+		close(epoll_fd);
+		return;
+	}
+
+	std::vector<unsigned char> buffers(EQSTREAM_READ_BATCH * 2048);
+	struct mmsghdr msgs[EQSTREAM_READ_BATCH];
+	struct iovec iovecs[EQSTREAM_READ_BATCH];
+	sockaddr_in froms[EQSTREAM_READ_BATCH];
+	struct epoll_event events[1];
+
+	while(sock!=-1) {
+		MReaderRunning.lock();
+		if (!ReaderRunning) {
+			MReaderRunning.unlock();
+			break;
+		}
+		MReaderRunning.unlock();
+
+		//short timeout so a Close() from another thread is noticed
+		int num = epoll_wait(epoll_fd, events, 1, 1000);
+		if (num <= 0)
+			continue;
+
+		if(sock == -1)
+			break;		//somebody closed us while we were sleeping.
+
+		//drain the socket in batches before going back to epoll
+		while (true) {
+			for (int i = 0; i < EQSTREAM_READ_BATCH; i++) {
+				iovecs[i].iov_base = &buffers[i * 2048];
+				iovecs[i].iov_len = 2048;
+				memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+				msgs[i].msg_hdr.msg_iov = &iovecs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+				msgs[i].msg_hdr.msg_name = &froms[i];
+				msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+				msgs[i].msg_len = 0;
+			}
+
+			int received = recvmmsg(reader_sock, msgs, EQSTREAM_READ_BATCH, MSG_DONTWAIT, nullptr);
+			if (received <= 0)
+				break;
+
+			for (int i = 0; i < received; i++) {
+				if (msgs[i].msg_len < 2)
+					continue;
+				ProcessDatagram(reader_sock, &buffers[i * 2048], msgs[i].msg_len, froms[i]);
+			}
+
+			if (received < EQSTREAM_READ_BATCH)
+				break;
+		}
+	}
+
+	close(epoll_fd);
+#else
 fd_set readset;
-std::map<std::string,EQStream *>::iterator stream_itr;
-std::map<std::string,EQOldStream *>::iterator oldstream_itr;
 int num;
 int length;
 unsigned char buffer[2048];
@@ -184,19 +337,20 @@ int socklen=sizeof(sockaddr_in);
 timeval sleep_time;
 //time_t now;
 
-	ReaderRunning=true;
 	while(sock!=-1) {
 		MReaderRunning.lock();
-		if (!ReaderRunning)
+		if (!ReaderRunning) {
+			MReaderRunning.unlock();
 			break;
+		}
 		MReaderRunning.unlock();
 
 		FD_ZERO(&readset);
-		FD_SET(sock,&readset);
+		FD_SET(reader_sock,&readset);
 
 		sleep_time.tv_sec=30;
 		sleep_time.tv_usec=0;
-		if ((num=select(sock+1,&readset,nullptr,nullptr,&sleep_time))<0) {
+		if ((num=select(reader_sock+1,&readset,nullptr,nullptr,&sleep_time))<0) {
 			// What do we wanna do?
 			continue;
 		} else if (num==0)
@@ -205,95 +359,112 @@ timeval sleep_time;
 		if(sock == -1)
 			break;		//somebody closed us while we were sleeping.
 
-		if (FD_ISSET(sock,&readset)) {
+		if (FD_ISSET(reader_sock,&readset)) {
 #ifdef _WINDOWS
-			if ((length=recvfrom(sock,(char*)buffer,sizeof(buffer),0,(struct sockaddr*)&from,(int *)&socklen)) < 2)
+			if ((length=recvfrom(reader_sock,(char*)buffer,sizeof(buffer),0,(struct sockaddr*)&from,(int *)&socklen)) < 2)
 #else
-			if ((length=recvfrom(sock,buffer,2048,0,(struct sockaddr *)&from,(socklen_t *)&socklen)) < 2)
+			if ((length=recvfrom(reader_sock,buffer,2048,0,(struct sockaddr *)&from,(socklen_t *)&socklen)) < 2)
 #endif
 			{
 				// What do we wanna do?
 			} else {
-				char temp[25];
-				sprintf(temp,"%u.%d",ntohl(from.sin_addr.s_addr),ntohs(from.sin_port));
-				MStreams.lock();
-				if ((stream_itr=Streams.find(temp))==Streams.end() && (oldstream_itr=OldStreams.find(temp))==OldStreams.end()) {
-					if (buffer[1]==OP_SessionRequest) {
-						EQStream *s = new EQStream(from);
-						s->SetStreamType(StreamType);
-						Streams[temp]=s;
-						WriterWork.Signal();
-						Push(s);
-						s->AddBytesRecv(length);
-						s->Process(buffer,length);
-						s->SetLastPacketTime(Timer::GetCurrentTime());
-					}
-					else {
-						EQOldStream *s = new EQOldStream(from, sock);
-						s->SetStreamType(OldStream);
-						OldStreams[temp]=s;
-						WriterWork.Signal();
-						PushOld(s);
-						//s->AddBytesRecv(length);
-						s->SetLastPacketTime(Timer::GetCurrentTime());
-						s->ReceiveData(buffer,length);
-					}
-
-					MStreams.unlock();
-				} else {
-
-					//newstr
-					stream_itr=Streams.find(temp);
-					EQStream *curstream = nullptr;
-					if(stream_itr != Streams.end())
-					curstream = stream_itr->second;
-					//oldstr
-					oldstream_itr=OldStreams.find(temp);
-					EQOldStream *oldcurstream = nullptr;
-					if(oldstream_itr != OldStreams.end())
-					oldcurstream = oldstream_itr->second;
-
-					if(curstream != nullptr)
-					{
-						//dont bother processing incoming packets for closed connections
-						if(curstream->CheckClosed())
-							curstream = nullptr;
-						else
-							curstream->PutInUse();
-						MStreams.unlock();	//the in use flag prevents the stream from being deleted while we are using it.
-
-						if(curstream) {
-							curstream->AddBytesRecv(length);
-							curstream->Process(buffer,length);
-							curstream->SetLastPacketTime(Timer::GetCurrentTime());
-							curstream->ReleaseFromUse();
-						}
-					}
-					else if(oldcurstream != nullptr)
-					{
-						if(oldcurstream->CheckClosed())
-							oldcurstream = nullptr;
-						else
-							oldcurstream->PutInUse();
-
-						MStreams.unlock();	//the in use flag prevents the stream from being deleted while we are using it.
-
-						if(oldcurstream) {
-							//oldcurstream->AddBytesRecv(length);
-							oldcurstream->ParceEQPacket(length, buffer);
-							oldcurstream->SetLastPacketTime(Timer::GetCurrentTime());
-							oldcurstream->CheckTimers();
-							oldcurstream->ReleaseFromUse();
-						}
-					}
-					else
-					{
-						MStreams.unlock();
-					}
-				}
+				ProcessDatagram(reader_sock, buffer, length, from);
 			}
 		}
 	}
+#endif
+}
+
+void EQStreamFactory::ProcessDatagram(int from_sock, unsigned char *buffer, int length, sockaddr_in &from)
+{
+std::unordered_map<EQStreamKey,EQStream *>::iterator stream_itr;
+std::unordered_map<EQStreamKey,EQOldStream *>::iterator oldstream_itr;
+EQStreamKey key=MakeStreamKey(from.sin_addr.s_addr,from.sin_port);
+
+	MStreams.lock();
+	if ((stream_itr=Streams.find(key))==Streams.end() && (oldstream_itr=OldStreams.find(key))==OldStreams.end()) {
+		if (buffer[1]==OP_SessionRequest) {
+			EQStream *s = new EQStream(from);
+			s->SetStreamType(StreamType);
+			s->SetFactory(this);
+			Streams[key]=s;
+			WriterWork.Signal();
+			Push(s);
+			s->AddBytesRecv(length);
+			s->Process(buffer,length);
+			s->SetLastPacketTime(Timer::GetCurrentTime());
+			if(s->HasOutgoingData())
+				StreamReady(s);
+		}
+		else {
+			EQOldStream *s = new EQOldStream(from, from_sock);
+			s->SetStreamType(OldStream);
+			s->SetFactory(this);
+			OldStreams[key]=s;
+			WriterWork.Signal();
+			PushOld(s);
+			//s->AddBytesRecv(length);
+			s->SetLastPacketTime(Timer::GetCurrentTime());
+			s->ReceiveData(buffer,length);
+			if(s->HasOutgoingData())
+				StreamReady(s);
+		}
+
+		MStreams.unlock();
+	} else {
+
+		//newstr
+		EQStream *curstream = nullptr;
+		if(stream_itr != Streams.end())
+			curstream = stream_itr->second;
+		//oldstr
+		EQOldStream *oldcurstream = nullptr;
+		if(curstream == nullptr && oldstream_itr != OldStreams.end())
+			oldcurstream = oldstream_itr->second;
+
+		if(curstream != nullptr)
+		{
+			//dont bother processing incoming packets for closed connections
+			if(curstream->CheckClosed())
+				curstream = nullptr;
+			else
+				curstream->PutInUse();
+			MStreams.unlock();	//the in use flag prevents the stream from being deleted while we are using it.
+
+			if(curstream) {
+				curstream->AddBytesRecv(length);
+				curstream->Process(buffer,length);
+				curstream->SetLastPacketTime(Timer::GetCurrentTime());
+				//acks and protocol replies go out without waiting for the sweep
+				if(curstream->HasOutgoingData())
+					StreamReady(curstream);
+				curstream->ReleaseFromUse();
+			}
+		}
+		else if(oldcurstream != nullptr)
+		{
+			if(oldcurstream->CheckClosed())
+				oldcurstream = nullptr;
+			else
+				oldcurstream->PutInUse();
+
+			MStreams.unlock();	//the in use flag prevents the stream from being deleted while we are using it.
+
+			if(oldcurstream) {
+				//oldcurstream->AddBytesRecv(length);
+				oldcurstream->ParceEQPacket(length, buffer);
+				oldcurstream->SetLastPacketTime(Timer::GetCurrentTime());
+				oldcurstream->CheckTimers();
+				if(oldcurstream->HasOutgoingData())
+					StreamReady(oldcurstream);
+				oldcurstream->ReleaseFromUse();
+			}
+		}
+		else
+		{
+			MStreams.unlock();
+		}
+	}
 }
 
 void EQStreamFactory::CheckTimeout()
@@ -302,7 +473,7 @@ void EQStreamFactory::CheckTimeout()
 	MStreams.lock();
 
 	unsigned long now=Timer::GetCurrentTime();
-	std::map<std::string,EQStream *>::iterator stream_itr;
+	std::unordered_map<EQStreamKey,EQStream *>::iterator stream_itr;
 
 	for(stream_itr=Streams.begin();stream_itr!=Streams.end();) {
 		EQStream *s = stream_itr->second;
@@ -318,7 +489,7 @@ void EQStreamFactory::CheckTimeout()
 			} else {
 				//everybody is done, we can delete it now
 				//std::cout << "Removing connection" << std::endl;
-				std::map<std::string,EQStream *>::iterator temp=stream_itr;
+				std::unordered_map<EQStreamKey,EQStream *>::iterator temp=stream_itr;
 				stream_itr++;
 				//let whoever has the stream outside delete it
 				delete temp->second;
@@ -330,7 +501,7 @@ void EQStreamFactory::CheckTimeout()
 		stream_itr++;
 	}
 	now=Timer::GetCurrentTime();
-	std::map<std::string,EQOldStream *>::iterator oldstream_itr;
+	std::unordered_map<EQStreamKey,EQOldStream *>::iterator oldstream_itr;
 	for(oldstream_itr=OldStreams.begin();oldstream_itr!=OldStreams.end();) {
 		EQOldStream *s = oldstream_itr->second;
 
@@ -344,7 +515,7 @@ void EQStreamFactory::CheckTimeout()
 			} else {
 				//everybody is done, we can delete it now
 				//cout << "Removing connection" << endl;
-				std::map<std::string,EQOldStream *>::iterator temp=oldstream_itr;
+				std::unordered_map<EQStreamKey,EQOldStream *>::iterator temp=oldstream_itr;
 				oldstream_itr++;
 				//let whoever has the stream outside delete it
 				delete temp->second;
@@ -358,94 +529,181 @@ void EQStreamFactory::CheckTimeout()
 	MStreams.unlock();
 }
 
+void EQStreamFactory::StreamReady(EQStream *s)
+{
+	MReadyStreams.lock();
+	if (!s->WritePending) {
+		//held in use until the writer is done with it, so it cant be deleted while queued
+		s->PutInUse();
+		s->WritePending = true;
+		s->WriteReadyTime = WriterTimeUS();
+		ReadyStreams.push_back(s);
+	}
+	MReadyStreams.unlock();
+	WriterWork.Signal();
+}
+
+void EQStreamFactory::StreamReady(EQOldStream *s)
+{
+	MReadyStreams.lock();
+	if (!s->WritePending) {
+		s->PutInUse();
+		s->WritePending = true;
+		s->WriteReadyTime = WriterTimeUS();
+		ReadyOldStreams.push_back(s);
+	}
+	MReadyStreams.unlock();
+	WriterWork.Signal();
+}
+
+void EQStreamFactory::RecordWriteLatency(uint64 ready_time, uint64 now)
+{
+	uint32 sample = now > ready_time ? (uint32)(now - ready_time) : 0;
+
+	if (WriteLatency.size() < EQSTREAM_LATENCY_SAMPLES) {
+		WriteLatency.push_back(sample);
+	} else {
+		WriteLatency[WriteLatencyNext] = sample;
+		WriteLatencyNext = (WriteLatencyNext + 1) % EQSTREAM_LATENCY_SAMPLES;
+	}
+}
+
+void EQStreamFactory::ReportWriteLatency()
+{
+	if (WriteLatency.empty())
+		return;
+
+	std::vector<uint32> sorted(WriteLatency);
+	std::sort(sorted.begin(), sorted.end());
+
+	_log(NET__WRITE_LATENCY, "Port %d enqueue to send latency over the last %u writes: p50 %u us, p99 %u us, max %u us",
+		Port, (uint32)sorted.size(), sorted[sorted.size() / 2], sorted[(sorted.size() * 99) / 100], sorted.back());
+}
+
 void EQStreamFactory::WriterLoop()
 {
-std::map<std::string,EQStream *>::iterator stream_itr;
-std::map<std::string,EQOldStream *>::iterator oldstream_itr;
-bool havework=true;
+std::unordered_map<EQStreamKey,EQStream *>::iterator stream_itr;
+std::unordered_map<EQStreamKey,EQOldStream *>::iterator oldstream_itr;
 std::vector<EQStream *> wants_write;
 std::vector<EQStream *>::iterator cur,end;
 std::vector<EQOldStream *> old_wants_write;
 std::vector<EQOldStream *>::iterator oldcur,oldend;
-bool decay=false;
+std::vector<EQStream *> ready;
+std::vector<EQOldStream *> old_ready;
+std::vector<uint64> ready_times;
+std::vector<uint64> old_ready_times;
 uint32 stream_count;
+bool idle;
 
-Timer DecayTimer(20);
+Timer DecayTimer(EQSTREAM_WRITER_SWEEP);
+Timer LatencyTimer(EQSTREAM_LATENCY_REPORT);
 
 	WriterRunning=true;
 	DecayTimer.Enable();
+	LatencyTimer.Enable();
 	while(sock!=-1) {
-		//if (!havework) {
-			//WriterWork.Wait();
-		//}
 		MWriterRunning.lock();
-		if (!WriterRunning)
+		if (!WriterRunning) {
+			MWriterRunning.unlock();
 			break;
+		}
 		MWriterRunning.unlock();
 
-		havework = false;
-		wants_write.clear();
-		old_wants_write.clear();
+		//streams that queued something since the last pass go out right away
+		ready.clear();
+		old_ready.clear();
+		ready_times.clear();
+		old_ready_times.clear();
+		MReadyStreams.lock();
+		ready.swap(ReadyStreams);
+		old_ready.swap(ReadyOldStreams);
+		for(cur = ready.begin(); cur != ready.end(); cur++) {
+			(*cur)->WritePending = false;
+			ready_times.push_back((*cur)->WriteReadyTime);
+		}
+		for(oldcur = old_ready.begin(); oldcur != old_ready.end(); oldcur++) {
+			(*oldcur)->WritePending = false;
+			old_ready_times.push_back((*oldcur)->WriteReadyTime);
+		}
+		MReadyStreams.unlock();
 
-		decay=DecayTimer.Check();
+		for(size_t i = 0; i < ready.size(); i++) {
+			RecordWriteLatency(ready_times[i], WriterTimeUS());
+			ready[i]->Write(sock);
+			ready[i]->ReleaseFromUse();
+		}
 
-		//copy streams into a seperate list so we dont have to keep
-		//MStreams locked while we are writting
-		MStreams.lock();
-		for(stream_itr=Streams.begin();stream_itr!=Streams.end();stream_itr++) {
-			// If it's time to decay the bytes sent, then let's do it before we try to write
-			if (decay)
+		for(size_t i = 0; i < old_ready.size(); i++) {
+			RecordWriteLatency(old_ready_times[i], WriterTimeUS());
+			old_ready[i]->SetWriting(true);
+			old_ready[i]->CheckTimers();
+			old_ready[i]->SendPacketQueue();
+			old_ready[i]->SetWriting(false);
+			old_ready[i]->ReleaseFromUse();
+		}
+
+		//everything that is waiting on time rather than on new data (rate limited writes,
+		//retransmits, old stream ack timers) is picked up by the periodic sweep.
+		if (DecayTimer.Check()) {
+			wants_write.clear();
+			old_wants_write.clear();
+
+			//copy streams into a seperate list so we dont have to keep
+			//MStreams locked while we are writting
+			MStreams.lock();
+			for(stream_itr=Streams.begin();stream_itr!=Streams.end();stream_itr++) {
+				//bullshit checking, to see if this is really happening, GDB seems to think so...
+				if(stream_itr->second == nullptr) {
+					fprintf(stderr, "ERROR: nullptr Stream encountered in EQStreamFactory::WriterLoop for: %llu", (unsigned long long)stream_itr->first);
+					continue;
+				}
+
+				// It's time to decay the bytes sent, so let's do it before we try to write
 				stream_itr->second->Decay();
 
-			//bullshit checking, to see if this is really happening, GDB seems to think so...
-			if(stream_itr->second == nullptr) {
-				fprintf(stderr, "ERROR: nullptr Stream encountered in EQStreamFactory::WriterLoop for: %s", stream_itr->first.c_str());
-				continue;
+				if (stream_itr->second->HasOutgoingData()) {
+					stream_itr->second->PutInUse();
+					wants_write.push_back(stream_itr->second);
+				}
 			}
+			for(oldstream_itr=OldStreams.begin();oldstream_itr!=OldStreams.end();oldstream_itr++) {
 
-			if (stream_itr->second->HasOutgoingData()) {
-				havework=true;
-				stream_itr->second->PutInUse();
-				wants_write.push_back(stream_itr->second);
-			}
-		}
-		for(oldstream_itr=OldStreams.begin();oldstream_itr!=OldStreams.end();oldstream_itr++) {
+				//bullshit checking, to see if this is really happening, GDB seems to think so...
+				if(oldstream_itr->second == nullptr) {
+					fprintf(stderr, "ERROR: nullptr Stream encountered in EQStreamFactory::WriterLoop for: %llu", (unsigned long long)oldstream_itr->first);
+					continue;
+				}
 
-			//bullshit checking, to see if this is really happening, GDB seems to think so...
-			if(oldstream_itr->second == nullptr) {
-				fprintf(stderr, "ERROR: nullptr Stream encountered in EQStreamFactory::WriterLoop for: %s", oldstream_itr->first.c_str());
-				continue;
+				if (oldstream_itr->second->HasOutgoingData()) {
+					oldstream_itr->second->SetWriting(true);
+					oldstream_itr->second->PutInUse();
+					old_wants_write.push_back(oldstream_itr->second);
+				}
 			}
 
-			if (oldstream_itr->second->HasOutgoingData()) {
-				havework=true; 
-				oldstream_itr->second->SetWriting(true);
-				oldstream_itr->second->PutInUse();
-				old_wants_write.push_back(oldstream_itr->second);
-			}			
-			
-		}
+			MStreams.unlock();
+			//do the actual writes
+			cur = wants_write.begin();
+			end = wants_write.end();
 
-		MStreams.unlock();
-		//do the actual writes
-		cur = wants_write.begin();
-		end = wants_write.end();
+				for(; cur != end; cur++) {
+					(*cur)->Write(sock);
+					(*cur)->ReleaseFromUse();
+				}
 
-			for(; cur != end; cur++) {
-				(*cur)->Write(sock);
-				(*cur)->ReleaseFromUse();
-			}
+			//do the actual writes
+			oldcur = old_wants_write.begin();
+			oldend = old_wants_write.end();
+				for(; oldcur != oldend; oldcur++) {
+					(*oldcur)->CheckTimers();
+					(*oldcur)->SendPacketQueue();
+					(*oldcur)->ReleaseFromUse();
+					(*oldcur)->SetWriting(false);
+				}
+		}
 
-		//do the actual writes
-		oldcur = old_wants_write.begin();
-		oldend = old_wants_write.end();
-			for(; oldcur != oldend; oldcur++) {
-				(*oldcur)->CheckTimers();
-				(*oldcur)->SendPacketQueue();
-				(*oldcur)->ReleaseFromUse();
-				(*oldcur)->SetWriting(false);
-			}
-		Sleep(10);
+		if (LatencyTimer.Check())
+			ReportWriteLatency();
 
 		MStreams.lock();
 		stream_count=Streams.size() + OldStreams.size();
@@ -454,6 +712,20 @@ Timer DecayTimer(20);
 			//std::cout << "No streams, waiting on condition" << std::endl;
 			WriterWork.Wait();
 			//std::cout << "Awake from condition, must have a stream now" << std::endl;
+			continue;
+		}
+
+		MReadyStreams.lock();
+		idle = ReadyStreams.empty() && ReadyOldStreams.empty();
+		MReadyStreams.unlock();
+
+		//sleep until a stream queues something or the next sweep is due. A signal that lands
+		//between the check above and the wait is only late by one sweep at worst.
+		if (idle) {
+			uint32 remaining = DecayTimer.GetRemainingTime();
+			if (remaining == 0 || remaining > EQSTREAM_WRITER_SWEEP)
+				remaining = 1;
+			WriterWork.TimedWait(remaining * 1000);
 		}
 	}
 }
@@ -4,17 +4,26 @@
 
 #include <queue>
 #include <map>
+#include <vector>
+#include <unordered_map>
 #include "../common/EQStream.h"
 #include "../common/Condition.h"
 #include "../common/timeoutmgr.h"
 #include "../common/opcodemgr.h"
 #include "../common/timer.h"
 
+//streams are looked up by remote ip and port, both kept in network order
+typedef uint64 EQStreamKey;
+
 class EQStreamFactory : private Timeoutable {
 	private:
 		int sock;
 		int Port;
 
+		//extra SO_REUSEPORT sockets, each with its own reader. sock is always the first.
+		std::vector<int> ReaderSocks;
+		int ReaderThreads;
+
 		bool ReaderRunning;
 		Mutex MReaderRunning;
 		bool WriterRunning;
@@ -27,23 +36,36 @@ class EQStreamFactory : private Timeoutable {
 		std::queue<EQStream *> NewStreams;
 		Mutex MNewStreams;
 
-		std::map<std::string,EQStream *> Streams;
+		std::unordered_map<EQStreamKey,EQStream *> Streams;
 		Mutex MStreams;
 
 		Mutex MWritingStreams;
 
+		//streams that queued something since the writer last ran, see StreamReady()
+		std::vector<EQStream *> ReadyStreams;
+		std::vector<EQOldStream *> ReadyOldStreams;
+		Mutex MReadyStreams;
+
+		//enqueue to write latency samples in usec, only touched by the writer thread
+		std::vector<uint32> WriteLatency;
+		uint32 WriteLatencyNext;
+		void RecordWriteLatency(uint64 ready_time, uint64 now);
+		void ReportWriteLatency();
+
 		std::queue<EQOldStream *> NewOldStreams;
 
-		std::map<std::string,EQOldStream *> OldStreams;
+		std::unordered_map<EQStreamKey,EQOldStream *> OldStreams;
 
 		virtual void CheckTimeout();
 
+		void ProcessDatagram(int from_sock, unsigned char *buffer, int length, sockaddr_in &from);
+
 		Timer *DecayTimer;
 
 		uint32 stream_timeout;
 
 	public:
-		EQStreamFactory(EQStreamType type, uint32 timeout = 135000) : Timeoutable(5000), stream_timeout(timeout) { ReaderRunning=false; WriterRunning=false; StreamType=type; sock=-1; }
+		EQStreamFactory(EQStreamType type, uint32 timeout = 135000) : Timeoutable(5000), stream_timeout(timeout) { ReaderRunning=false; WriterRunning=false; StreamType=type; sock=-1; ReaderThreads=1; WriteLatencyNext=0; }
 		EQStreamFactory(EQStreamType type, int port, uint32 timeout = 135000);
 
 		EQStream *Pop();
@@ -56,12 +78,21 @@ class EQStreamFactory : private Timeoutable {
 		bool Open(unsigned long port) { Port=port; return Open(); }
 		bool IsOpen() { return sock!=-1; }
 		void Close();
-		void ReaderLoop();
+		//number of sockets/reader threads to open on the port, more than one needs SO_REUSEPORT. set before Open()
+		void SetReaderThreads(int count) { ReaderThreads=count < 1 ? 1 : count; }
+		void ReaderLoop() { ReaderLoop(sock); }
+		void ReaderLoop(int reader_sock);
 		void WriterLoop();
 		void Stop() { StopReader(); StopWriter(); }
 		void StopReader() { MReaderRunning.lock(); ReaderRunning=false; MReaderRunning.unlock(); }
 		void StopWriter() { MWriterRunning.lock(); WriterRunning=false; MWriterRunning.unlock(); WriterWork.Signal(); }
 		void SignalWriter() { WriterWork.Signal(); }
+
+		//called by streams whenever they queue outgoing data, wakes the writer for them
+		void StreamReady(EQStream *s);
+		void StreamReady(EQOldStream *s);
+
+		static EQStreamKey MakeStreamKey(uint32 ip, uint16 port) { return (((EQStreamKey)ip) << 16) | port; }
 };
 
 #endif
@@ -5,6 +5,7 @@
 
 #include <string>
 #include "clientversions.h"
+#include "EQBroadcastPacket.h"
 
 typedef enum {
 	ESTABLISHED,
@@ -22,6 +23,9 @@ public:
 
 	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true) = 0;
 	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req=true) = 0;
+	//queue a packet which is being sent to many streams, streams which translate packets
+	//should only do so once per broadcast.
+	virtual void QueueBroadcastPacket(EQBroadcastPacket *bp, bool ack_req=true) { QueuePacket(bp->GetPacket(), ack_req); }
 	virtual EQApplicationPacket *PopPacket() = 0;
 	virtual void Close() = 0;
 
@@ -54,6 +54,20 @@ void EQStreamProxy::FastQueuePacket(EQApplicationPacket **p, bool ack_req) {
 	m_structs->Encode(p, m_stream, ack_req);
 }
 
+void EQStreamProxy::QueueBroadcastPacket(EQBroadcastPacket *bp, bool ack_req) {
+	if(bp == nullptr)
+		return;
+
+	//already run through our struct strategy, the stream only has to frame it.
+	const std::vector<EQBroadcastPacket::EncodedPacket> &encoded = bp->Encode(m_structs, ack_req);
+	std::vector<EQBroadcastPacket::EncodedPacket>::const_iterator cur, end;
+	cur = encoded.begin();
+	end = encoded.end();
+	for(; cur != end; ++cur) {
+		m_stream->QueuePacket(cur->packet, cur->ack_req);
+	}
+}
+
 EQApplicationPacket *EQStreamProxy::PopPacket() {
 	EQApplicationPacket *pack = m_stream->PopPacket();
 	if(pack == nullptr)
@@ -272,6 +272,14 @@ ProcLauncher::ProcRef ProcLauncher::Launch(Spec *&to_launch) {
 }
 
 
+bool ProcLauncher::SetHandler(const ProcRef &proc, EventHandler *handler) {
+	std::map<ProcRef, Spec *>::iterator res = m_running.find(proc);
+	if(res == m_running.end())
+		return(false);
+	res->second->handler = handler;
+	return(true);
+}
+
 //if graceful is true, we try to be nice about it if possible
 bool ProcLauncher::Terminate(const ProcRef &proc, bool graceful) {
 	//we are only willing to kill things we started...
@@ -68,6 +68,9 @@ public:
 	/* The main launch method, call to start a new background process. */
 	ProcRef Launch(Spec *&to_launch);	//takes ownership of the pointer
 
+	/* Changes who is told when proc terminates, false if it is not running */
+	bool SetHandler(const ProcRef &proc, EventHandler *handler);
+
 	/* The terminate method */
 	bool Terminate(const ProcRef &proc, bool graceful = true);
 	void TerminateAll(bool final = true);
@@ -15,6 +15,8 @@
 //#include "../common/MiscFunctions.h"
 #include "StringUtil.h"
 #define ASYNC_LOOP_GRANULARITY 4 //# of ms between checking our work
+#define ASYNC_LOOP_IDLE_WAIT 250000 //# of us an idle worker waits before checking for delayed work
+#define ASYNC_MAX_WORKERS 8
 
 bool DBAsyncCB_LoadVariables(DBAsyncWork* iWork) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
@@ -37,26 +39,28 @@ void AsyncLoadVariables(DBAsync *dba, Database *db) {
 
 //we only need to do anything when somebody puts work on the queue
 //so instead of checking all the time, we will wait on a condition
-//which will get signaled when somebody puts something on the queue
+//which will get signaled when somebody puts something on the queue.
+//the wait is timed so delayed work still goes out without new work arriving.
 ThreadReturnType DBAsyncLoop(void* tmp) {
-	DBAsync* dba = (DBAsync*) tmp;
+	DBAsync::Worker* worker = (DBAsync::Worker*) tmp;
+	DBAsync* dba = worker->dba;
 
 #ifndef WIN32
 	_log(COMMON__THREADS, "Starting DBAsyncLoop with thread ID %d", pthread_self());
 #endif
 
-	dba->MLoopRunning.lock();
+	worker->MLoopRunning.lock();
 	while (dba->RunLoop()) {
 		//wait before working so we check the loop condition
 		//as soon as were done working
-		dba->CInList.Wait();
+		dba->CInList.TimedWait(ASYNC_LOOP_IDLE_WAIT);
 		//we could check dba->RunLoop() again to see if we
 		//got turned off while we were waiting
 		{
-			dba->Process();
+			dba->Process(worker);
 		}
 	}
-	dba->MLoopRunning.unlock();
+	worker->MLoopRunning.unlock();
 
 #ifndef WIN32
 	_log(COMMON__THREADS, "Ending DBAsyncLoop with thread ID %d", pthread_self());
@@ -65,22 +69,62 @@ ThreadReturnType DBAsyncLoop(void* tmp) {
 	THREAD_RETURN(nullptr);
 }
 
-DBAsync::DBAsync(DBcore* iDBC)
+DBAsync::DBAsync(DBcore* iDBC, uint32 iWorkers)
 : Timeoutable(10000)
 {
 	pDBC = iDBC;
 	pRunLoop = true;
 	pNextID = 1;
+	pCoalescedWrites = 0;
+
+	if (iWorkers < 1)
+		iWorkers = 1;
+	if (iWorkers > ASYNC_MAX_WORKERS)
+		iWorkers = ASYNC_MAX_WORKERS;
+
+	for (uint32 i = 0; i < iWorkers; i++) {
+		Worker* worker = new Worker;
+		worker->dba = this;
+		worker->dbc = pDBC;
+		worker->OwnConnection = false;
+		worker->WritesFirst = (i == 0);
+		worker->CurrentWork = 0;
+		if (i > 0) {
+			uint32 errnum = 0;
+			char errbuf[MYSQL_ERRMSG_SIZE];
+			errbuf[0] = 0;
+			DBcore* dbc = DBcore::Clone(pDBC, &errnum, errbuf);
+			if (dbc) {
+				worker->dbc = dbc;
+				worker->OwnConnection = true;
+			}
+			else {
+				//still useful, it just has to share the main connection
+				LogFile->write(EQEMuLog::Error, "DBAsync: worker %d could not open its own connection, sharing the main one: #%d %s", i, errnum, errbuf);
+			}
+		}
+		Workers.push_back(worker);
+	}
+
+	for (uint32 i = 0; i < Workers.size(); i++) {
 #ifdef _WINDOWS
-	_beginthread(DBAsyncLoop, 0, this);
+		_beginthread(DBAsyncLoop, 0, Workers[i]);
 #else
-	pthread_t thread;
-	pthread_create(&thread, nullptr, DBAsyncLoop, this);
+		pthread_t thread;
+		pthread_create(&thread, nullptr, DBAsyncLoop, Workers[i]);
 #endif
+	}
 }
 
 DBAsync::~DBAsync() {
 	StopThread();
+
+	for (uint32 i = 0; i < Workers.size(); i++) {
+		if (Workers[i]->OwnConnection)
+			safe_delete(Workers[i]->dbc);
+		safe_delete(Workers[i]);
+	}
+	Workers.clear();
 }
 
 bool DBAsync::StopThread() {
@@ -91,11 +135,13 @@ bool DBAsync::StopThread() {
 	MRunLoop.unlock();
 
 	//signal the condition so we exit the loop if were waiting
-	CInList.Signal();
+	CInList.SignalAll();
 
-	//this effectively waits for the processing thread to finish
-	MLoopRunning.lock();
-	MLoopRunning.unlock();
+	//this effectively waits for the processing threads to finish
+	for (uint32 i = 0; i < Workers.size(); i++) {
+		Workers[i]->MLoopRunning.lock();
+		Workers[i]->MLoopRunning.unlock();
+	}
 
 	return ret;
 }
@@ -107,7 +153,33 @@ uint32 DBAsync::AddWork(DBAsyncWork** iWork, uint32 iDelay) {
 		MInList.unlock();
 		return 0;
 	}
-	InList.Append(*iWork);
+	if ((*iWork)->Type() == Read) {
+		ReadList.Append(*iWork);
+	}
+	else {
+		uint64 key = (*iWork)->GetCoalesceKey();
+		if (key) {
+			//an older write for the same rows that hasnt started yet is superseded by this one
+			std::map<uint64, DBAsyncWork*>::iterator old = QueuedWrites.find(key);
+			if (old != QueuedWrites.end()) {
+				LinkedListIterator<DBAsyncWork*> iterator(WriteList);
+				iterator.Reset();
+				while (iterator.MoreElements()) {
+					if (iterator.GetData() == old->second) {
+#if DEBUG_MYSQL_QUERIES >= 2
+						std::cout << "Coalescing AsyncWork #" << old->second->GetWorkID() << " into #" << ret << std::endl;
+#endif
+						iterator.RemoveCurrent(true);
+						pCoalescedWrites++;
+						break;
+					}
+					iterator.Advance();
+				}
+			}
+			QueuedWrites[key] = *iWork;
+		}
+		WriteList.Append(*iWork);
+	}
 	(*iWork)->SetStatus(Queued);
 	if (iDelay)
 		(*iWork)->pExecuteAfter = Timer::GetCurrentTime() + iDelay;
@@ -118,7 +190,7 @@ uint32 DBAsync::AddWork(DBAsyncWork** iWork, uint32 iDelay) {
 	*iWork = 0;
 	MInList.unlock();
 
-	//wake up the processing thread and tell it to get to work.
+	//wake up a processing thread and tell it to get to work.
 	CInList.Signal();
 
 	return ret;
@@ -131,23 +203,33 @@ bool DBAsync::CancelWork(uint32 iWorkID) {
 	std::cout << "DBAsync::CancelWork: " << iWorkID << std::endl;
 #endif
 	MCurrentWork.lock();
-	if (CurrentWork && CurrentWork->GetWorkID() == iWorkID) {
-		CurrentWork->Cancel();
-		MCurrentWork.unlock();
-		return true;
+	for (uint32 i = 0; i < Workers.size(); i++) {
+		DBAsyncWork* work = Workers[i]->CurrentWork;
+		if (work && work->GetWorkID() == iWorkID) {
+			work->Cancel();
+			MCurrentWork.unlock();
+			return true;
+		}
 	}
 	MCurrentWork.unlock();
 	MInList.lock();
-	LinkedListIterator<DBAsyncWork*> iterator(InList);
+	LinkedList<DBAsyncWork*>* lists[2] = { &WriteList, &ReadList };
+	for (int i = 0; i < 2; i++) {
+		LinkedListIterator<DBAsyncWork*> iterator(*lists[i]);
 
-	iterator.Reset();
-	while (iterator.MoreElements()) {
-		if (iterator.GetData()->GetWorkID() == iWorkID) {
-			iterator.RemoveCurrent(true);
-			MInList.unlock();
-			return true;
+		iterator.Reset();
+		while (iterator.MoreElements()) {
+			DBAsyncWork* work = iterator.GetData();
+			if (work->GetWorkID() == iWorkID) {
+				std::map<uint64, DBAsyncWork*>::iterator queued = QueuedWrites.find(work->GetCoalesceKey());
+				if (queued != QueuedWrites.end() && queued->second == work)
+					QueuedWrites.erase(queued);
+				iterator.RemoveCurrent(true);
+				MInList.unlock();
+				return true;
+			}
+			iterator.Advance();
 		}
-		iterator.Advance();
 	}
 	MInList.unlock();
 	return false;
@@ -161,15 +243,51 @@ bool DBAsync::RunLoop() {
 	return ret;
 }
 
-DBAsyncWork* DBAsync::InListPop() {
+DBAsyncWork* DBAsync::InListPop(bool iWritesFirst) {
 	DBAsyncWork* ret = 0;
 	MInList.lock();
-	LinkedListIterator<DBAsyncWork*> iterator(InList);
+	if (iWritesFirst) {
+		ret = ListPop(WriteList, true);
+		if (!ret)
+			ret = ListPop(ReadList, false);
+	}
+	else {
+		ret = ListPop(ReadList, false);
+		if (!ret)
+			ret = ListPop(WriteList, true);
+	}
+	MInList.unlock();
+	return ret;
+}
+
+//MInList must be locked
+DBAsyncWork* DBAsync::ListPop(LinkedList<DBAsyncWork*>& iList, bool iWrites) {
+	DBAsyncWork* ret = 0;
+	LinkedListIterator<DBAsyncWork*> iterator(iList);
 
 	iterator.Reset();
 	while (iterator.MoreElements()) {
-		if (iterator.GetData()->pExecuteAfter <= Timer::GetCurrentTime()) {
-			ret = iterator.GetData();
+		DBAsyncWork* work = iterator.GetData();
+		if (work->pExecuteAfter <= Timer::GetCurrentTime()) {
+			uint64 key = work->GetCoalesceKey();
+			if (iWrites) {
+				//writes to the same rows go out one at a time, in order.
+				//unkeyed writes all share key 0 so they keep the old one at a time behavior.
+				if (ExecutingWrites.count(key)) {
+					iterator.Advance();
+					continue;
+				}
+				ExecutingWrites.insert(key);
+				if (key)
+					QueuedWrites.erase(key);
+			}
+			else if (key && WriteDue(key)) {
+				//dont read rows back while a write for them is running or due,
+				//a delayed write that isnt due yet doesnt hold the read up
+				iterator.Advance();
+				continue;
+			}
+			ret = work;
 #if DEBUG_MYSQL_QUERIES >= 2
 			std::cout << "Poping AsyncWork #" << ret->GetWorkID() << std::endl;
 			std::cout << ret->pExecuteAfter << " <= " << Timer::GetCurrentTime() << std::endl;
@@ -179,21 +297,34 @@ DBAsyncWork* DBAsync::InListPop() {
 		}
 		iterator.Advance();
 	}
-	MInList.unlock();
 	return ret;
 }
 
-DBAsyncWork* DBAsync::InListPopWrite() {
+//MInList must be locked
+bool DBAsync::WriteDue(uint64 iKey) {
+	if (ExecutingWrites.count(iKey))
+		return true;
+	std::map<uint64, DBAsyncWork*>::iterator queued = QueuedWrites.find(iKey);
+	return (queued != QueuedWrites.end() && queued->second->pExecuteAfter <= Timer::GetCurrentTime());
+}
+
+DBAsyncWork* DBAsync::InListPopWrite(uint32 iKeyKind) {
 	MInList.lock();
-	LinkedListIterator<DBAsyncWork*> iterator(InList);
+	LinkedListIterator<DBAsyncWork*> iterator(WriteList);
 
 	DBAsyncWork* ret = 0;
-	DBAsync::Type tmpType;
 	iterator.Reset();
 	while (iterator.MoreElements()) {
-		tmpType = iterator.GetData()->Type();
-		if (tmpType == Write || tmpType == Both) {
+		uint64 key = iterator.GetData()->GetCoalesceKey();
+		if (iKeyKind && DBAsyncWork::CoalesceKeyKind(key) != iKeyKind) {
+			iterator.Advance();
+			continue;
+		}
+		if (!ExecutingWrites.count(key)) {
 			ret = iterator.GetData();
+			ExecutingWrites.insert(key);
+			if (key)
+				QueuedWrites.erase(key);
 			iterator.RemoveCurrent(false);
 			break;
 		}
@@ -203,6 +334,34 @@ DBAsyncWork* DBAsync::InListPopWrite() {
 	return ret;
 }
 
+bool DBAsync::WritesPending(uint32 iKeyKind) {
+	bool ret = false;
+	MInList.lock();
+	if (iKeyKind == 0) {
+		ret = (WriteList.Count() > 0 || !ExecutingWrites.empty());
+	}
+	else {
+		//keys sort by kind, so the kind's keys are one range
+		uint64 first = DBAsyncWork::MakeCoalesceKey(iKeyKind, 0);
+		std::set<uint64>::iterator executing = ExecutingWrites.lower_bound(first);
+		if (executing != ExecutingWrites.end() && DBAsyncWork::CoalesceKeyKind(*executing) == iKeyKind)
+			ret = true;
+		std::map<uint64, DBAsyncWork*>::iterator queued = QueuedWrites.lower_bound(first);
+		if (queued != QueuedWrites.end() && DBAsyncWork::CoalesceKeyKind(queued->first) == iKeyKind)
+			ret = true;
+	}
+	MInList.unlock();
+	return ret;
+}
+
+void DBAsync::FinishWrite(DBAsyncWork* iWork) {
+	if (iWork->Type() == Read)
+		return;
+	MInList.lock();
+	ExecutingWrites.erase(iWork->GetCoalesceKey());
+	MInList.unlock();
+}
+
 void DBAsync::AddFQ(DBAsyncFinishedQueue* iDBAFQ) {
 	MFQList.lock();
 	DBAsyncFinishedQueue** tmp = new DBAsyncFinishedQueue*;
@@ -211,20 +370,24 @@ void DBAsync::AddFQ(DBAsyncFinishedQueue* iDBAFQ) {
 	MFQList.unlock();
 }
 
-void DBAsync::Process() {
+void DBAsync::Process(Worker* iWorker) {
 	DBAsyncWork* tmpWork;
+	//the sleeps give the main thread a turn at a connection it shares with us,
+	//a worker with a connection of its own has nobody to yield to.
+	bool shared = !iWorker->OwnConnection;
 	MCurrentWork.lock();
-	while ((CurrentWork = InListPop())) {
+	while ((iWorker->CurrentWork = InListPop(iWorker->WritesFirst))) {
 		MCurrentWork.unlock();
 		//move from queued to executing
-		Status tmpStatus = CurrentWork->SetStatus(Executing);
+		Status tmpStatus = iWorker->CurrentWork->SetStatus(Executing);
 		if (tmpStatus == Queued) {
 			//execute the work
-			ProcessWork(CurrentWork);
-			tmpWork = CurrentWork;
+			ProcessWork(iWorker->dbc, iWorker->CurrentWork, shared);
+			tmpWork = iWorker->CurrentWork;
 			MCurrentWork.lock();
-			CurrentWork = 0;
+			iWorker->CurrentWork = 0;
 			MCurrentWork.unlock();
+			FinishWrite(tmpWork);
 			//move from executing to finished
 			tmpStatus = tmpWork->SetStatus(DBAsync::Finished);
 			if (tmpStatus != Executing) {
@@ -237,7 +400,8 @@ void DBAsync::Process() {
 			else {
 				//call callbacks or put results on finished queue
 				DispatchWork(tmpWork);
-				Sleep(25);
+				if (shared)
+					Sleep(25);
 				MCurrentWork.lock();
 			}
 		}
@@ -245,8 +409,9 @@ void DBAsync::Process() {
 			if (tmpStatus != Canceled) {
 				std::cout << "Error: Unexpected DBAsyncWork->Status in DBAsync::Process #2" << std::endl;
 			}
+			FinishWrite(iWorker->CurrentWork);
 			MCurrentWork.lock();
-			safe_delete(CurrentWork);
+			safe_delete(iWorker->CurrentWork);
 		}
 	}
 	MCurrentWork.unlock();
@@ -269,15 +434,24 @@ void DBAsync::CheckTimeout() {
 	}
 }
 
-void DBAsync::CommitWrites() {
+void DBAsync::CommitWrites(uint32 iKeyKind) {
 #if DEBUG_MYSQL_QUERIES >= 2
-	std::cout << "DBAsync::CommitWrites() called." << std::endl;
+	std::cout << "DBAsync::CommitWrites(" << iKeyKind << ") called." << std::endl;
 #endif
 	DBAsyncWork* tmpWork;
-	while ((tmpWork = InListPopWrite())) {
+	while (true) {
+		tmpWork = InListPopWrite(iKeyKind);
+		if (!tmpWork) {
+			//anything left is waiting on, or being run by, a worker writing the same rows
+			if (!WritesPending(iKeyKind))
+				break;
+			Sleep(1);
+			continue;
+		}
 		Status tmpStatus = tmpWork->SetStatus(Executing);
 		if (tmpStatus == Queued) {
-			ProcessWork(tmpWork);
+			ProcessWork(pDBC, tmpWork);
+			FinishWrite(tmpWork);
 			tmpStatus = tmpWork->SetStatus(DBAsync::Finished);
 			if (tmpStatus != Executing) {
 				if (tmpStatus != Canceled) {
@@ -293,15 +467,18 @@ void DBAsync::CommitWrites() {
 			if (tmpStatus != Canceled) {
 				std::cout << "Error: Unexpected DBAsyncWork->Status in DBAsync::CommitWrites #2" << std::endl;
 			}
+			FinishWrite(tmpWork);
 			safe_delete(tmpWork);
 		}
 	}
+	//were on the main thread, the callbacks of what we just wrote can run now
+	DispatchCallbacks();
 }
 
-void DBAsync::ProcessWork(DBAsyncWork* iWork, bool iSleep) {
+void DBAsync::ProcessWork(DBcore* iDBC, DBAsyncWork* iWork, bool iSleep) {
 	DBAsyncQuery* CurrentQuery;
 	while ((CurrentQuery = iWork->PopQuery())) {
-		CurrentQuery->Process(pDBC);
+		CurrentQuery->Process(iDBC);
 		iWork->PushAnswer(CurrentQuery);
 		if (iSleep)
 			Sleep(1);
@@ -309,11 +486,12 @@ void DBAsync::ProcessWork(DBAsyncWork* iWork, bool iSleep) {
 }
 
 void DBAsync::DispatchWork(DBAsyncWork* iWork) {
-	//if this work has a callback, call it
+	//if this work has a callback, queue it for the main thread
 	//otherwise, stick the work on the finish queue
 	if (iWork->pCB) {
-		if (iWork->pCB(iWork))
-			safe_delete(iWork);
+		MCBList.lock();
+		CBList.Append(iWork);
+		MCBList.unlock();
 	}
 	else {
 		if (!iWork->pDBAFQ->Push(iWork))
@@ -321,6 +499,19 @@ void DBAsync::DispatchWork(DBAsyncWork* iWork) {
 	}
 }
 
+void DBAsync::DispatchCallbacks() {
+	//one at a time so a callback can queue more work without us holding the lock
+	while (true) {
+		MCBList.lock();
+		DBAsyncWork* work = CBList.Pop();
+		MCBList.unlock();
+		if (!work)
+			break;
+		if (work->pCB(work))
+			safe_delete(work);
+	}
+}
+
 
 
 DBAsyncFinishedQueue::DBAsyncFinishedQueue(uint32 iTimeout) {
@@ -414,6 +605,7 @@ DBAsyncWork::DBAsyncWork(Database *db, DBAsyncFinishedQueue* iDBAFQ, uint32 iWPT
 	pAnswerCount = 0;
 	pTimeout = iTimeout;
 	pTSFinish = 0;
+	pCoalesceKey = 0;
 }
 
 DBAsyncWork::DBAsyncWork(Database *db, DBWorkCompleteCallBack iCB, uint32 iWPT, DBAsync::Type iType, uint32 iTimeout)
@@ -430,6 +622,7 @@ DBAsyncWork::DBAsyncWork(Database *db, DBWorkCompleteCallBack iCB, uint32 iWPT,
 	pAnswerCount = 0;
 	pTimeout = iTimeout;
 	pTSFinish = 0;
+	pCoalesceKey = 0;
 }
 
 DBAsyncWork::~DBAsyncWork() {
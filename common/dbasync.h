@@ -2,6 +2,9 @@
 #define DBASYNC_H
 #include "../common/dbcore.h"
 #include "../common/timeoutmgr.h"
+#include <map>
+#include <set>
+#include <vector>
 
 
 class DBAsyncFinishedQueue;
@@ -15,31 +18,50 @@ public:
 	enum Status { AddingWork, Queued, Executing, Finished, Canceled };
 	enum Type { Read, Write, Both };
 
-	DBAsync(DBcore* iDBC);
+	//iWorkers threads are started, each after the first gets its own connection
+	//opened with iDBC's settings so they dont all queue on iDBC's lock.
+	DBAsync(DBcore* iDBC, uint32 iWorkers = 1);
 	~DBAsync();
 	bool	StopThread();
 
 	uint32	AddWork(DBAsyncWork** iWork, uint32 iDelay = 0);
 	bool	CancelWork(uint32 iWorkID);
-	void	CommitWrites();
+	//runs the queued writes on the calling thread, delayed or not, and waits out the ones
+	//workers are running. A non zero iKeyKind only commits writes with that coalesce key kind.
+	void	CommitWrites(uint32 iKeyKind = 0);
+	//runs the callbacks of finished work, call it from the main loop
+	void	DispatchCallbacks();
 
 	void	AddFQ(DBAsyncFinishedQueue* iDBAFQ);
+
+	uint32	GetCoalescedWrites() { return pCoalescedWrites; }
 protected:
-	//things related to the processing thread:
+	//things related to the processing threads:
+	struct Worker {
+		DBAsync*	dba;
+		DBcore*		dbc;
+		bool		OwnConnection;
+		bool		WritesFirst;	//the first worker drains writes before reads, the rest do the opposite
+		Mutex		MLoopRunning;
+		DBAsyncWork* CurrentWork;
+	};
 	friend ThreadReturnType DBAsyncLoop(void* tmp);
-	Mutex	MLoopRunning;
 	Condition CInList;
 	bool	RunLoop();
-	void	Process();
+	void	Process(Worker* iWorker);
 
 private:
 	virtual void CheckTimeout();
 
-	void	ProcessWork(DBAsyncWork* iWork, bool iSleep = true);
+	void	ProcessWork(DBcore* iDBC, DBAsyncWork* iWork, bool iSleep = true);
 	void	DispatchWork(DBAsyncWork* iWork);
 	inline	uint32	GetNextID()		{ return pNextID++; }
-	DBAsyncWork*	InListPop();
-	DBAsyncWork*	InListPopWrite();	// Ignores delay
+	DBAsyncWork*	InListPop(bool iWritesFirst);
+	DBAsyncWork*	ListPop(LinkedList<DBAsyncWork*>& iList, bool iWrites);
+	DBAsyncWork*	InListPopWrite(uint32 iKeyKind);	// Ignores delay
+	bool			WritesPending(uint32 iKeyKind);
+	bool			WriteDue(uint64 iKey);
+	void			FinishWrite(DBAsyncWork* iWork);
 	void			OutListPush(DBAsyncWork* iDBAW);
 
 	Mutex	MRunLoop;
@@ -48,24 +70,35 @@ private:
 	DBcore*	pDBC;
 	uint32	pNextID;
 	Mutex	MInList;
-	LinkedList<DBAsyncWork*> InList;
+	LinkedList<DBAsyncWork*> ReadList;
+	LinkedList<DBAsyncWork*> WriteList;
+	// Coalesce keys of writes currently being executed, a newer write for the same
+	// key waits for it so two connections never race on the same rows. MInList protected.
+	std::set<uint64> ExecutingWrites;
+	// The one queued write for each non zero coalesce key. MInList protected.
+	std::map<uint64, DBAsyncWork*> QueuedWrites;
+	uint32	pCoalescedWrites;
 
 	Mutex	MFQList;
 	LinkedList<DBAsyncFinishedQueue**> FQList;
 
-	// Mutex for outside access to current work & when current work is being changed.
-	// NOT locked when CurrentWork is being accessed by the DBAsync thread.
-	// Never change pointer from outside DBAsync thread!
+	// Finished work with a callback, waiting for DispatchCallbacks()
+	Mutex	MCBList;
+	LinkedList<DBAsyncWork*> CBList;
+
+	// Mutex for outside access to the workers current work & when it is being changed.
+	// NOT locked when CurrentWork is being accessed by its own worker thread.
+	// Never change the pointers from outside DBAsync threads!
 	// Only here for access to thread-safe DBAsyncWork functions.
 	Mutex	MCurrentWork;
-	DBAsyncWork* CurrentWork;
+	std::vector<Worker*> Workers;
 
 };
 
 /*
 	DB Work Complete Callback:
-		This will be called under the DBAsync thread! Never access any non-threadsafe
-		data/functions/classes. (ie: zone, entitylist, client, etc are not threadsafe)
+		This is called from DBAsync::DispatchCallbacks() (or CommitWrites()) on the main
+		thread, never by the workers.
 	Function prototype:
 		return value:	true if we should delete the data, false if we should keep it
 */
@@ -109,6 +142,13 @@ public:
 	bool			CheckTimeout(uint32 iFQTimeout);
 	bool			SetWorkID(uint32 iWorkID);
 	uint32			GetWorkID();
+
+	// Writes queued with the same non zero key replace each other, only the newest one
+	// still waiting when a worker gets to it hits the database. Set before AddWork().
+	void			SetCoalesceKey(uint64 iKey) { pCoalesceKey = iKey; }
+	uint64			GetCoalesceKey() { return pCoalesceKey; }
+	static uint64	MakeCoalesceKey(uint32 iKind, uint32 iID) { return (((uint64) iKind) << 32) | iID; }
+	static uint32	CoalesceKeyKind(uint64 iKey) { return (uint32) (iKey >> 32); }
 protected:
 	friend class DBAsync;
 	DBAsync::Status	SetStatus(DBAsync::Status iStatus);
@@ -119,6 +159,7 @@ protected:
 
 	// not mutex'd cause only to be accessed from dbasync class
 	uint32	pExecuteAfter;
+	uint64	pCoalesceKey;
 private:
 	Mutex	MLock;
 	uint32	pQuestionCount;
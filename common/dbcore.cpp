@@ -251,6 +251,34 @@ bool DBcore::Open(const char* iHost, const char* iUser, const char* iPassword, c
 	return Open(errnum, errbuf);
 }
 
+DBcore* DBcore::Clone(DBcore* iSource, uint32* errnum, char* errbuf) {
+	if (errbuf)
+		errbuf[0] = 0;
+	if (!iSource)
+		return 0;
+	DBcore* ret = new DBcore;
+	iSource->MDatabase.lock();
+	if (!iSource->pHost) {
+		iSource->MDatabase.unlock();
+		safe_delete(ret);
+		return 0;
+	}
+	ret->pHost = strcpy(new char[strlen(iSource->pHost) + 1], iSource->pHost);
+	ret->pUser = strcpy(new char[strlen(iSource->pUser) + 1], iSource->pUser);
+	ret->pPassword = strcpy(new char[strlen(iSource->pPassword) + 1], iSource->pPassword);
+	ret->pDatabase = strcpy(new char[strlen(iSource->pDatabase) + 1], iSource->pDatabase);
+	ret->pCompress = iSource->pCompress;
+	ret->pPort = iSource->pPort;
+	ret->pSSL = iSource->pSSL;
+	iSource->MDatabase.unlock();
+
+	if (!ret->Open(errnum, errbuf)) {
+		safe_delete(ret);
+		return 0;
+	}
+	return ret;
+}
+
 bool DBcore::Open(uint32* errnum, char* errbuf) {
 	if (errbuf)
 		errbuf[0] = 0;
@@ -30,6 +30,9 @@ public:
 	void	ping();
 	MYSQL*	getMySQL(){ return &mysql; }
 
+	// Opens a second connection with the same settings as iSource, 0 if it couldnt connect.
+	static DBcore*	Clone(DBcore* iSource, uint32* errnum = 0, char* errbuf = 0);
+
 protected:
 	bool	Open(const char* iHost, const char* iUser, const char* iPassword, const char* iDatabase, uint32 iPort, uint32* errnum = 0, char* errbuf = 0, bool iCompress = false, bool iSSL = false);
 private:
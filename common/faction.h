@@ -22,6 +22,7 @@
 #include "features.h"
 #include <map>
 #include <string>
+#include <vector>
 
 enum FACTION_VALUE {
 	FACTION_ALLY = 1,
@@ -57,7 +58,9 @@ struct FactionMods
 
 struct Faction {
 	int32	id;
-	std::map<std::string, int16> mods;
+	//indexed by the mod slot the loader gave each class, race and deity named in
+	//faction_list_mod, empty if the faction has no mods at all
+	std::vector<int16> mods;
 	int16	base;
 	char	name[50];
 };
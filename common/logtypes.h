@@ -174,6 +174,7 @@ LOG_TYPE( CLIENT, SPELLS, DISABLED )
 LOG_TYPE( CLIENT, NET_ERR, ENABLED )
 LOG_TYPE( CLIENT, NET_IN_TRACE, DISABLED )
 LOG_TYPE( CLIENT, EXP, DISABLED )
+LOG_TYPE( CLIENT, SAVE, DISABLED )
 
 LOG_CATEGORY( SKILLS )
 LOG_TYPE( SKILLS, GAIN, DISABLED )
@@ -202,6 +203,7 @@ LOG_TYPE( NET, NET_CREATE, DISABLED )
 LOG_TYPE( NET, NET_CREATE_HEX, DISABLED )
 LOG_TYPE( NET, NET_ACKS, DISABLED )
 LOG_TYPE( NET, RATES, DISABLED )
+LOG_TYPE( NET, WRITE_LATENCY, DISABLED )
 
 LOG_CATEGORY( DATABASE )
 
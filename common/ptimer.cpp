@@ -109,6 +109,7 @@ PersistentTimer::PersistentTimer(uint32 char_id, pTimerType type, uint32 in_time
 	} else {
 		enabled = true;
 	}
+	dirty = true;
 #ifdef DEBUG_PTIMERS
 	printf("New timer: char %lu of type %u at %lu for %lu seconds.\n", (unsigned long)_char_id, _type, (unsigned long)start_time, (unsigned long)timer_time);
 #endif
@@ -121,6 +122,7 @@ PersistentTimer::PersistentTimer(uint32 char_id, pTimerType type, uint32 in_star
 	timer_time = in_timer_time;
 	start_time = in_start_time;
 	enabled = in_enable;
+	dirty = false;	//only used for timers read from the db
 #ifdef DEBUG_PTIMERS
 	printf("New stored timer: char %lu of type %u at %lu for %lu seconds.\n", (unsigned long)_char_id, _type, (unsigned long)start_time, (unsigned long)timer_time);
 #endif
@@ -156,6 +158,7 @@ bool PersistentTimer::Load(Database *db) {
 		start_time = strtoul(row[0], nullptr, 10);
 		timer_time = strtoul(row[1], nullptr, 10);
 		enabled = (row[2][0] == '1');
+		dirty = false;
 
 		res = true;
 	}
@@ -164,7 +167,10 @@ bool PersistentTimer::Load(Database *db) {
 	return(res);
 }
 
-bool PersistentTimer::Store(Database *db) {
+bool PersistentTimer::Store(Database *db, uint32 *written) {
+	if(!dirty)
+		return(true);
+
 	if(Expired(db, false))	//dont need to store expired timers.
 		return(true);
 
@@ -191,6 +197,10 @@ bool PersistentTimer::Store(Database *db) {
 	}
 	safe_delete_array(query);
 
+	dirty = false;
+	if(written != nullptr)
+		*written += qlen;
+
 	return(true);
 }
 
@@ -230,6 +240,7 @@ bool PersistentTimer::Expired(Database *db, bool iReset) {
 	if (current_time-start_time >= timer_time) {
 		if (enabled && iReset) {
 			start_time = current_time; // Reset timer
+			dirty = true;
 		} else if(enabled) {
 			Clear(db);	//remove it from DB too
 		}
@@ -243,6 +254,7 @@ bool PersistentTimer::Expired(Database *db, bool iReset) {
 void PersistentTimer::Start(uint32 set_timer_time) {
 	start_time = get_current_time();
 	enabled = true;
+	dirty = true;
 	if (set_timer_time != 0) {
 		timer_time = set_timer_time;
 	}
@@ -255,6 +267,7 @@ void PersistentTimer::Start(uint32 set_timer_time) {
 void PersistentTimer::SetTimer(uint32 set_timer_time) {
 	// If we were disabled before => restart the timer
 	timer_time = set_timer_time;
+	dirty = true;
 	if (!enabled) {
 		start_time = get_current_time();
 		enabled = true;
@@ -357,7 +370,7 @@ bool PTimerList::Load(Database *db) {
 	return(true);
 }
 
-bool PTimerList::Store(Database *db) {
+bool PTimerList::Store(Database *db, uint32 *written) {
 #ifdef DEBUG_PTIMERS
 	printf("Storing all timers for char %lu\n", (unsigned long)_char_id);
 #endif
@@ -370,7 +383,7 @@ bool PTimerList::Store(Database *db) {
 #ifdef DEBUG_PTIMERS
 	printf("Storing timer %u for char %lu\n", s->first, (unsigned long)_char_id);
 #endif
-			if(!s->second->Store(db))
+			if(!s->second->Store(db, written))
 				res = false;
 		}
 		++s;
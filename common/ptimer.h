@@ -72,16 +72,20 @@ public:
 
 	void SetTimer(uint32 set_timer_time=0);
 	uint32 GetRemainingTime();
-	inline void Enable() { enabled = true; }
-	inline void Disable() { enabled = false; }
+	inline void Enable() { enabled = true; dirty = true; }
+	inline void Disable() { enabled = false; dirty = true; }
 	inline const uint32 GetTimerTime() const { return timer_time; }
 	inline const uint32 GetStartTime() const { return start_time; }
 	inline const pTimerType GetType() const { return _type; }
 
 	inline bool Enabled() { return enabled; }
 
+	inline bool IsDirty() const { return dirty; }
+
 	bool Load(Database *db);
-	bool Store(Database *db);
+	//only writes the timer if it changed since it was loaded or last stored,
+	//written is increased by the size of the query sent.
+	bool Store(Database *db, uint32 *written = nullptr);
 	bool Clear(Database *db);
 
 protected:
@@ -90,6 +94,7 @@ protected:
 	uint32	start_time;
 	uint32	timer_time;
 	bool	enabled;
+	bool	dirty;	//differs from what is in the db
 
 	uint32 _char_id;
 	pTimerType _type;
@@ -103,7 +108,7 @@ public:
 	~PTimerList();
 
 	bool Load(Database *db);
-	bool Store(Database *db);
+	bool Store(Database *db, uint32 *written = nullptr);
 	bool Clear(Database *db);
 
 	void Start(pTimerType type, uint32 duration);
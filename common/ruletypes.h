@@ -161,6 +161,10 @@ RULE_BOOL (World, IsGMPetitionWindowEnabled, false)
 RULE_INT (World, FVNoDropFlag, 0) // Sets the Firiona Vie settings on the client. If set to 2, the flag will be set for GMs only, allowing trading of no-drop items.
 RULE_BOOL (World, IPLimitDisconnectAll, false)
 RULE_BOOL( World, AnnounceJoinQuits, false) //Broadcasts player logins and log outs if true.
+RULE_BOOL ( World, ZoneBootByLoad, false ) // Boot zones on the idle zone server whose host has the least load (from the zones' load reports) instead of the first idle one.
+RULE_INT ( World, ZoneBootClientWeight, 2 ) // How much one client already on a host counts against it when placing a boot, in the same units as a percent of host cpu load.
+RULE_INT ( World, ZoneBootTickWeight, 50 ) // How much a percent of Zone:TickProfileBudget used by the host's slowest zone ticks counts against it when placing a boot, as a percent of a percent of host cpu load.
+RULE_INT ( World, StandbyZonesPerLauncher, 0 ) // Idle zones each launcher keeps ready, world starts extra dynamics (up to this many past its configured count) when it has fewer.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Zone )
@@ -189,6 +193,10 @@ RULE_INT ( Zone, ReservedInstances, 30 ) //Will reserve this many instance ids f
 RULE_BOOL ( Zone, LevelBasedEXPMods, false) // Allows you to use the level_exp_mods table in consideration to your players EXP hits
 RULE_INT ( Zone, WeatherTimer, 600) // Weather timer when no duration is available
 RULE_INT (Zone, SpawnEventMin, 5) // When strict is set in spawn_events, specifies the max EQ minutes into the trigger hour a spawn_event will fire.
+RULE_INT ( Zone, TickProfileReportInterval, 30 ) // Seconds between main loop profile reports to world, 0 disables them.
+RULE_INT ( Zone, TickProfileBudget, 10 ) // A main loop tick doing more than this many ms of work (the update interval) is counted as over budget.
+RULE_INT ( Zone, LoadReportInterval, 5 ) // Seconds between cpu/tick/client load reports to world, used to place zone boots. 0 disables them.
+RULE_BOOL ( Zone, ParallelBoot, true ) // Load the map files and the spawn and zone point tables on worker threads (with their own database connections) while the rest of the zone boots.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Map )
@@ -206,6 +214,11 @@ RULE_BOOL ( Map, UseClosestZ, true)			// Move mobs to the nearest Z above or bel
 							// with azone2.
 							//
 RULE_INT ( Map, FindBestZHeightAdjust, 1)		// Adds this to the current Z before seeking the best Z position
+RULE_BOOL ( Map, UseHeightField, true )		// Answer FindBestZ from the zone's .hgt height field (made by mapconvert) when it has one.
+RULE_INT ( Map, LOSCacheSize, 8192 )			// Line of sight results remembered per zone (rounded down to a power of two), 0 disables the cache.
+RULE_INT ( Map, LOSCacheTTL, 500 )			// ms a cached line of sight result is trusted for.
+RULE_REAL ( Map, LOSCacheCellSize, 2.0 )		// x/y units that line of sight end points are rounded to for the cache.
+RULE_REAL ( Map, LOSCacheZBand, 2.0 )			// z units that line of sight end points are rounded to for the cache.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Pathing )
@@ -237,6 +250,7 @@ RULE_INT ( Pathing, CullNodesFromStart, 1)		// Checks LOS from Start point to se
 RULE_INT ( Pathing, CullNodesFromEnd, 1)		// Checks LOS from End point to second to last node for this many nodes and removes last node if there is LOS
 RULE_REAL ( Pathing, CandidateNodeRangeXY, 400)		// When searching for path start/end nodes, only nodes within this range will be considered.
 RULE_REAL ( Pathing, CandidateNodeRangeZ, 10)		// When searching for path start/end nodes, only nodes within this range will be considered.
+RULE_INT ( Pathing, RouteCacheSize, 1024)		// Node to node routes remembered per zone, 0 disables the route cache.
 
 RULE_CATEGORY_END()
 
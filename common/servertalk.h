@@ -4,6 +4,7 @@
 #include "../common/types.h"
 #include "../common/packet_functions.h"
 #include "../common/eq_packet_structs.h"
+#include "../common/tick_profiler.h"
 
 #define SERVER_TIMEOUT	45000	// how often keepalive gets sent
 #define INTERSERVER_TIMER					10000
@@ -147,6 +148,7 @@
 #define ServerOP_LauncherZoneRequest	0x3001
 #define ServerOP_LauncherZoneStatus		0x3002
 #define ServerOP_DoZoneCommand		0x3003
+#define ServerOP_LauncherZoneAttach		0x3009
 
 #define ServerOP_UCSMessage		0x4000
 #define ServerOP_UCSMailMessage 0x4001
@@ -165,6 +167,8 @@
 #define ServerOP_QSPlayerLogDeletes			0x4013
 #define ServerOP_QSPlayerLogMoves			0x4014
 #define ServerOP_QSMerchantLogTransactions	0x4015
+#define ServerOP_ZoneTickProfile	0x4016
+#define ServerOP_ZoneLoad			0x4017
 
 enum { QSG_LFGuild = 0 };
 enum {	QSG_LFGuild_PlayerMatches = 0, QSG_LFGuild_UpdatePlayerInfo, QSG_LFGuild_RequestPlayerInfo, QSG_LFGuild_UpdateGuildInfo, QSG_LFGuild_GuildMatches,
@@ -727,7 +731,8 @@ struct LauncherConnectInfo {
 typedef enum {
 	ZR_Start,
 	ZR_Restart,
-	ZR_Stop
+	ZR_Stop,
+	ZR_WarmReady	//the warm process short_name has connected to world and can be attached
 } ZoneRequestCommands;
 struct LauncherZoneRequest {
 	uint8 command;
@@ -740,6 +745,12 @@ struct LauncherZoneStatus {
 	uint8 running;
 };
 
+//launcher handed its idle warm process warm_name to the static zone short_name
+struct LauncherZoneAttach {
+	char warm_name[33];
+	char short_name[33];
+};
+
 
 struct ServerGuildID_Struct {
 	uint32 guild_id;
@@ -1046,6 +1057,26 @@ struct ReloadWorld_Struct{
 	uint32 Option;
 };
 
+struct ServerZoneTickProfile_Struct {
+	uint32	zone_id;
+	uint16	instance_id;
+	uint32	ticks;			// ticks in the rolling window the sections cover
+	uint32	budget;			// usec, 0 if there is no budget
+	uint32	over_budget;	// ticks over budget since the previous report
+	uint32	interval;		// ms since the previous report
+	TickSectionSummary sections[TickSectionCount];
+};
+
+// sent by every zone process, booted or idle, so world can place zone boots
+struct ServerZoneLoad_Struct {
+	uint32	cpu;			// percent of one core this process used since the previous report, x100
+	uint32	host_load;		// the host's 1 minute load average x100, 0 if unknown
+	uint32	host_cpus;		// cores on the host, 0 if unknown
+	uint32	tick_avg;		// usec, main loop work per tick over the profiler window, 0 while idle
+	uint32	tick_p99;		// usec
+	uint32	clients;
+};
+
 #pragma pack()
 
 #endif
@@ -17,18 +17,20 @@
 #include "eqemu_exception.h"
 #include "loottable.h"
 #include "faction.h"
+#include "npc_type.h"
 #include "features.h"
 
 SharedDatabase::SharedDatabase()
 : Database(), skill_caps_mmf(nullptr), items_mmf(nullptr), items_hash(nullptr), faction_mmf(nullptr), faction_hash(nullptr),
-	loot_table_mmf(nullptr), loot_table_hash(nullptr), loot_drop_mmf(nullptr), loot_drop_hash(nullptr), base_data_mmf(nullptr)
+	loot_table_mmf(nullptr), loot_table_hash(nullptr), loot_drop_mmf(nullptr), loot_drop_hash(nullptr), base_data_mmf(nullptr),
+	npc_types_mmf(nullptr), npc_types_hash(nullptr)
 {
 }
 
 SharedDatabase::SharedDatabase(const char* host, const char* user, const char* passwd, const char* database, uint32 port)
 : Database(host, user, passwd, database, port), skill_caps_mmf(nullptr), items_mmf(nullptr), items_hash(nullptr),
 	faction_mmf(nullptr), faction_hash(nullptr), loot_table_mmf(nullptr), loot_table_hash(nullptr), loot_drop_mmf(nullptr),
-	loot_drop_hash(nullptr), base_data_mmf(nullptr)
+	loot_drop_hash(nullptr), base_data_mmf(nullptr), npc_types_mmf(nullptr), npc_types_hash(nullptr)
 {
 }
 
@@ -36,6 +38,8 @@ SharedDatabase::~SharedDatabase() {
 	safe_delete(skill_caps_mmf);
 	safe_delete(items_mmf);
 	safe_delete(items_hash);
+	safe_delete(npc_types_mmf);
+	safe_delete(npc_types_hash);
 	safe_delete(faction_mmf);
 	safe_delete(faction_hash);
 	safe_delete(loot_table_mmf);
@@ -1135,13 +1139,16 @@ bool SharedDatabase::GetPlayerProfile(uint32 account_id, char* name, PlayerProfi
 	return ret;
 }
 
-bool SharedDatabase::SetPlayerProfile(uint32 account_id, uint32 charid, PlayerProfile_Struct* pp, Inventory* inv, ExtendedProfile_Struct *ext, uint32 current_zone, uint32 current_instance) {
+bool SharedDatabase::SetPlayerProfile(uint32 account_id, uint32 charid, PlayerProfile_Struct* pp, Inventory* inv, ExtendedProfile_Struct *ext, uint32 current_zone, uint32 current_instance, uint32 *written) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char* query = 0;
 	uint32 affected_rows = 0;
 	bool ret = false;
 
-	if (RunQuery(query, SetPlayerProfile_MQ(&query, account_id, charid, pp, inv, ext, current_zone, current_instance), errbuf, 0, &affected_rows)) {
+	uint32 len = SetPlayerProfile_MQ(&query, account_id, charid, pp, inv, ext, current_zone, current_instance);
+	if (written)
+		*written += len;
+	if (RunQuery(query, len, errbuf, 0, &affected_rows)) {
 		ret = (affected_rows != 0);
 	}
 
@@ -1177,6 +1184,364 @@ uint32 SharedDatabase::SetPlayerProfile_MQ(char** query, uint32 account_id, uint
 
 
 
+// The npc_types columns LoadNPCTypeRow expects, shared by the zone query and the shared memory loader.
+const char *SharedDatabase::NPCTypesQuery() {
+	return "SELECT "
+		"npc_types.id,"
+		"npc_types.name,"
+		"npc_types.level,"
+		"npc_types.race,"
+		"npc_types.class,"
+		"npc_types.hp,"
+		"npc_types.mana,"
+		"npc_types.gender,"
+		"npc_types.texture,"
+		"npc_types.helmtexture,"
+		"npc_types.size,"
+		"npc_types.loottable_id,"
+		"npc_types.merchant_id,"
+		"npc_types.trap_template,"
+		"npc_types.attack_speed,"
+		"npc_types.STR,"
+		"npc_types.STA,"
+		"npc_types.DEX,"
+		"npc_types.AGI,"
+		"npc_types._INT,"
+		"npc_types.WIS,"
+		"npc_types.CHA,"
+		"npc_types.MR,"
+		"npc_types.CR,"
+		"npc_types.DR,"
+		"npc_types.FR,"
+		"npc_types.PR,"
+		"npc_types.Corrup,"
+		"npc_types.PhR,"
+		"npc_types.mindmg,"
+		"npc_types.maxdmg,"
+		"npc_types.attack_count,"
+		"npc_types.special_abilities,"
+		"npc_types.npc_spells_id,"
+		"npc_types.npc_spells_effects_id,"
+		"npc_types.d_meele_texture1,"
+		"npc_types.d_meele_texture2,"
+		"npc_types.prim_melee_type,"
+		"npc_types.sec_melee_type,"
+		"npc_types.runspeed,"
+		"npc_types.findable,"
+		"npc_types.trackable,"
+		"npc_types.hp_regen_rate,"
+		"npc_types.mana_regen_rate,"
+		"npc_types.aggroradius,"
+		"npc_types.assistradius,"
+		"npc_types.bodytype,"
+		"npc_types.npc_faction_id,"
+		"npc_types.face,"
+		"npc_types.luclin_hairstyle,"
+		"npc_types.luclin_haircolor,"
+		"npc_types.luclin_eyecolor,"
+		"npc_types.luclin_eyecolor2,"
+		"npc_types.luclin_beardcolor,"
+		"npc_types.luclin_beard,"
+		"npc_types.drakkin_heritage,"
+		"npc_types.drakkin_tattoo,"
+		"npc_types.drakkin_details,"
+		"npc_types.armortint_id,"
+		"npc_types.armortint_red,"
+		"npc_types.armortint_green,"
+		"npc_types.armortint_blue,"
+		"npc_types.see_invis,"
+		"npc_types.see_invis_undead,"
+		"npc_types.lastname,"
+		"npc_types.qglobal,"
+		"npc_types.AC,"
+		"npc_types.npc_aggro,"
+		"npc_types.spawn_limit,"
+		"npc_types.see_hide,"
+		"npc_types.see_improved_hide,"
+		"npc_types.ATK,"
+		"npc_types.Accuracy,"
+		"npc_types.slow_mitigation,"
+		"npc_types.maxlevel,"
+		"npc_types.scalerate,"
+		"npc_types.private_corpse,"
+		"npc_types.unique_spawn_by_name,"
+		"npc_types.underwater,"
+		"npc_types.emoteid,"
+		"npc_types.spellscale,"
+		"npc_types.healscale,"
+		"npc_types.no_target_hotkey "
+		"FROM npc_types";
+}
+
+void SharedDatabase::LoadNPCTypeRow(MYSQL_ROW row, NPCType *npc) {
+	memset(npc, 0, sizeof(NPCType));
+
+	int r = 0;
+	npc->npc_id = atoi(row[r++]);
+
+	strn0cpy(npc->name, row[r++], 50);
+
+	npc->level = atoi(row[r++]);
+	npc->race = atoi(row[r++]);
+	npc->class_ = atoi(row[r++]);
+	npc->max_hp = atoi(row[r++]);
+	npc->cur_hp = npc->max_hp;
+	npc->Mana = atoi(row[r++]);
+	npc->gender = atoi(row[r++]);
+	npc->texture = atoi(row[r++]);
+	npc->helmtexture = atoi(row[r++]);
+	npc->size = atof(row[r++]);
+	npc->loottable_id = atoi(row[r++]);
+	npc->merchanttype = atoi(row[r++]);
+	npc->trap_template = atoi(row[r++]);
+	npc->attack_speed = atof(row[r++]);
+	npc->STR = atoi(row[r++]);
+	npc->STA = atoi(row[r++]);
+	npc->DEX = atoi(row[r++]);
+	npc->AGI = atoi(row[r++]);
+	npc->INT = atoi(row[r++]);
+	npc->WIS = atoi(row[r++]);
+	npc->CHA = atoi(row[r++]);
+	npc->MR = atoi(row[r++]);
+	npc->CR = atoi(row[r++]);
+	npc->DR = atoi(row[r++]);
+	npc->FR = atoi(row[r++]);
+	npc->PR = atoi(row[r++]);
+	npc->Corrup = atoi(row[r++]);
+	npc->PhR = atoi(row[r++]);
+	npc->min_dmg = atoi(row[r++]);
+	npc->max_dmg = atoi(row[r++]);
+	npc->attack_count = atoi(row[r++]);
+	strn0cpy(npc->special_abilities, row[r++], 512);
+	npc->npc_spells_id = atoi(row[r++]);
+	npc->npc_spells_effects_id = atoi(row[r++]);
+	npc->d_meele_texture1 = atoi(row[r++]);
+	npc->d_meele_texture2 = atoi(row[r++]);
+	npc->prim_melee_type = atoi(row[r++]);
+	npc->sec_melee_type = atoi(row[r++]);
+	npc->runspeed= atof(row[r++]);
+	npc->findable = atoi(row[r++]) == 0? false : true;
+	npc->trackable = atoi(row[r++]) == 0? false : true;
+	npc->hp_regen = atoi(row[r++]);
+	npc->mana_regen = atoi(row[r++]);
+
+	npc->aggroradius = (int32)atoi(row[r++]);
+	// set defaultvalue for aggroradius
+	if (npc->aggroradius <= 0)
+		npc->aggroradius = 70;
+	npc->assistradius = (int32)atoi(row[r++]);
+	if (npc->assistradius <= 0)
+		npc->assistradius = npc->aggroradius;
+
+	if (row[r] && strlen(row[r]))
+		npc->bodytype = (uint8)atoi(row[r]);
+	else
+		npc->bodytype = 0;
+	r++;
+
+	npc->npc_faction_id = atoi(row[r++]);
+
+	npc->luclinface = atoi(row[r++]);
+	npc->hairstyle = atoi(row[r++]);
+	npc->haircolor = atoi(row[r++]);
+	npc->eyecolor1 = atoi(row[r++]);
+	npc->eyecolor2 = atoi(row[r++]);
+	npc->beardcolor = atoi(row[r++]);
+	npc->beard = atoi(row[r++]);
+	npc->drakkin_heritage = atoi(row[r++]);
+	npc->drakkin_tattoo = atoi(row[r++]);
+	npc->drakkin_details = atoi(row[r++]);
+	uint32 armor_tint_id = atoi(row[r++]);
+	npc->armor_tint[0] = (atoi(row[r++]) & 0xFF) << 16;
+	npc->armor_tint[0] |= (atoi(row[r++]) & 0xFF) << 8;
+	npc->armor_tint[0] |= (atoi(row[r++]) & 0xFF);
+	npc->armor_tint[0] |= (npc->armor_tint[0]) ? (0xFF << 24) : 0;
+	
+	int i;
+	if (armor_tint_id > 0)
+	{
+		if (npc->armor_tint[0] == 0)
+		{
+			char at_errbuf[MYSQL_ERRMSG_SIZE];
+			char *at_query = nullptr;
+			MYSQL_RES *at_result = nullptr;
+			MYSQL_ROW at_row;
+
+			MakeAnyLenString(&at_query,
+			"SELECT "
+			"red1h,grn1h,blu1h,"
+			"red2c,grn2c,blu2c,"
+			"red3a,grn3a,blu3a,"
+			"red4b,grn4b,blu4b,"
+			"red5g,grn5g,blu5g,"
+			"red6l,grn6l,blu6l,"
+			"red7f,grn7f,blu7f,"
+			"red8x,grn8x,blu8x,"
+			"red9x,grn9x,blu9x "
+			"FROM npc_types_tint WHERE id=%d", armor_tint_id);
+
+			if (RunQuery(at_query, strlen(at_query), at_errbuf, &at_result))
+			{
+				if ((at_row = mysql_fetch_row(at_result)))
+				{
+					for (i = 0; i < _MaterialCount; i++)
+					{
+						npc->armor_tint[i] = atoi(at_row[i * 3]) << 16;
+						npc->armor_tint[i] |= atoi(at_row[i * 3 + 1]) << 8;
+						npc->armor_tint[i] |= atoi(at_row[i * 3 + 2]);
+						npc->armor_tint[i] |= (npc->armor_tint[i]) ? (0xFF << 24) : 0;
+					}
+				}
+				else
+				{
+					armor_tint_id = 0;
+				}
+			}
+			else
+			{
+				armor_tint_id = 0;
+			}
+
+			if (at_result)
+			{
+				mysql_free_result(at_result);
+			}
+
+			safe_delete_array(at_query);
+		}
+		else
+		{
+			armor_tint_id = 0;
+		}
+	}
+
+	if (armor_tint_id == 0)
+	{
+		for (i = 1; i < _MaterialCount; i++)
+		{
+			npc->armor_tint[i] = npc->armor_tint[0];
+		}
+	}
+
+	npc->see_invis = atoi(row[r++]);
+	npc->see_invis_undead = atoi(row[r++])==0?false:true;	// Set see_invis_undead flag
+	if (row[r] != nullptr)
+		strn0cpy(npc->lastname, row[r], 32);
+	r++;
+
+	npc->qglobal = atoi(row[r++])==0?false:true;	// qglobal
+	npc->AC = atoi(row[r++]);
+	npc->npc_aggro = atoi(row[r++])==0?false:true;
+	npc->spawn_limit = atoi(row[r++]);
+	npc->see_hide = atoi(row[r++])==0?false:true;
+	npc->see_improved_hide = atoi(row[r++])==0?false:true;
+	npc->ATK = atoi(row[r++]);
+	npc->accuracy_rating = atoi(row[r++]);
+	npc->slow_mitigation = atoi(row[r++]);
+	npc->maxlevel = atoi(row[r++]);
+	npc->scalerate = atoi(row[r++]);
+	npc->private_corpse = atoi(row[r++]) == 1 ? true : false;
+	npc->unique_spawn_by_name = atoi(row[r++]) == 1 ? true : false;
+	npc->underwater = atoi(row[r++]) == 1 ? true : false;
+	npc->emoteid = atoi(row[r++]);
+	npc->spellscale = atoi(row[r++]);
+	npc->healscale = atoi(row[r++]);
+	npc->no_target_hotkey = atoi(row[r++]) == 1 ? true : false;
+}
+
+void SharedDatabase::GetNPCTypesCount(int32 &npc_count, uint32 &max_id) {
+	char errbuf[MYSQL_ERRMSG_SIZE];
+	MYSQL_RES *result;
+	MYSQL_ROW row;
+	npc_count = -1;
+	max_id = 0;
+
+	char query[] = "SELECT MAX(id), count(*) FROM npc_types";
+	if (RunQuery(query, static_cast<uint32>(strlen(query)), errbuf, &result)) {
+		row = mysql_fetch_row(result);
+		if (row != nullptr && row[1] != 0) {
+			npc_count = atoi(row[1]);
+			if(row[0])
+				max_id = atoi(row[0]);
+		}
+		mysql_free_result(result);
+	}
+	else {
+		LogFile->write(EQEMuLog::Error, "Error in GetNPCTypesCount '%s': '%s'", query, errbuf);
+	}
+}
+
+bool SharedDatabase::LoadNPCTypes() {
+	if(npc_types_mmf) {
+		return true;
+	}
+
+	try {
+		EQEmu::IPCMutex mutex("npc_types");
+		mutex.Lock();
+		npc_types_mmf = new EQEmu::MemoryMappedFile("shared/npc_types");
+
+		int32 npc_types = -1;
+		uint32 max_npc_type = 0;
+		GetNPCTypesCount(npc_types, max_npc_type);
+		if(npc_types == -1) {
+			EQ_EXCEPT("SharedDatabase", "Database returned no result");
+		}
+		uint32 size = static_cast<uint32>(EQEmu::FixedMemoryHashSet<NPCType>::estimated_size(npc_types, max_npc_type));
+		if(npc_types_mmf->Size() != size) {
+			EQ_EXCEPT("SharedDatabase", "Couldn't load npc types because npc_types_mmf->Size() != size");
+		}
+
+		npc_types_hash = new EQEmu::FixedMemoryHashSet<NPCType>(reinterpret_cast<uint8*>(npc_types_mmf->Get()), size);
+		mutex.Unlock();
+	} catch(std::exception& ex) {
+		LogFile->write(EQEMuLog::Error, "Error Loading NPC Types: %s", ex.what());
+		safe_delete(npc_types_mmf);
+		return false;
+	}
+
+	return true;
+}
+
+void SharedDatabase::LoadNPCTypes(void *data, uint32 size, int32 npc_types, uint32 max_npc_type_id) {
+	EQEmu::FixedMemoryHashSet<NPCType> hash(reinterpret_cast<uint8*>(data), size, npc_types, max_npc_type_id);
+	char errbuf[MYSQL_ERRMSG_SIZE];
+	MYSQL_RES *result;
+	MYSQL_ROW row;
+
+	const char *query = NPCTypesQuery();
+	if(RunQuery(query, static_cast<uint32>(strlen(query)), errbuf, &result)) {
+		NPCType npc;
+		while((row = mysql_fetch_row(result))) {
+			LoadNPCTypeRow(row, &npc);
+
+			try {
+				hash.insert(npc.npc_id, npc);
+			} catch(std::exception &ex) {
+				LogFile->write(EQEMuLog::Error, "Database::LoadNPCTypes: %s", ex.what());
+				break;
+			}
+		}
+
+		mysql_free_result(result);
+	}
+	else {
+		LogFile->write(EQEMuLog::Error, "LoadNPCTypes '%s', %s", query, errbuf);
+	}
+}
+
+const NPCType* SharedDatabase::GetSharedNPCType(uint32 id) {
+	if(!npc_types_hash || id > npc_types_hash->max_key()) {
+		return nullptr;
+	}
+
+	if(npc_types_hash->exists(id)) {
+		return &(npc_types_hash->at(id));
+	}
+
+	return nullptr;
+}
+
 // Create appropriate ItemInst class
 ItemInst* SharedDatabase::CreateItem(uint32 item_id, int16 charges)
 {
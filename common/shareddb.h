@@ -19,6 +19,7 @@ struct NPCFactionList;
 struct Faction;
 struct LootTable_Struct;
 struct LootDrop_Struct;
+struct NPCType;
 namespace EQEmu {
 	class MemoryMappedFile;
 }
@@ -41,7 +42,7 @@ public:
 	uint8	GetGMSpeed(uint32 account_id);
 	bool	SetHideMe(uint32 account_id, uint8 hideme);
 	bool	GetPlayerProfile(uint32 account_id, char* name, PlayerProfile_Struct* pp, Inventory* inv, ExtendedProfile_Struct *ext, char* current_zone = 0, uint32 *current_instance = 0);
-	bool	SetPlayerProfile(uint32 account_id, uint32 charid, PlayerProfile_Struct* pp, Inventory* inv, ExtendedProfile_Struct *ext, uint32 current_zone, uint32 current_instance);
+	bool	SetPlayerProfile(uint32 account_id, uint32 charid, PlayerProfile_Struct* pp, Inventory* inv, ExtendedProfile_Struct *ext, uint32 current_zone, uint32 current_instance, uint32 *written = nullptr);
 	uint32	SetPlayerProfile_MQ(char** query, uint32 account_id, uint32 charid, PlayerProfile_Struct* pp, Inventory* inv, ExtendedProfile_Struct *ext, uint32 current_zone, uint32 current_instance);
 	int32	DeleteStalePlayerCorpses();
 	int32	DeleteStalePlayerBackups();
@@ -112,6 +113,13 @@ public:
 	void LoadBaseData(void *data, int max_level);
 	const BaseDataStruct* GetBaseData(int lvl, int cl);
 
+	static const char* NPCTypesQuery();
+	void LoadNPCTypeRow(MYSQL_ROW row, NPCType *npc);
+	void GetNPCTypesCount(int32 &npc_count, uint32 &max_id);
+	bool LoadNPCTypes();
+	void LoadNPCTypes(void *data, uint32 size, int32 npc_types, uint32 max_npc_type_id);
+	const NPCType* GetSharedNPCType(uint32 id);
+
 protected:
 
 	EQEmu::MemoryMappedFile *skill_caps_mmf;
@@ -124,6 +132,8 @@ protected:
 	EQEmu::MemoryMappedFile *loot_drop_mmf;
 	EQEmu::FixedMemoryVariableHashSet<LootDrop_Struct> *loot_drop_hash;
 	EQEmu::MemoryMappedFile *base_data_mmf;
+	EQEmu::MemoryMappedFile *npc_types_mmf;
+	EQEmu::FixedMemoryHashSet<NPCType> *npc_types_hash;
 };
 
 #endif /*SHAREDDB_H_*/
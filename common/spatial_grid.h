@@ -0,0 +1,259 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_SPATIAL_GRID_H
+#define _EQEMU_SPATIAL_GRID_H
+
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+#include "types.h"
+
+namespace EQEmu {
+
+	/*! Uniform grid over the x/y plane used to find entries near a point without walking
+	every entry. Cells are hashed so the grid does not need to know the zone bounds.
+	Queries return every entry in a cell that overlaps the query square, so callers are
+	still expected to do their own exact distance checks on the results.
+	*/
+	template<class T>
+	class SpatialGrid {
+		typedef uint32 key_type;
+		typedef uint64 cell_type;
+		typedef T value_type;
+		typedef const value_type& const_reference;
+		typedef size_t size_type;
+
+		struct Entry {
+			key_type id;
+			value_type value;
+		};
+
+		struct Record {
+			cell_type cell;
+			value_type value;
+		};
+	public:
+		/*!
+			Constructor
+		\param cell_size Width of a grid cell in world units
+		*/
+		SpatialGrid(float cell_size = 250.0f) {
+			if(cell_size < 1.0f) {
+				cell_size = 1.0f;
+			}
+
+			cell_size_ = cell_size;
+		}
+
+		//! Destructor
+		~SpatialGrid() {
+		}
+
+		//! Returns the number of entries in the grid
+		size_type size() const {
+			return records_.size();
+		}
+
+		//! Returns whether the grid is empty or not
+		bool empty() const {
+			return records_.empty();
+		}
+
+		//! Returns the number of non-empty cells in the grid
+		size_type cell_count() const {
+			return cells_.size();
+		}
+
+		//! Removes every entry from the grid
+		void clear() {
+			cells_.clear();
+			records_.clear();
+		}
+
+		/*!
+			Inserts an entry into the grid, or moves it if the id is already present
+		\param id Unique id of the entry
+		\param v Value to store
+		\param x X position of the entry
+		\param y Y position of the entry
+		*/
+		void insert(const key_type& id, const_reference v, float x, float y) {
+			erase(id);
+
+			Record r;
+			r.cell = CellFor(x, y);
+			r.value = v;
+			records_[id] = r;
+
+			Entry e;
+			e.id = id;
+			e.value = v;
+			cells_[r.cell].push_back(e);
+		}
+
+		/*!
+			Updates the position of an entry already in the grid, returns false if the id is unknown
+		\param id Unique id of the entry
+		\param x New x position of the entry
+		\param y New y position of the entry
+		*/
+		bool update(const key_type& id, float x, float y) {
+			auto iter = records_.find(id);
+			if(iter == records_.end()) {
+				return false;
+			}
+
+			cell_type cell = CellFor(x, y);
+			if(cell == iter->second.cell) {
+				return true;
+			}
+
+			RemoveFromCell(iter->second.cell, id);
+			iter->second.cell = cell;
+
+			Entry e;
+			e.id = id;
+			e.value = iter->second.value;
+			cells_[cell].push_back(e);
+			return true;
+		}
+
+		/*!
+			Removes an entry from the grid, returns false if the id is unknown
+		\param id Unique id of the entry
+		*/
+		bool erase(const key_type& id) {
+			auto iter = records_.find(id);
+			if(iter == records_.end()) {
+				return false;
+			}
+
+			RemoveFromCell(iter->second.cell, id);
+			records_.erase(iter);
+			return true;
+		}
+
+		/*!
+			Checks if there is an entry with the given id in the grid
+		\param id Unique id to check for
+		*/
+		bool exists(const key_type& id) const {
+			return records_.count(id) != 0;
+		}
+
+		/*!
+			Appends every entry in a cell overlapping the square of half width range around x, y
+		\param x X position of the center of the query
+		\param y Y position of the center of the query
+		\param range Half width of the query square, negative ranges match nothing
+		\param out Vector the matching values are appended to
+		*/
+		void query(float x, float y, float range, std::vector<value_type> &out) const {
+			if(range < 0.0f || records_.empty()) {
+				return;
+			}
+
+			int32 min_x = CellCoord(x - range);
+			int32 max_x = CellCoord(x + range);
+			int32 min_y = CellCoord(y - range);
+			int32 max_y = CellCoord(y + range);
+
+			// a query covering more cells than are populated is cheaper as a walk of the populated ones
+			uint64 span = (uint64)(max_x - min_x + 1) * (uint64)(max_y - min_y + 1);
+			if(span > cells_.size()) {
+				auto iter = cells_.begin();
+				while(iter != cells_.end()) {
+					int32 cx = (int32)(uint32)(iter->first >> 32);
+					int32 cy = (int32)(uint32)(iter->first & 0xFFFFFFFFU);
+					if(cx >= min_x && cx <= max_x && cy >= min_y && cy <= max_y) {
+						AppendCell(iter->second, out);
+					}
+					++iter;
+				}
+				return;
+			}
+
+			for(int32 cx = min_x; cx <= max_x; ++cx) {
+				for(int32 cy = min_y; cy <= max_y; ++cy) {
+					auto iter = cells_.find(MakeCell(cx, cy));
+					if(iter != cells_.end()) {
+						AppendCell(iter->second, out);
+					}
+				}
+			}
+		}
+
+	private:
+		int32 CellCoord(float v) const {
+			float c = floorf(v / cell_size_);
+			// keeps garbage coordinates from overflowing the cast below
+			if(!(c > -1048576.0f)) {
+				return -1048576;
+			}
+
+			if(c > 1048576.0f) {
+				return 1048576;
+			}
+
+			return (int32)c;
+		}
+
+		static cell_type MakeCell(int32 cx, int32 cy) {
+			return ((cell_type)(uint32)cx << 32) | (cell_type)(uint32)cy;
+		}
+
+		cell_type CellFor(float x, float y) const {
+			return MakeCell(CellCoord(x), CellCoord(y));
+		}
+
+		static void AppendCell(const std::vector<Entry> &cell, std::vector<value_type> &out) {
+			auto iter = cell.begin();
+			while(iter != cell.end()) {
+				out.push_back(iter->value);
+				++iter;
+			}
+		}
+
+		void RemoveFromCell(cell_type cell, const key_type& id) {
+			auto iter = cells_.find(cell);
+			if(iter == cells_.end()) {
+				return;
+			}
+
+			std::vector<Entry> &entries = iter->second;
+			for(size_type i = 0; i < entries.size(); ++i) {
+				if(entries[i].id == id) {
+					entries[i] = entries.back();
+					entries.pop_back();
+					break;
+				}
+			}
+
+			if(entries.empty()) {
+				cells_.erase(iter);
+			}
+		}
+
+		float cell_size_;
+		std::unordered_map<cell_type, std::vector<Entry> > cells_;
+		std::unordered_map<key_type, Record> records_;
+	};
+} // EQEmu
+
+#endif
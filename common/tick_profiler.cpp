@@ -0,0 +1,119 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "debug.h"
+#include "tick_profiler.h"
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static const char *TickSectionNames[TickSectionCount] = {
+	"total",
+	"world",
+	"streams",
+	"entity",
+	"mobs",
+	"zone",
+	"quests",
+	"dbasync"
+};
+
+TickProfiler::TickProfiler()
+:	m_next(0),
+	m_count(0),
+	m_budget(0),
+	m_over_budget(0)
+{
+	memset(m_current, 0, sizeof(m_current));
+	memset(m_samples, 0, sizeof(m_samples));
+}
+
+uint64 TickProfiler::Now() {
+#ifdef _WINDOWS
+	static LARGE_INTEGER freq = { 0 };
+	if(freq.QuadPart == 0)
+		QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return((uint64)(now.QuadPart / freq.QuadPart) * 1000000 + (uint64)(now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+#endif
+}
+
+const char *TickProfiler::SectionName(int section) {
+	if(section < 0 || section >= TickSectionCount)
+		return("unknown");
+	return(TickSectionNames[section]);
+}
+
+uint32 TickProfiler::EndTick() {
+	uint64 total = 0;
+	for(int i = TickSectionTotal + 1; i < TickSectionCount; i++)
+		total += m_current[i];
+	m_current[TickSectionTotal] = total;
+
+	for(int i = 0; i < TickSectionCount; i++) {
+		m_samples[i][m_next] = m_current[i] > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32)m_current[i];
+		m_current[i] = 0;
+	}
+
+	uint32 res = m_samples[TickSectionTotal][m_next];
+	m_next = (m_next + 1) % TICK_PROFILER_WINDOW;
+	if(m_count < TICK_PROFILER_WINDOW)
+		m_count++;
+
+	if(m_budget != 0 && res > m_budget)
+		m_over_budget++;
+	return(res);
+}
+
+void TickProfiler::DiscardCurrent() {
+	memset(m_current, 0, sizeof(m_current));
+}
+
+void TickProfiler::Summarize(TickSection section, TickSectionSummary &out) const {
+	memset(&out, 0, sizeof(out));
+	if(m_count == 0 || section < 0 || section >= TickSectionCount)
+		return;
+
+	//the ring is only full once we have wrapped, before that the samples start at 0
+	std::vector<uint32> sorted(m_samples[section], m_samples[section] + m_count);
+	uint64 sum = 0;
+	for(uint32 i = 0; i < m_count; i++) {
+		sum += sorted[i];
+		if(sorted[i] > out.max)
+			out.max = sorted[i];
+	}
+	out.avg = (uint32)(sum / m_count);
+
+	std::vector<uint32>::iterator p50 = sorted.begin() + (m_count - 1) / 2;
+	std::nth_element(sorted.begin(), p50, sorted.end());
+	out.p50 = *p50;
+
+	std::vector<uint32>::iterator p99 = sorted.begin() + (size_t)(m_count - 1) * 99 / 100;
+	std::nth_element(sorted.begin(), p99, sorted.end());
+	out.p99 = *p99;
+}
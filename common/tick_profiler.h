@@ -0,0 +1,96 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include "types.h"
+
+//number of ticks kept for the rolling percentiles, about 40 seconds of a busy zone
+#define TICK_PROFILER_WINDOW 4096
+
+//the parts of the zone main loop that are timed, the order is also the wire order
+//of ServerZoneTickProfile_Struct so only ever add to the end (before TickSectionCount)
+enum TickSection {
+	TickSectionTotal = 0,
+	TickSectionWorld,			//worldserver.Process
+	TickSectionStreams,			//new streams, stream identification
+	TickSectionEntityProcess,	//entity_list.Process (clients) and the timed group/door/object/corpse/trap/raid passes
+	TickSectionMobProcess,		//entity_list.MobProcess
+	TickSectionZoneProcess,		//Zone::Process
+	TickSectionQuestTimers,		//quest_manager.Process
+	TickSectionDBAsync,			//finished DBAsync work dispatch
+	TickSectionCount
+};
+
+struct TickSectionSummary {
+	uint32 p50;		//microseconds
+	uint32 p99;
+	uint32 max;
+	uint32 avg;
+};
+
+/*
+	Always compiled, low overhead timing of the zone main loop. Time spent in each section
+	is accumulated until EndTick(), which stores one sample per section for that tick in a
+	ring of the last TICK_PROFILER_WINDOW ticks. Sections that run on every loop pass (world,
+	streams, dbasync) are charged to the next tick, so a tick's total is the work done for
+	that whole update interval. Percentiles are only worked out when a
+	summary is asked for, so the per tick cost is two clock reads per section.
+*/
+class TickProfiler {
+public:
+	TickProfiler();
+
+	//monotonic microsecond clock
+	static uint64 Now();
+	static const char *SectionName(int section);
+
+	void Add(TickSection section, uint64 usec) { m_current[section] += usec; }
+	//stores the accumulated section times as one tick, returns the tick's total time in usec
+	uint32 EndTick();
+	//drops the time accumulated since the last tick, for loop passes with no zone loaded
+	void DiscardCurrent();
+
+	void Summarize(TickSection section, TickSectionSummary &out) const;
+	uint32 GetTickCount() const { return(m_count); }
+
+	//ticks whose total was over budget_usec since the last ResetOverBudget
+	void SetBudget(uint32 budget_usec) { m_budget = budget_usec; }
+	uint32 GetOverBudget() const { return(m_over_budget); }
+	void ResetOverBudget() { m_over_budget = 0; }
+
+	class Scope {
+	public:
+		Scope(TickProfiler &p, TickSection section) : m_profiler(p), m_section(section), m_start(Now()) { }
+		~Scope() { m_profiler.Add(m_section, Now() - m_start); }
+	private:
+		TickProfiler &m_profiler;
+		TickSection m_section;
+		uint64 m_start;
+	};
+
+protected:
+	uint64 m_current[TickSectionCount];
+	uint32 m_samples[TickSectionCount][TICK_PROFILER_WINDOW];
+	uint32 m_next;
+	uint32 m_count;
+	uint32 m_budget;
+	uint32 m_over_budget;
+};
+
+#endif /*TICK_PROFILER_H*/
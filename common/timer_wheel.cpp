@@ -0,0 +1,208 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "debug.h"
+#include "timer_wheel.h"
+
+TimerWheel::Entry::Entry()
+:	prev(nullptr),
+	next(nullptr),
+	wheel(nullptr),
+	expiry(0)
+{
+}
+
+TimerWheel::Entry::~Entry() {
+	if(wheel)
+		wheel->Cancel(this);
+}
+
+uint32 TimerWheel::Entry::GetRemainingTime() const {
+	if(!wheel)
+		return(0xFFFFFFFF);
+	return(expiry - wheel->GetTime());
+}
+
+void TimerWheel::Entry::Unlink() {
+	if(next) {
+		prev->next = next;
+		next->prev = prev;
+	}
+	prev = nullptr;
+	next = nullptr;
+}
+
+TimerWheel::TimerWheel(uint32 now)
+:	current(now),
+	count(0)
+{
+	for(int level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+		for(int slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot)
+			InitList(&slots[level][slot]);
+	}
+}
+
+TimerWheel::~TimerWheel() {
+	for(int level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+		for(int slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot) {
+			Entry *head = &slots[level][slot];
+			while(head->next != head) {
+				Entry *e = head->next;
+				e->Unlink();
+				e->wheel = nullptr;
+			}
+			//so the heads' own destructors have nothing to do
+			head->next = nullptr;
+			head->prev = nullptr;
+		}
+	}
+}
+
+void TimerWheel::InitList(Entry *head) {
+	head->prev = head;
+	head->next = head;
+}
+
+void TimerWheel::PushBack(Entry *head, Entry *e) {
+	e->prev = head->prev;
+	e->next = head;
+	head->prev->next = e;
+	head->prev = e;
+}
+
+void TimerWheel::Schedule(Entry *e, uint32 delay) {
+	if(e == nullptr)
+		return;
+
+	Cancel(e);
+
+	//the slot for the current time has already run
+	if(delay == 0)
+		delay = 1;
+	//anything further out than this would read as already past
+	if(delay > 0x7FFFFFFF)
+		delay = 0x7FFFFFFF;
+
+	e->expiry = current + delay;
+	e->wheel = this;
+	++count;
+	Place(e);
+}
+
+void TimerWheel::Cancel(Entry *e) {
+	if(e == nullptr || e->wheel == nullptr)
+		return;
+
+	e->Unlink();
+	e->wheel = nullptr;
+	--count;
+}
+
+//puts e in the slot of the coarsest level that still resolves its expiry
+void TimerWheel::Place(Entry *e) {
+	uint32 delta = e->expiry - current;
+	uint32 expiry = e->expiry;
+	if(delta >= TIMER_WHEEL_SPAN) {
+		//past the end of the wheel (or wrapped around into the past when cascading)
+		if(delta & 0x80000000) {
+			PushBack(&slots[0][current & TIMER_WHEEL_SLOT_MASK], e);
+			return;
+		}
+		expiry = current + TIMER_WHEEL_SPAN - 1;
+		delta = TIMER_WHEEL_SPAN - 1;
+	}
+
+	int level = 0;
+	while(level < TIMER_WHEEL_LEVELS - 1 && delta >= ((uint32)1 << (TIMER_WHEEL_SLOT_BITS * (level + 1))))
+		++level;
+
+	uint32 slot = (expiry >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+	PushBack(&slots[level][slot], e);
+}
+
+//moves everything in a coarse slot down to the levels that now resolve it
+void TimerWheel::Cascade(int level, uint32 slot) {
+	Entry *head = &slots[level][slot];
+	Head pending;
+	if(head->next == head)
+		return;
+
+	//splice the slot onto pending so placing entries back into this slot can't loop
+	pending.next = head->next;
+	pending.prev = head->prev;
+	pending.next->prev = &pending;
+	pending.prev->next = &pending;
+	InitList(head);
+
+	while(pending.next != &pending) {
+		Entry *e = pending.next;
+		e->Unlink();
+		Place(e);
+	}
+	pending.next = nullptr;
+	pending.prev = nullptr;
+}
+
+uint32 TimerWheel::Advance(uint32 now) {
+	uint32 fired = 0;
+	while(current != now) {
+		if(count == 0) {
+			//nothing to fire or cascade, skip straight to now
+			current = now;
+			break;
+		}
+
+		++current;
+
+		uint32 slot = current & TIMER_WHEEL_SLOT_MASK;
+		if(slot == 0) {
+			for(int level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+				uint32 index = (current >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+				Cascade(level, index);
+				if(index != 0)
+					break;
+			}
+		}
+
+		//pull the due entries off one at a time, Expired may cancel or reschedule
+		//any of the others
+		Entry *head = &slots[0][slot];
+		Head due;
+		if(head->next != head) {
+			due.next = head->next;
+			due.prev = head->prev;
+			due.next->prev = &due;
+			due.prev->next = &due;
+			InitList(head);
+		} else {
+			continue;
+		}
+
+		while(due.next != &due) {
+			Entry *e = due.next;
+			e->Unlink();
+			e->wheel = nullptr;
+			--count;
+			++fired;
+			e->Expired();
+		}
+		due.next = nullptr;
+		due.prev = nullptr;
+	}
+
+	return(fired);
+}
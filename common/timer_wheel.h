@@ -0,0 +1,122 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "types.h"
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+//furthest out a timer is placed directly, about four and a half hours. Longer ones are
+//parked at the far end and placed again as the wheel turns.
+#define TIMER_WHEEL_SPAN ((uint32)1 << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+
+/*
+	Hierarchical timer wheel with millisecond slots. Instead of every owner polling its
+	Timers each loop, owners schedule an entry and Advance only touches the entries that
+	are due, plus a cascade of the next coarser level's slot every 64ms.
+
+	Entries are intrusive so scheduling never allocates, and they unlink themselves when
+	destroyed so an owner going away with a pending entry is safe. Expired is called with
+	the entry already unscheduled; it may schedule itself again, schedule or cancel any
+	other entry, or destroy its owner.
+*/
+class TimerWheel
+{
+public:
+	class Entry
+	{
+	public:
+		Entry();
+		virtual ~Entry();
+
+		inline bool Scheduled() const { return(wheel != nullptr); }
+		//wheel time the entry fires at, only meaningful while scheduled
+		inline uint32 GetExpiry() const { return(expiry); }
+		uint32 GetRemainingTime() const;
+
+	protected:
+		virtual void Expired() = 0;
+
+	private:
+		Entry(const Entry &);
+		Entry &operator=(const Entry &);
+
+		void Unlink();
+
+		Entry *prev;
+		Entry *next;
+		TimerWheel *wheel;
+		uint32 expiry;
+
+		friend class TimerWheel;
+	};
+
+	//calls a member function of its owner when it fires
+	template<class T>
+	class Callback : public Entry
+	{
+	public:
+		typedef void (T::*Function)();
+		Callback(T *owner, Function function) : owner(owner), function(function) { }
+
+	protected:
+		virtual void Expired() { (owner->*function)(); }
+
+	private:
+		T *owner;
+		Function function;
+	};
+
+	TimerWheel(uint32 now = 0);
+	~TimerWheel();
+
+	//(re)schedules e to fire delay ms from the wheel's current time, a delay of 0 fires
+	//on the next Advance that moves time forward
+	void Schedule(Entry *e, uint32 delay);
+	void Cancel(Entry *e);
+
+	//moves the wheel up to now, firing everything due on the way, returns how many fired
+	uint32 Advance(uint32 now);
+
+	inline uint32 GetTime() const { return(current); }
+	inline uint32 GetScheduledCount() const { return(count); }
+
+private:
+	TimerWheel(const TimerWheel &);
+	TimerWheel &operator=(const TimerWheel &);
+
+	void Place(Entry *e);
+	void Cascade(int level, uint32 slot);
+	static void InitList(Entry *head);
+	static void PushBack(Entry *head, Entry *e);
+
+	uint32 current;
+	uint32 count;
+	//list heads, only their prev/next are used
+	struct Head : public Entry
+	{
+	protected:
+		virtual void Expired() { }
+	};
+	Head slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
+#endif
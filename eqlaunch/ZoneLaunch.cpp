@@ -43,7 +43,8 @@ const char *zone_name, const EQEmuConfig *config)
 	m_timer(config->RestartWait),
 	m_ref(ProcLauncher::ProcError),
 	m_startCount(0),
-	m_killFails(0)
+	m_killFails(0),
+	m_warmReady(false)
 {
 	//trigger the startup timer initially so it boots the first time.
 	m_timer.Trigger();
@@ -55,6 +56,9 @@ ZoneLaunch::~ZoneLaunch() {
 }
 
 void ZoneLaunch::SendStatus() const {
+	//world only learns about warm zones when they are attached
+	if(IsWarm())
+		return;
 	m_world->SendStatus(m_zone.c_str(), m_startCount, IsRunning());
 }
 
@@ -81,12 +85,33 @@ void ZoneLaunch::Start() {
 	m_state = StateStarted;
 	s_running++;
 	m_killFails = 0;
+	m_warmReady = false;
 
 	SendStatus();
 
 	_log(LAUNCHER__STATUS, "Zone %s has been started.", m_zone.c_str());
 }
 
+//takes over warm's running process, warm is left stopped so it gets removed
+void ZoneLaunch::Attach(ZoneLaunch *warm) {
+	m_ref = warm->m_ref;
+	ProcLauncher::get()->SetHandler(m_ref, this);
+
+	//the process, and its place in s_running, move over to us
+	warm->m_ref = ProcLauncher::ProcError;
+	warm->m_state = StateStopped;
+	warm->m_warmReady = false;
+
+	m_startCount++;
+	m_state = StateStarted;
+	m_killFails = 0;
+
+	m_world->SendAttach(warm->GetZone(), m_zone.c_str());
+	SendStatus();
+
+	_log(LAUNCHER__STATUS, "Zone %s has been attached to warm process %s.", m_zone.c_str(), warm->GetZone());
+}
+
 void ZoneLaunch::Restart() {
 	switch(m_state) {
 	case StateRestartPending:
@@ -153,6 +178,17 @@ bool ZoneLaunch::Process() {
 	switch(m_state) {
 	case StateStartPending:
 		if(m_timer.Check(false)) {
+			//a static zone takes a warm process if there is one, without waiting on
+			//the shared timer since nothing new is being started.
+			if(!IsWarm() && m_zone.compare(0, 8, "dynamic_") != 0) {
+				ZoneLaunch *warm = m_world->FindWarmZone();
+				if(warm != nullptr) {
+					m_timer.Disable();
+					Attach(warm);
+					break;
+				}
+			}
+
 			//our internal timer says its time to start. Check with the shared timer.
 			if(!s_startTimer.Check(false)) {
 				//we have to wait on the shared timer now..
@@ -41,6 +41,12 @@ public:
 	const char *GetZone() const { return(m_zone.c_str()); }
 	uint32 GetStartCount() const { return(m_startCount); }
 
+	//warm zones are idle processes which have done all their zone independent
+	//startup, a static zone attaches to one instead of starting a process of its own.
+	bool IsWarm() const { return(m_zone.compare(0, 5, "warm_") == 0); }
+	bool IsWarmReady() const { return(IsWarm() && m_warmReady && m_state == StateStarted); }
+	void SetWarmReady() { m_warmReady = true; }
+
 	//should only be called during process init to setup the start timer.
 	static void InitStartTimer();
 
@@ -48,6 +54,7 @@ protected:
 	bool IsRunning() const { return(m_state == StateStarted || m_state == StateStopPending || m_state == StateRestartPending); }
 
 	void Start();
+	void Attach(ZoneLaunch *warm);
 
 	void OnTerminate(const ProcLauncher::ProcRef &ref, const ProcLauncher::Spec *spec);
 
@@ -69,6 +76,7 @@ protected:
 	uint32 m_startCount;
 
 	uint32 m_killFails;
+	bool m_warmReady;	//world has seen our warm process connect
 
 private:
 	static int s_running;
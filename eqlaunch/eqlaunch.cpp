@@ -147,6 +147,28 @@ int main(int argc, char *argv[]) {
 			zones.erase(rem);
 		}
 
+		/*
+		* Keep the warm pool full, attached or dead ones are replaced here
+		*/
+		if(Config->PrewarmZones > 0) {
+			uint32 warm = 0;
+			zone = zones.begin();
+			zend = zones.end();
+			for(; zone != zend; ++zone) {
+				if(zone->second->IsWarm())
+					warm++;
+			}
+			char warm_name[16];
+			for(int index = 1; warm < Config->PrewarmZones && index < 100; index++) {
+				sprintf(warm_name, "warm_%02d", index);
+				if(zones.find(warm_name) != zones.end())
+					continue;
+				_log(LAUNCHER__STATUS, "Adding warm zone %s", warm_name);
+				zones[warm_name] = new ZoneLaunch(&world, launcher_name.c_str(), warm_name, Config);
+				warm++;
+			}
+		}
+
 
 		if (InterserverTimer.Check()) {
 			if (world.TryReconnect() && (!world.Connected()))
@@ -117,6 +117,16 @@ void WorldServer::Process() {
 				}
 				break;
 			}
+			case ZR_WarmReady: {
+				std::map<std::string, ZoneLaunch *>::iterator res = m_zones.find(lzr->short_name);
+				if(res == m_zones.end() || !res->second->IsWarm()) {
+					_log(LAUNCHER__ERROR, "World told us warm zone %s is ready, but we do not have it.", lzr->short_name);
+				} else {
+					_log(LAUNCHER__WORLD, "Warm zone %s is ready.", lzr->short_name);
+					res->second->SetWarmReady();
+				}
+				break;
+			}
 			}
 			break;
 		}
@@ -136,6 +146,32 @@ void WorldServer::Process() {
 
 
 
+void WorldServer::SendAttach(const char *warm_name, const char *short_name) {
+	ServerPacket* pack = new ServerPacket(ServerOP_LauncherZoneAttach, sizeof(LauncherZoneAttach));
+	LauncherZoneAttach* it =(LauncherZoneAttach*) pack->pBuffer;
+
+	strn0cpy(it->warm_name, warm_name, 33);
+	strn0cpy(it->short_name, short_name, 33);
+
+	SendPacket(pack);
+	safe_delete(pack);
+}
+
+ZoneLaunch *WorldServer::FindWarmZone() {
+	//world has to be there to boot the zone on it
+	if(!Connected())
+		return(nullptr);
+
+	std::map<std::string, ZoneLaunch *>::iterator cur, end;
+	cur = m_zones.begin();
+	end = m_zones.end();
+	for(; cur != end; ++cur) {
+		if(cur->second->IsWarmReady())
+			return(cur->second);
+	}
+	return(nullptr);
+}
+
 void WorldServer::SendStatus(const char *short_name, uint32 start_count, bool running) {
 	ServerPacket* pack = new ServerPacket(ServerOP_LauncherZoneStatus, sizeof(LauncherZoneStatus));
 	LauncherZoneStatus* it =(LauncherZoneStatus*) pack->pBuffer;
@@ -34,6 +34,10 @@ public:
 	virtual void Process();
 
 	void SendStatus(const char *short_name, uint32 start_count, bool running);
+	void SendAttach(const char *warm_name, const char *short_name);
+
+	//a warm zone ready to be attached, nullptr if none
+	ZoneLaunch *FindWarmZone();
 
 private:
 	virtual void OnConnected();
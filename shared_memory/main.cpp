@@ -26,6 +26,7 @@
 #include "../common/eqemu_exception.h"
 #include "items.h"
 #include "npc_faction.h"
+#include "npc_types.h"
 #include "loot.h"
 #include "skill_caps.h"
 #include "spells.h"
@@ -68,6 +69,7 @@ int main(int argc, char **argv) {
 	bool load_skill_caps = false;
 	bool load_spells = false;
 	bool load_bd = false;
+	bool load_npc_types = false;
 	if(argc > 1) {
 		load_all = false;
 
@@ -103,6 +105,12 @@ int main(int argc, char **argv) {
 				}
 				break;
 
+			case 'n':
+				if(strcasecmp("npc_types", argv[i]) == 0) {
+					load_npc_types = true;
+				}
+				break;
+
 			case 's':
 				if(strcasecmp("skill_caps", argv[i]) == 0) {
 					load_skill_caps = true;
@@ -164,6 +172,16 @@ int main(int argc, char **argv) {
 		}
 	}
 
+	if(load_all || load_npc_types) {
+		LogFile->write(EQEMuLog::Status, "Loading npc types...");
+		try {
+			LoadNPCTypes(&database);
+		} catch(std::exception &ex) {
+			LogFile->write(EQEMuLog::Error, "%s", ex.what());
+			return 1;
+		}
+	}
+
 	if(load_all || load_bd) {
 		LogFile->write(EQEMuLog::Status, "Loading base data...");
 		try {
@@ -0,0 +1,45 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "npc_types.h"
+#include "../common/debug.h"
+#include "../common/shareddb.h"
+#include "../common/ipc_mutex.h"
+#include "../common/memory_mapped_file.h"
+#include "../common/eqemu_exception.h"
+#include "../common/npc_type.h"
+
+void LoadNPCTypes(SharedDatabase *database) {
+	EQEmu::IPCMutex mutex("npc_types");
+	mutex.Lock();
+
+	int32 npc_types = -1;
+	uint32 max_npc_type = 0;
+	database->GetNPCTypesCount(npc_types, max_npc_type);
+	if(npc_types == -1) {
+		EQ_EXCEPT("Shared Memory", "Unable to get any npc types from the database.");
+	}
+
+	uint32 size = static_cast<uint32>(EQEmu::FixedMemoryHashSet<NPCType>::estimated_size(npc_types, max_npc_type));
+	EQEmu::MemoryMappedFile mmf("shared/npc_types", size);
+	mmf.ZeroFile();
+
+	void *ptr = mmf.Get();
+	database->LoadNPCTypes(ptr, size, npc_types, max_npc_type);
+	mutex.Unlock();
+}
@@ -26,6 +26,8 @@
 #include "fixed_memory_variable_test.h"
 #include "atobool_test.h"
 #include "hextoi_32_64_test.h"
+#include "spatial_grid_test.h"
+#include "timer_wheel_test.h"
 
 int main() {
 	try {
@@ -38,6 +40,8 @@ int main() {
 		tests.add(new FixedMemoryVariableHashTest());
 		tests.add(new atoboolTest());
 		tests.add(new hextoi_32_64_Test());
+		tests.add(new SpatialGridTest());
+		tests.add(new TimerWheelTest());
 		tests.run(*output, true);
 	} catch(...) {
 		return -1;
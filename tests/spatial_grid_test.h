@@ -0,0 +1,206 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SPATIAL_GRID_H
+#define __EQEMU_TESTS_SPATIAL_GRID_H
+
+#include <algorithm>
+#include <vector>
+#include "cppunit/cpptest.h"
+#include "../common/spatial_grid.h"
+
+/*
+	The synthetic zone is roughly a busy outdoor zone: 600 npcs and 80 clients spread over
+	a 6000x6000 area. The same set of 200 unit radius queries (the
+	QueueCloseClients / aggro pattern) is run once as a full scan and once through the grid,
+	and both have to find the same entities.
+*/
+#define SPATIAL_GRID_TEST_ENTITIES 680
+#define SPATIAL_GRID_TEST_QUERIES 2000
+
+class SpatialGridTest : public Test::Suite {
+	typedef void(SpatialGridTest::*TestFunction)(void);
+
+	struct TestEntity {
+		uint32 id;
+		float x;
+		float y;
+	};
+public:
+	SpatialGridTest() {
+		// simple lcg so runs are repeatable
+		uint32 seed = 12345;
+		for(uint32 i = 0; i < SPATIAL_GRID_TEST_ENTITIES; ++i) {
+			TestEntity e;
+			e.id = i + 1;
+			e.x = NextCoord(seed);
+			e.y = NextCoord(seed);
+			entities_.push_back(e);
+			zone_.insert(e.id, e.id, e.x, e.y);
+		}
+
+		for(uint32 i = 0; i < SPATIAL_GRID_TEST_QUERIES; ++i) {
+			TestEntity q;
+			q.id = 0;
+			q.x = NextCoord(seed);
+			q.y = NextCoord(seed);
+			queries_.push_back(q);
+		}
+
+		TEST_ADD(SpatialGridTest::InsertQueryTest);
+		TEST_ADD(SpatialGridTest::UpdateTest);
+		TEST_ADD(SpatialGridTest::EraseTest);
+		TEST_ADD(SpatialGridTest::NegativeCoordTest);
+		TEST_ADD(SpatialGridTest::LargeRangeTest);
+		TEST_ADD(SpatialGridTest::SyntheticZoneTest);
+		TEST_ADD(SpatialGridTest::ScanMatchTest);
+	}
+
+	~SpatialGridTest() {
+	}
+
+	private:
+	static float NextCoord(uint32 &seed) {
+		seed = seed * 1103515245U + 12345U;
+		return (float)((seed >> 8) % 6000) - 3000.0f;
+	}
+
+	static bool Contains(const std::vector<uint32> &v, uint32 id) {
+		return std::find(v.begin(), v.end(), id) != v.end();
+	}
+
+	void InsertQueryTest() {
+		EQEmu::SpatialGrid<uint32> grid(100.0f);
+		grid.insert(1, 1, 10.0f, 10.0f);
+		grid.insert(2, 2, 500.0f, 500.0f);
+		TEST_ASSERT(grid.size() == 2);
+		TEST_ASSERT(grid.exists(1));
+
+		std::vector<uint32> res;
+		grid.query(0.0f, 0.0f, 50.0f, res);
+		TEST_ASSERT(Contains(res, 1));
+		TEST_ASSERT(!Contains(res, 2));
+	}
+
+	void UpdateTest() {
+		EQEmu::SpatialGrid<uint32> grid(100.0f);
+		grid.insert(1, 1, 10.0f, 10.0f);
+		TEST_ASSERT(grid.update(1, 1010.0f, 1010.0f));
+		TEST_ASSERT(!grid.update(2, 0.0f, 0.0f));
+
+		std::vector<uint32> res;
+		grid.query(0.0f, 0.0f, 50.0f, res);
+		TEST_ASSERT(res.empty());
+
+		grid.query(1000.0f, 1000.0f, 50.0f, res);
+		TEST_ASSERT(res.size() == 1 && res[0] == 1);
+		TEST_ASSERT(grid.cell_count() == 1);
+	}
+
+	void EraseTest() {
+		EQEmu::SpatialGrid<uint32> grid(100.0f);
+		grid.insert(1, 1, 10.0f, 10.0f);
+		grid.insert(2, 2, 20.0f, 20.0f);
+		TEST_ASSERT(grid.erase(1));
+		TEST_ASSERT(!grid.erase(1));
+		TEST_ASSERT(!grid.exists(1));
+
+		std::vector<uint32> res;
+		grid.query(0.0f, 0.0f, 50.0f, res);
+		TEST_ASSERT(res.size() == 1 && res[0] == 2);
+
+		grid.clear();
+		TEST_ASSERT(grid.empty());
+		TEST_ASSERT(grid.cell_count() == 0);
+	}
+
+	void NegativeCoordTest() {
+		EQEmu::SpatialGrid<uint32> grid(100.0f);
+		grid.insert(1, 1, -5.0f, -5.0f);
+		grid.insert(2, 2, 5.0f, 5.0f);
+
+		std::vector<uint32> res;
+		grid.query(-1.0f, -1.0f, 10.0f, res);
+		TEST_ASSERT(Contains(res, 1));
+		TEST_ASSERT(Contains(res, 2));
+
+		res.clear();
+		grid.query(-1.0f, -1.0f, -1.0f, res);
+		TEST_ASSERT(res.empty());
+	}
+
+	void LargeRangeTest() {
+		EQEmu::SpatialGrid<uint32> grid(10.0f);
+		grid.insert(1, 1, -30000.0f, 30000.0f);
+		grid.insert(2, 2, 30000.0f, -30000.0f);
+
+		std::vector<uint32> res;
+		grid.query(0.0f, 0.0f, 100000.0f, res);
+		TEST_ASSERT(res.size() == 2);
+	}
+
+	void SyntheticZoneTest() {
+		for(size_t i = 0; i < queries_.size(); ++i) {
+			std::vector<uint32> res;
+			zone_.query(queries_[i].x, queries_[i].y, 200.0f, res);
+
+			for(size_t j = 0; j < entities_.size(); ++j) {
+				if(Dist2(entities_[j], queries_[i]) <= 200.0f * 200.0f) {
+					TEST_ASSERT(Contains(res, entities_[j].id));
+				}
+			}
+		}
+	}
+
+	void ScanMatchTest() {
+		uint32 scan_found = 0;
+		for(size_t i = 0; i < queries_.size(); ++i) {
+			for(size_t j = 0; j < entities_.size(); ++j) {
+				if(Dist2(entities_[j], queries_[i]) <= 200.0f * 200.0f) {
+					++scan_found;
+				}
+			}
+		}
+
+		uint32 grid_found = 0;
+		std::vector<uint32> res;
+		for(size_t i = 0; i < queries_.size(); ++i) {
+			res.clear();
+			zone_.query(queries_[i].x, queries_[i].y, 200.0f, res);
+			for(size_t j = 0; j < res.size(); ++j) {
+				if(Dist2(entities_[res[j] - 1], queries_[i]) <= 200.0f * 200.0f) {
+					++grid_found;
+				}
+			}
+		}
+
+		TEST_ASSERT(scan_found == grid_found);
+	}
+
+	static float Dist2(const TestEntity &a, const TestEntity &b) {
+		float dx = a.x - b.x;
+		float dy = a.y - b.y;
+		return dx * dx + dy * dy;
+	}
+
+	std::vector<TestEntity> entities_;
+	std::vector<TestEntity> queries_;
+	EQEmu::SpatialGrid<uint32> zone_;
+};
+
+#endif
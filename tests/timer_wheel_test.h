@@ -0,0 +1,201 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_TIMER_WHEEL_H
+#define __EQEMU_TESTS_TIMER_WHEEL_H
+
+#include <vector>
+#include "cppunit/cpptest.h"
+#include "../common/timer_wheel.h"
+
+class TimerWheelTest : public Test::Suite {
+	typedef void(TimerWheelTest::*TestFunction)(void);
+
+	// records the wheel time it fired at, optionally scheduling itself again
+	class TestEntry : public TimerWheel::Entry {
+	public:
+		TestEntry() : wheel_(nullptr), fired_at_(0), fire_count_(0), repeat_(0), victim_(nullptr) { }
+
+		TimerWheel *wheel_;
+		uint32 fired_at_;
+		uint32 fire_count_;
+		uint32 repeat_;
+		TimerWheel::Entry *victim_;
+
+	protected:
+		virtual void Expired() {
+			fired_at_ = wheel_->GetTime();
+			++fire_count_;
+			if(victim_) {
+				wheel_->Cancel(victim_);
+			}
+
+			if(repeat_) {
+				wheel_->Schedule(this, repeat_);
+			}
+		}
+	};
+public:
+	TimerWheelTest() {
+		TEST_ADD(TimerWheelTest::FireTimeTest);
+		TEST_ADD(TimerWheelTest::LevelsTest);
+		TEST_ADD(TimerWheelTest::CancelTest);
+		TEST_ADD(TimerWheelTest::RepeatTest);
+		TEST_ADD(TimerWheelTest::DestroyTest);
+		TEST_ADD(TimerWheelTest::BeyondSpanTest);
+		TEST_ADD(TimerWheelTest::CancelFromCallbackTest);
+	}
+
+	~TimerWheelTest() {
+	}
+
+	private:
+	void FireTimeTest() {
+		TimerWheel wheel(1000);
+		TestEntry e;
+		e.wheel_ = &wheel;
+		wheel.Schedule(&e, 10);
+		TEST_ASSERT(e.Scheduled());
+		TEST_ASSERT(e.GetRemainingTime() == 10);
+
+		TEST_ASSERT(wheel.Advance(1009) == 0);
+		TEST_ASSERT(wheel.Advance(1010) == 1);
+		TEST_ASSERT(e.fired_at_ == 1010);
+		TEST_ASSERT(!e.Scheduled());
+		TEST_ASSERT(wheel.GetScheduledCount() == 0);
+	}
+
+	void LevelsTest() {
+		// delays on every level, advanced in uneven steps, each must fire on its exact ms
+		TimerWheel wheel(12345);
+		std::vector<TestEntry> entries(500);
+		uint32 seed = 7;
+		for(size_t i = 0; i < entries.size(); ++i) {
+			seed = seed * 1103515245U + 12345U;
+			uint32 delay = 1 + (seed >> 8) % (i < 250 ? 5000 : 3000000);
+			entries[i].wheel_ = &wheel;
+			wheel.Schedule(&entries[i], delay);
+			entries[i].repeat_ = delay; // reused to hold the expected time below
+		}
+
+		for(size_t i = 0; i < entries.size(); ++i) {
+			entries[i].repeat_ += 12345;
+		}
+
+		// repeat_ is the expected fire time now, don't let the callback reschedule
+		std::vector<uint32> expected(entries.size());
+		for(size_t i = 0; i < entries.size(); ++i) {
+			expected[i] = entries[i].repeat_;
+			entries[i].repeat_ = 0;
+		}
+
+		uint32 now = 12345;
+		while(wheel.GetScheduledCount() > 0) {
+			now += 1 + (now % 97);
+			wheel.Advance(now);
+		}
+
+		for(size_t i = 0; i < entries.size(); ++i) {
+			TEST_ASSERT(entries[i].fire_count_ == 1);
+			TEST_ASSERT(entries[i].fired_at_ == expected[i]);
+		}
+	}
+
+	void CancelTest() {
+		TimerWheel wheel;
+		TestEntry e;
+		e.wheel_ = &wheel;
+		wheel.Schedule(&e, 5000);
+		wheel.Advance(100);
+		wheel.Cancel(&e);
+		TEST_ASSERT(!e.Scheduled());
+		wheel.Advance(10000);
+		TEST_ASSERT(e.fire_count_ == 0);
+
+		// rescheduling replaces the old expiry
+		wheel.Schedule(&e, 50);
+		wheel.Schedule(&e, 500);
+		TEST_ASSERT(wheel.GetScheduledCount() == 1);
+		wheel.Advance(10100);
+		TEST_ASSERT(e.fire_count_ == 0);
+		wheel.Advance(10500);
+		TEST_ASSERT(e.fire_count_ == 1);
+	}
+
+	void RepeatTest() {
+		TimerWheel wheel;
+		TestEntry e;
+		e.wheel_ = &wheel;
+		e.repeat_ = 1000;
+		wheel.Schedule(&e, 1000);
+		wheel.Advance(60000);
+		TEST_ASSERT(e.fire_count_ == 60);
+		TEST_ASSERT(e.fired_at_ == 60000);
+		TEST_ASSERT(e.Scheduled());
+	}
+
+	void DestroyTest() {
+		TimerWheel wheel;
+		{
+			TestEntry e;
+			e.wheel_ = &wheel;
+			wheel.Schedule(&e, 100);
+		}
+		TEST_ASSERT(wheel.GetScheduledCount() == 0);
+		TEST_ASSERT(wheel.Advance(200) == 0);
+
+		// and the wheel going first leaves the entry unscheduled
+		TestEntry e;
+		{
+			TimerWheel temp;
+			e.wheel_ = &temp;
+			temp.Schedule(&e, 100);
+		}
+		TEST_ASSERT(!e.Scheduled());
+	}
+
+	void BeyondSpanTest() {
+		TimerWheel wheel;
+		TestEntry e;
+		e.wheel_ = &wheel;
+		uint32 delay = TIMER_WHEEL_SPAN * 3 + 17;
+		wheel.Schedule(&e, delay);
+		wheel.Advance(delay - 1);
+		TEST_ASSERT(e.fire_count_ == 0);
+		wheel.Advance(delay);
+		TEST_ASSERT(e.fire_count_ == 1);
+		TEST_ASSERT(e.fired_at_ == delay);
+	}
+
+	void CancelFromCallbackTest() {
+		TimerWheel wheel;
+		TestEntry a;
+		TestEntry b;
+		a.wheel_ = &wheel;
+		b.wheel_ = &wheel;
+		a.victim_ = &b;
+		b.victim_ = &a;
+		wheel.Schedule(&a, 10);
+		wheel.Schedule(&b, 10);
+		TEST_ASSERT(wheel.Advance(10) == 1);
+		TEST_ASSERT(a.fire_count_ + b.fire_count_ == 1);
+		TEST_ASSERT(wheel.GetScheduledCount() == 0);
+	}
+};
+
+#endif
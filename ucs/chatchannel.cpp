@@ -48,42 +48,37 @@ ChatChannel::ChatChannel(std::string inName, std::string inOwner, std::string in
 
 ChatChannel::~ChatChannel() {
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements())
-		iterator.RemoveCurrent(false);
+	ClientsInChannel.clear();
 }
 
 ChatChannel* ChatChannelList::CreateChannel(std::string Name, std::string Owner, std::string Password, bool Permanent, int MinimumStatus) {
 
-	ChatChannel *NewChannel = new ChatChannel(CapitaliseName(Name), Owner, Password, Permanent, MinimumStatus);
+	std::string NormalisedName = CapitaliseName(Name);
 
-	ChatChannels.Insert(NewChannel);
+	std::unordered_map<std::string, ChatChannel*>::iterator Iterator = ChatChannels.find(NormalisedName);
 
-	return NewChannel;
-}
+	if(Iterator != ChatChannels.end()) {
 
-ChatChannel* ChatChannelList::FindChannel(std::string Name) {
+		_log(UCS__ERROR, "Channel %s already exists, not creating it again.", NormalisedName.c_str());
 
-	std::string NormalisedName = CapitaliseName(Name);
+		return Iterator->second;
+	}
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
+	ChatChannel *NewChannel = new ChatChannel(NormalisedName, Owner, Password, Permanent, MinimumStatus);
 
-	iterator.Reset();
+	ChatChannels[NormalisedName] = NewChannel;
 
-	while(iterator.MoreElements()) {
+	return NewChannel;
+}
 
-		ChatChannel *CurrentChannel = iterator.GetData();
+ChatChannel* ChatChannelList::FindChannel(std::string Name) {
 
-		if(CurrentChannel && (CurrentChannel->Name == NormalisedName))
-			return iterator.GetData();
+	std::unordered_map<std::string, ChatChannel*>::iterator Iterator = ChatChannels.find(CapitaliseName(Name));
 
-		iterator.Advance();
-	}
+	if(Iterator == ChatChannels.end())
+		return nullptr;
 
-	return nullptr;
+	return Iterator->second;
 }
 
 void ChatChannelList::SendAllChannels(Client *c) {
@@ -99,24 +94,18 @@ void ChatChannelList::SendAllChannels(Client *c) {
 
 	int ChannelsInLine = 0;
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
-
-	iterator.Reset();
+	std::unordered_map<std::string, ChatChannel*>::iterator Iterator;
 
 	std::string Message;
 
 	char CountString[10];
 
-	while(iterator.MoreElements()) {
-
-		ChatChannel *CurrentChannel = iterator.GetData();
+	for(Iterator = ChatChannels.begin(); Iterator != ChatChannels.end(); ++Iterator) {
 
-		if(!CurrentChannel || (CurrentChannel->GetMinStatus() > c->GetAccountStatus())) {
-
-			iterator.Advance();
+		ChatChannel *CurrentChannel = Iterator->second;
 
+		if(!CurrentChannel || (CurrentChannel->GetMinStatus() > c->GetAccountStatus()))
 			continue;
-		}
 
 		if(ChannelsInLine > 0)
 			Message += ", ";
@@ -137,8 +126,6 @@ void ChatChannelList::SendAllChannels(Client *c) {
 
 			Message.clear();
 		}
-
-		iterator.Advance();
 	}
 
 	if(ChannelsInLine > 0)
@@ -148,53 +135,42 @@ void ChatChannelList::SendAllChannels(Client *c) {
 
 void ChatChannelList::RemoveChannel(ChatChannel *Channel) {
 
-	_log(UCS__TRACE, "RemoveChannel(%s)", Channel->GetName().c_str());
-
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
-
-	iterator.Reset();
+	if(!Channel) return;
 
-	while(iterator.MoreElements()) {
-
-		if(iterator.GetData() == Channel) {
+	_log(UCS__TRACE, "RemoveChannel(%s)", Channel->GetName().c_str());
 
-			iterator.RemoveCurrent();
+	std::unordered_map<std::string, ChatChannel*>::iterator Iterator = ChatChannels.find(Channel->Name);
 
-			return;
-		}
+	if((Iterator != ChatChannels.end()) && (Iterator->second == Channel))
+		ChatChannels.erase(Iterator);
 
-		iterator.Advance();
-	}
+	safe_delete(Channel);
 }
 
 void ChatChannelList::RemoveAllChannels() {
 
 	_log(UCS__TRACE, "RemoveAllChannels");
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
+	std::unordered_map<std::string, ChatChannel*>::iterator Iterator;
 
-	iterator.Reset();
+	for(Iterator = ChatChannels.begin(); Iterator != ChatChannels.end(); ++Iterator)
+		safe_delete(Iterator->second);
 
-	while(iterator.MoreElements())
-		iterator.RemoveCurrent();
+	ChatChannels.clear();
 }
 
 int ChatChannel::MemberCount(int Status) {
 
 	int Count = 0;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
+	std::unordered_set<Client*>::iterator Iterator;
 
-	while(iterator.MoreElements()) {
+	for(Iterator = ClientsInChannel.begin(); Iterator != ClientsInChannel.end(); ++Iterator) {
 
-		Client *ChannelClient = iterator.GetData();
+		Client *ChannelClient = (*Iterator);
 
 		if(ChannelClient && (!ChannelClient->GetHideMe() || (ChannelClient->GetAccountStatus() < Status)))
 			Count++;
-
-		iterator.Advance();
 	}
 
 	return Count;
@@ -238,22 +214,18 @@ void ChatChannel::AddClient(Client *c) {
 
 	_log(UCS__TRACE, "Adding %s to channel %s", c->GetName().c_str(), Name.c_str());
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
+	std::unordered_set<Client*>::iterator Iterator;
 
-	iterator.Reset();
+	for(Iterator = ClientsInChannel.begin(); Iterator != ClientsInChannel.end(); ++Iterator) {
 
-	while(iterator.MoreElements()) {
-
-		Client *CurrentClient = iterator.GetData();
+		Client *CurrentClient = (*Iterator);
 
 		if(CurrentClient && CurrentClient->IsAnnounceOn())
 			if(!HideMe || (CurrentClient->GetAccountStatus() > AccountStatus))
 				CurrentClient->AnnounceJoin(this, c);
-
-		iterator.Advance();
 	}
 
-	ClientsInChannel.Insert(c);
+	ClientsInChannel.insert(c);
 
 }
 
@@ -267,30 +239,19 @@ bool ChatChannel::RemoveClient(Client *c) {
 
 	int AccountStatus = c->GetAccountStatus();
 
-	int PlayersInChannel = 0;
-
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
+	ClientsInChannel.erase(c);
 
-	iterator.Reset();
+	int PlayersInChannel = ClientsInChannel.size();
 
-	while(iterator.MoreElements()) {
+	std::unordered_set<Client*>::iterator Iterator;
 
-		Client *CurrentClient = iterator.GetData();
+	for(Iterator = ClientsInChannel.begin(); Iterator != ClientsInChannel.end(); ++Iterator) {
 
-		if(CurrentClient == c) {
-			iterator.RemoveCurrent(false);
-		}
-		else if(CurrentClient) {
-
-			PlayersInChannel++;
-
-			if(CurrentClient->IsAnnounceOn())
-				if(!HideMe || (CurrentClient->GetAccountStatus() > AccountStatus))
-					CurrentClient->AnnounceLeave(this, c);
-
-			iterator.Advance();
-		}
+		Client *CurrentClient = (*Iterator);
 
+		if(CurrentClient && CurrentClient->IsAnnounceOn())
+			if(!HideMe || (CurrentClient->GetAccountStatus() > AccountStatus))
+				CurrentClient->AnnounceLeave(this, c);
 	}
 
 	if((PlayersInChannel == 0) && !Permanent) {
@@ -312,7 +273,7 @@ void ChatChannel::SendOPList(Client *c) {
 
 	c->GeneralChannelMessage("Channel " + Name + " op-list: (Owner=" + Owner + ")");
 
-	std::list<std::string>::iterator Iterator;
+	std::unordered_set<std::string>::iterator Iterator;
 
 	for(Iterator = Moderators.begin(); Iterator != Moderators.end(); ++Iterator)
 		c->GeneralChannelMessage((*Iterator));
@@ -341,20 +302,16 @@ void ChatChannel::SendChannelMembers(Client *c) {
 
 	int MembersInLine = 0;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
+	std::unordered_set<Client*>::iterator Iterator;
 
-	while(iterator.MoreElements()) {
+	for(Iterator = ClientsInChannel.begin(); Iterator != ClientsInChannel.end(); ++Iterator) {
 
-		Client *ChannelClient = iterator.GetData();
+		Client *ChannelClient = (*Iterator);
 
 		// Don't list hidden characters with status higher or equal than the character requesting the list.
 		//
-		if(!ChannelClient || (ChannelClient->GetHideMe() && (ChannelClient->GetAccountStatus() >= AccountStatus))) {
-			iterator.Advance();
+		if(!ChannelClient || (ChannelClient->GetHideMe() && (ChannelClient->GetAccountStatus() >= AccountStatus)))
 			continue;
-		}
 
 		if(MembersInLine > 0)
 			Message += ", ";
@@ -371,8 +328,6 @@ void ChatChannel::SendChannelMembers(Client *c) {
 
 			Message.clear();
 		}
-
-		iterator.Advance();
 	}
 
 	if(MembersInLine > 0)
@@ -386,36 +341,48 @@ void ChatChannel::SendMessageToChannel(std::string Message, Client* Sender) {
 
 	ChatMessagesSent++;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
+	// The message is encoded at most once for each client version, and the same packet is queued to every member
+	// on that version rather than each member building its own.
+	//
+	EQApplicationPacket *Packets[2] = { nullptr, nullptr };
 
-	iterator.Reset();
+	std::unordered_set<Client*>::iterator Iterator;
 
-	while(iterator.MoreElements()) {
+	for(Iterator = ClientsInChannel.begin(); Iterator != ClientsInChannel.end(); ++Iterator) {
 
-		Client *ChannelClient = iterator.GetData();
+		Client *ChannelClient = (*Iterator);
 
 		if(ChannelClient)
 		{
 			_log(UCS__TRACE, "Sending message to %s from %s",
 					ChannelClient->GetName().c_str(), Sender->GetName().c_str());
-			ChannelClient->SendChannelMessage(Name, Message, Sender);
-		}
 
-		iterator.Advance();
+			int Version = ChannelClient->IsUnderfootOrLater() ? 1 : 0;
+
+			if(!Packets[Version]) {
+
+				Packets[Version] = Client::MakeChannelMessagePacket(Name, Message, Sender, Version == 1);
+
+				_pkt(UCS__PACKETS, Packets[Version]);
+			}
+
+			ChannelClient->QueuePacket(Packets[Version]);
+		}
 	}
+
+	safe_delete(Packets[0]);
+	safe_delete(Packets[1]);
 }
 
 void ChatChannel::SetModerated(bool inModerated) {
 
 	Moderated = inModerated;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
+	std::unordered_set<Client*>::iterator Iterator;
 
-	iterator.Reset();
+	for(Iterator = ClientsInChannel.begin(); Iterator != ClientsInChannel.end(); ++Iterator) {
 
-	while(iterator.MoreElements()) {
-
-		Client *ChannelClient = iterator.GetData();
+		Client *ChannelClient = (*Iterator);
 
 		if(ChannelClient) {
 
@@ -424,8 +391,6 @@ void ChatChannel::SetModerated(bool inModerated) {
 			else
 				ChannelClient->GeneralChannelMessage("Channel " + Name + " is no longer moderated.");
 		}
-
-		iterator.Advance();
 	}
 
 }
@@ -433,19 +398,7 @@ bool ChatChannel::IsClientInChannel(Client *c) {
 
 	if(!c) return false;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
-
-		if(iterator.GetData() == c)
-			return true;
-
-		iterator.Advance();
-	}
-
-	return false;
+	return (ClientsInChannel.find(c) != ClientsInChannel.end());
 }
 
 ChatChannel *ChatChannelList::AddClientToChannel(std::string ChannelName, Client *c) {
@@ -544,32 +497,31 @@ ChatChannel *ChatChannelList::RemoveClientFromChannel(std::string inChannelName,
 
 void ChatChannelList::Process() {
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
-
-	iterator.Reset();
+	std::unordered_map<std::string, ChatChannel*>::iterator Iterator = ChatChannels.begin();
 
-	while(iterator.MoreElements()) {
+	while(Iterator != ChatChannels.end()) {
 
-		ChatChannel *CurrentChannel = iterator.GetData();
+		ChatChannel *CurrentChannel = Iterator->second;
 
 		if(CurrentChannel && CurrentChannel->ReadyToDelete()) {
 
 			_log(UCS__TRACE, "Empty temporary password protected channel %s being destroyed.",
 				CurrentChannel->GetName().c_str());
 
-			RemoveChannel(CurrentChannel);
-		}
+			Iterator = ChatChannels.erase(Iterator);
 
-		iterator.Advance();
+			safe_delete(CurrentChannel);
+
+			continue;
+		}
 
+		++Iterator;
 	}
 }
 
 void ChatChannel::AddInvitee(std::string Invitee) {
 
-	if(!IsInvitee(Invitee)) {
-
-		Invitees.push_back(Invitee);
+	if(Invitees.insert(Invitee).second) {
 
 		_log(UCS__TRACE, "Added %s as invitee to channel %s", Invitee.c_str(), Name.c_str());
 	}
@@ -578,39 +530,18 @@ void ChatChannel::AddInvitee(std::string Invitee) {
 
 void ChatChannel::RemoveInvitee(std::string Invitee) {
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Invitees.begin(); Iterator != Invitees.end(); ++Iterator) {
-
-		if((*Iterator) == Invitee) {
-
-			Invitees.erase(Iterator);
-
-			_log(UCS__TRACE, "Removed %s as invitee to channel %s", Invitee.c_str(), Name.c_str());
-
-			return;
-		}
-	}
+	if(Invitees.erase(Invitee) > 0)
+		_log(UCS__TRACE, "Removed %s as invitee to channel %s", Invitee.c_str(), Name.c_str());
 }
 
 bool ChatChannel::IsInvitee(std::string Invitee) {
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Invitees.begin(); Iterator != Invitees.end(); ++Iterator) {
-
-		if((*Iterator) == Invitee)
-			return true;
-	}
-
-	return false;
+	return (Invitees.find(Invitee) != Invitees.end());
 }
 
 void ChatChannel::AddModerator(std::string Moderator) {
 
-	if(!IsModerator(Moderator)) {
-
-		Moderators.push_back(Moderator);
+	if(Moderators.insert(Moderator).second) {
 
 		_log(UCS__TRACE, "Added %s as moderator to channel %s", Moderator.c_str(), Name.c_str());
 	}
@@ -619,39 +550,18 @@ void ChatChannel::AddModerator(std::string Moderator) {
 
 void ChatChannel::RemoveModerator(std::string Moderator) {
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Moderators.begin(); Iterator != Moderators.end(); ++Iterator) {
-
-		if((*Iterator) == Moderator) {
-
-			Moderators.erase(Iterator);
-
-			_log(UCS__TRACE, "Removed %s as moderator to channel %s", Moderator.c_str(), Name.c_str());
-
-			return;
-		}
-	}
+	if(Moderators.erase(Moderator) > 0)
+		_log(UCS__TRACE, "Removed %s as moderator to channel %s", Moderator.c_str(), Name.c_str());
 }
 
 bool ChatChannel::IsModerator(std::string Moderator) {
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Moderators.begin(); Iterator != Moderators.end(); ++Iterator) {
-
-		if((*Iterator) == Moderator)
-			return true;
-	}
-
-	return false;
+	return (Moderators.find(Moderator) != Moderators.end());
 }
 
 void ChatChannel::AddVoice(std::string inVoiced) {
 
-	if(!HasVoice(inVoiced)) {
-
-		Voiced.push_back(inVoiced);
+	if(Voiced.insert(inVoiced).second) {
 
 		_log(UCS__TRACE, "Added %s as voiced to channel %s", inVoiced.c_str(), Name.c_str());
 	}
@@ -660,32 +570,13 @@ void ChatChannel::AddVoice(std::string inVoiced) {
 
 void ChatChannel::RemoveVoice(std::string inVoiced) {
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Voiced.begin(); Iterator != Voiced.end(); ++Iterator) {
-
-		if((*Iterator) == inVoiced) {
-
-			Voiced.erase(Iterator);
-
-			_log(UCS__TRACE, "Removed %s as voiced to channel %s", inVoiced.c_str(), Name.c_str());
-
-			return;
-		}
-	}
+	if(Voiced.erase(inVoiced) > 0)
+		_log(UCS__TRACE, "Removed %s as voiced to channel %s", inVoiced.c_str(), Name.c_str());
 }
 
 bool ChatChannel::HasVoice(std::string inVoiced) {
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Voiced.begin(); Iterator != Voiced.end(); ++Iterator) {
-
-		if((*Iterator) == inVoiced)
-			return true;
-	}
-
-	return false;
+	return (Voiced.find(inVoiced) != Voiced.end());
 }
 
 std::string CapitaliseName(std::string inString) {
@@ -5,7 +5,8 @@
 #include "../common/linked_list.h"
 #include "../common/timer.h"
 #include <string>
-#include <list>
+#include <unordered_map>
+#include <unordered_set>
 
 class Client;
 
@@ -58,11 +59,11 @@ private:
 
 	Timer DeleteTimer;
 
-	LinkedList<Client*> ClientsInChannel;
+	std::unordered_set<Client*> ClientsInChannel;
 
-	std::list<std::string> Moderators;
-	std::list<std::string> Invitees;
-	std::list<std::string> Voiced;
+	std::unordered_set<std::string> Moderators;
+	std::unordered_set<std::string> Invitees;
+	std::unordered_set<std::string> Voiced;
 
 };
 
@@ -81,7 +82,8 @@ public:
 
 private:
 
-	LinkedList<ChatChannel*> ChatChannels;
+	// Keyed by the channel's CapitaliseName'd name
+	std::unordered_map<std::string, ChatChannel*> ChatChannels;
 
 };
 
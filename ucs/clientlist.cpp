@@ -1505,6 +1505,16 @@ void Client::SendChannelMessage(std::string ChannelName, std::string Message, Cl
 
 	if(!Sender) return;
 
+	EQApplicationPacket *outapp = MakeChannelMessagePacket(ChannelName, Message, Sender, UnderfootOrLater);
+
+	_pkt(UCS__PACKETS, outapp);
+	QueuePacket(outapp);
+
+	safe_delete(outapp);
+}
+
+EQApplicationPacket *Client::MakeChannelMessagePacket(const std::string &ChannelName, const std::string &Message, Client *Sender, bool UnderfootOrLater) {
+
 	std::string FQSenderName = WorldShortName + "." + Sender->GetName();
 
 	int PacketLength = ChannelName.length() + Message.length() + FQSenderName.length() + 3;
@@ -1523,10 +1533,7 @@ void Client::SendChannelMessage(std::string ChannelName, std::string Message, Cl
 	if(UnderfootOrLater)
 		VARSTRUCT_ENCODE_STRING(PacketBuffer, "SPAM:0:");
 
-	_pkt(UCS__PACKETS, outapp);
-	QueuePacket(outapp);
-
-	safe_delete(outapp);
+	return outapp;
 }
 
 void Client::ToggleAnnounce(std::string State)
@@ -100,6 +100,9 @@ public:
 	void RemoveFromChannelList(ChatChannel *JoinedChannel);
 	void SendChannelMessage(std::string Message);
 	void SendChannelMessage(std::string ChannelName, std::string Message, Client *Sender);
+	// Builds the OP_ChannelMessage for one client version, so a channel can encode a message once and queue it to every member.
+	static EQApplicationPacket *MakeChannelMessagePacket(const std::string &ChannelName, const std::string &Message, Client *Sender, bool UnderfootOrLater);
+	inline bool IsUnderfootOrLater() { return UnderfootOrLater; }
 	void SendChannelMessageByNumber(std::string Message);
 	void SendChannelList();
 	void CloseConnection();
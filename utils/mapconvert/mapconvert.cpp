@@ -0,0 +1,92 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "../../common/debug.h"
+#include "../../zone/map.h"
+
+//Converts V1/V2 maps (as written by azone2) to the V3 format, which has the raycast tree
+//prebuilt so zones can map it read only instead of building it themselves. With -h it also
+//writes the .hgt height field FindBestZ answers from.
+int main(int argc, char **argv) {
+	float cell_size = 0.0f;
+	int arg = 1;
+	if(argc > 2 && strcmp(argv[1], "-h") == 0) {
+		cell_size = (float)atof(argv[2]);
+		if(cell_size <= 0.0f) {
+			printf("The height field cell size must be greater than zero.\n");
+			return 1;
+		}
+		arg = 3;
+	}
+
+	if(argc - arg != 2) {
+		printf("Usage: %s [-h cell_size] <source .map> <destination .map>\n", argv[0]);
+		printf("Converts a V1 or V2 map to the prebuilt V3 format, the source and destination may be the same file.\n");
+		printf("-h also writes a height field with cells of cell_size units (8 is a good start) next to the destination.\n");
+		return 1;
+	}
+
+	std::string source = argv[arg];
+	std::string dest = argv[arg + 1];
+
+	Map map;
+	if(!map.Load(source)) {
+		printf("Unable to load %s.\n", source.c_str());
+		return 1;
+	}
+
+	if(map.IsMapped()) {
+		printf("%s is already a V3 map.\n", source.c_str());
+	} else {
+		if(!map.Save(dest)) {
+			printf("Unable to write %s.\n", dest.c_str());
+			return 1;
+		}
+
+		Map check;
+		if(!check.Load(dest) || !check.IsMapped()) {
+			printf("Wrote %s but it did not load back as a V3 map.\n", dest.c_str());
+			return 1;
+		}
+
+		printf("Converted %s to %s.\n", source.c_str(), dest.c_str());
+	}
+
+	if(cell_size > 0.0f) {
+		std::string hgt = dest;
+		size_t ext = hgt.rfind(".map");
+		if(ext != std::string::npos && ext == hgt.length() - 4) {
+			hgt.erase(ext);
+		}
+		hgt += ".hgt";
+
+		//half a unit of error is well under what a mob standing on the ground can show
+		if(!map.SaveHeightField(hgt, cell_size, 0.5f) || !map.LoadHeightField(hgt)) {
+			printf("Unable to write %s.\n", hgt.c_str());
+			return 1;
+		}
+
+		printf("Wrote height field %s.\n", hgt.c_str());
+	}
+
+	return 0;
+}
@@ -156,6 +156,38 @@ std::map<std::string,std::string> EQW::GetZoneDetails(Const_char *zone_ref) {
 	return(res);
 }
 
+//keys are <section>_p50, _p99, _max and _avg in usec per tick, see TickProfiler::SectionName
+std::map<std::string,std::string> EQW::GetZoneProfile(Const_char *zone_ref) {
+	std::map<std::string,std::string> res;
+
+	ZoneServer *zs = zoneserver_list.FindByID(atoi(zone_ref));
+	if(zs == nullptr) {
+		res["error"] = "Invalid zone.";
+		return(res);
+	}
+
+	const ServerZoneTickProfile_Struct *tp = zs->GetTickProfile();
+	if(tp == nullptr) {
+		res["error"] = "No profile reported.";
+		return(res);
+	}
+
+	res["ticks"] = itoa(tp->ticks);
+	res["budget"] = itoa(tp->budget);
+	res["over_budget"] = itoa(tp->over_budget);
+	res["interval"] = itoa(tp->interval);
+	res["age"] = itoa(zs->GetTickProfileAge());
+	for(int i = 0; i < TickSectionCount; i++) {
+		std::string name = TickProfiler::SectionName(i);
+		res[name + "_p50"] = itoa(tp->sections[i].p50);
+		res[name + "_p99"] = itoa(tp->sections[i].p99);
+		res[name + "_max"] = itoa(tp->sections[i].max);
+		res[name + "_avg"] = itoa(tp->sections[i].avg);
+	}
+
+	return(res);
+}
+
 int EQW::CountPlayers() {
 	return(client_list.GetClientCount());
 }
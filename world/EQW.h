@@ -47,6 +47,7 @@ public:
 	int CountZones();
 	std::vector<std::string> ListBootedZones();	//returns an array of zone_refs (opaque)
 	std::map<std::string,std::string> GetZoneDetails(Const_char *zone_ref);	//returns a hash ref of details
+	std::map<std::string,std::string> GetZoneProfile(Const_char *zone_ref);	//returns a hash ref of main loop timings
 
 	int CountPlayers();
 	std::vector<std::string> ListPlayers(Const_char *zone_name = "");	//returns an array of player refs (opaque)
@@ -28,11 +28,14 @@
 #include "../common/StringUtil.h"
 #include "worlddb.h"
 #include "EQLConfig.h"
+#include "zonelist.h"
+#include "zoneserver.h"
 
 #include <vector>
 #include <string>
 
 extern LauncherList launcher_list;
+extern ZSList zoneserver_list;
 
 LauncherLink::LauncherLink(int id, EmuTCPConnection *c)
 : ID(id),
@@ -170,6 +173,27 @@ bool LauncherLink::Process() {
 			res->second.starts = it->start_count;
 			break;
 		}
+		case ServerOP_LauncherZoneAttach: {
+			if(pack->size != sizeof(LauncherZoneAttach))
+				break;
+			const LauncherZoneAttach *it = (const LauncherZoneAttach *) pack->pBuffer;
+			uint32 zone_id = database.GetZoneID(it->short_name);
+			if(zone_id == 0) {
+				_log(WORLD__LAUNCH_ERR, "%s: attached unknown zone %s to warm process %s.", m_name.c_str(), it->short_name, it->warm_name);
+				break;
+			}
+			ZoneServer *zs = zoneserver_list.FindByLaunchedName(m_name.c_str(), it->warm_name);
+			if(zs == nullptr || zs->GetZoneID() != 0 || zs->IsBootingUp()) {
+				//the process went away under us, have the launcher start the zone on its own
+				_log(WORLD__LAUNCH_ERR, "%s: warm process %s for zone %s is gone, restarting it.", m_name.c_str(), it->warm_name, it->short_name);
+				RestartZone(it->short_name);
+				break;
+			}
+			_log(WORLD__LAUNCH, "%s: booting %s on warm process %s.", m_name.c_str(), it->short_name, it->warm_name);
+			zs->SetLaunchedName(it->short_name);
+			zs->TriggerBootup(zone_id, 0, nullptr, true);
+			break;
+		}
 		default:
 		{
 			_log(WORLD__LAUNCH_ERR, "Unknown ServerOPcode from launcher 0x%04x, size %d",pack->opcode,pack->size);
@@ -239,6 +263,29 @@ void LauncherLink::StopZone(const char *short_name) {
 	delete pack;
 }
 
+void LauncherLink::WarmReady(const char *warm_name) {
+	ServerPacket* pack = new ServerPacket(ServerOP_LauncherZoneRequest, sizeof(LauncherZoneRequest));
+	LauncherZoneRequest* s = (LauncherZoneRequest *) pack->pBuffer;
+
+	strn0cpy(s->short_name, warm_name, 32);
+	s->command = ZR_WarmReady;
+
+	SendPacket(pack);
+	delete pack;
+}
+
+int LauncherLink::CountStartingDynamics() const {
+	int count = 0;
+	std::map<std::string, ZoneState>::const_iterator cur, end;
+	cur = m_states.begin();
+	end = m_states.end();
+	for(; cur != end; ++cur) {
+		if(!cur->second.up && cur->first.compare(0, 8, "dynamic_") == 0)
+			count++;
+	}
+	return(count);
+}
+
 void LauncherLink::BootDynamics(uint8 new_count) {
 	if(m_dynamicCount == new_count)
 		return;
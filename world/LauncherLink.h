@@ -43,6 +43,10 @@ public:
 	inline uint16		GetPort() const		{ return tcpc->GetrPort(); }
 	inline const char * GetName() const		{ return(m_name.c_str()); }
 	inline int			CountZones() const	{ return(m_states.size()); }
+	inline uint8		GetDynamicCount() const	{ return(m_dynamicCount); }
+
+	//dynamics started but not yet reported as running
+	int CountStartingDynamics() const;
 
 	bool ContainsZone(const char *short_name) const;
 
@@ -53,6 +57,7 @@ public:
 	void RestartZone(const char *short_name);
 	void StopZone(const char *short_name);
 	void BootDynamics(uint8 new_total);
+	void WarmReady(const char *warm_name);
 
 	void GetZoneList(std::vector<std::string> &list);
 	void GetZoneDetails(const char *short_name, std::map<std::string,std::string> &result);
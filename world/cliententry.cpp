@@ -89,6 +89,7 @@ ClientListEntry::ClientListEntry(uint32 in_id, ZoneServer* iZS, ServerClientList
 }
 
 ClientListEntry::~ClientListEntry() {
+	client_list.UnindexCLE(this);
 	if (RunLoops) {
 		Camp(); // updates zoneserver's numplayers
 		client_list.RemoveCLEReferances(this);
@@ -98,6 +99,7 @@ ClientListEntry::~ClientListEntry() {
 void ClientListEntry::SetChar(uint32 iCharID, const char* iCharName) {
 	pcharid = iCharID;
 	strn0cpy(pname, iCharName, sizeof(pname));
+	client_list.CLEKeysChanged(this);
 }
 
 void ClientListEntry::SetOnline(ZoneServer* iZS, int8 iOnline) {
@@ -190,6 +192,8 @@ void ClientListEntry::Update(ZoneServer* iZS, ServerClientList_Struct* scl, int8
 		memcpy(pLFGComments, scl->LFGComments, sizeof(pLFGComments));
 	}
 
+	client_list.CLEKeysChanged(this);
+
 	SetOnline(iOnline);
 }
 
@@ -233,6 +237,8 @@ void ClientListEntry::ClearVars(bool iAll) {
 	pLFG = 0;
 	gm = 0;
 	pClientVersion = 0;
+
+	client_list.CLEKeysChanged(this);
 }
 
 void ClientListEntry::Camp(ZoneServer* iZS) {
@@ -270,6 +276,7 @@ bool ClientListEntry::CheckAuth(uint32 iLSID, const char* iKey) {
 			}
 			strn0cpy(paccountname, plsname, sizeof(paccountname));
 			padmin = tmpStatus;
+			client_list.CLEKeysChanged(this);
 		}
 		char lsworldadmin[15] = "0";
 		database.GetVariable("honorlsworldadmin", lsworldadmin, sizeof(lsworldadmin));
@@ -290,6 +297,7 @@ bool ClientListEntry::CheckAuth(uint32 id, const char* iKey, uint32 ip) {
 	if (pIP==ip && strncmp(plskey, iKey,10) == 0){
 		paccountid = id;
 		database.GetAccountFromID(id,paccountname,&padmin);
+		client_list.CLEKeysChanged(this);
 		return true;
 	}
 	return false;
@@ -80,16 +80,97 @@ void ClientList::CLERemoveZSRef(ZoneServer* iZS) {
 }
 
 ClientListEntry* ClientList::GetCLE(uint32 iID) {
-	LinkedListIterator<ClientListEntry*> iterator(clientlist);
+	std::unordered_map<uint32, CLEIndexKeys>::iterator res = cle_by_id.find(iID);
+	if (res == cle_by_id.end())
+		return 0;
+	return res->second.cle;
+}
 
-	iterator.Reset();
-	while(iterator.MoreElements()) {
-		if (iterator.GetData()->GetID() == iID) {
-			return iterator.GetData();
+static std::string CLEIndexName(const char* name) {
+	std::string res(name);
+	for(size_t i = 0; i < res.size(); i++)
+		res[i] = tolower(res[i]);
+	return res;
+}
+
+template<typename K>
+static void CLEIndexErase(std::unordered_multimap<K, ClientListEntry*> &index, const K &key, ClientListEntry* cle) {
+	typedef typename std::unordered_multimap<K, ClientListEntry*>::iterator iter_type;
+	std::pair<iter_type, iter_type> range = index.equal_range(key);
+	for(iter_type cur = range.first; cur != range.second; ++cur) {
+		if (cur->second == cle) {
+			index.erase(cur);
+			return;
 		}
-		iterator.Advance();
 	}
-	return 0;
+}
+
+//newest entry under key. The list search returned whichever was nearest the head, which was the
+//oldest one for entries Append()ed from the login server; the newest is kept on purpose as the live session.
+template<typename K>
+static ClientListEntry* CLEIndexFind(std::unordered_multimap<K, ClientListEntry*> &index, const K &key) {
+	typedef typename std::unordered_multimap<K, ClientListEntry*>::iterator iter_type;
+	std::pair<iter_type, iter_type> range = index.equal_range(key);
+	ClientListEntry* res = 0;
+	for(iter_type cur = range.first; cur != range.second; ++cur) {
+		if (res == 0 || cur->second->GetID() > res->GetID())
+			res = cur->second;
+	}
+	return res;
+}
+
+void ClientList::IndexCLE(ClientListEntry* cle) {
+	CLEIndexKeys keys;
+	keys.cle = cle;
+	keys.name = CLEIndexName(cle->name());
+	keys.account_id = cle->AccountID();
+	keys.char_id = cle->CharID();
+	keys.ls_id = cle->LSID();
+
+	//unset keys aren't indexed, lookups for them still search the list
+	if (!keys.name.empty())
+		cle_by_name.insert(std::make_pair(keys.name, cle));
+	if (keys.account_id)
+		cle_by_account.insert(std::make_pair(keys.account_id, cle));
+	if (keys.char_id)
+		cle_by_char.insert(std::make_pair(keys.char_id, cle));
+	if (keys.ls_id)
+		cle_by_lsid.insert(std::make_pair(keys.ls_id, cle));
+
+	cle_by_id[cle->GetID()] = keys;
+}
+
+void ClientList::UnindexCLE(ClientListEntry* cle) {
+	std::unordered_map<uint32, CLEIndexKeys>::iterator res = cle_by_id.find(cle->GetID());
+	if (res == cle_by_id.end() || res->second.cle != cle)
+		return;
+
+	CLEIndexKeys &keys = res->second;
+	if (!keys.name.empty())
+		CLEIndexErase(cle_by_name, keys.name, cle);
+	if (keys.account_id)
+		CLEIndexErase(cle_by_account, keys.account_id, cle);
+	if (keys.char_id)
+		CLEIndexErase(cle_by_char, keys.char_id, cle);
+	if (keys.ls_id)
+		CLEIndexErase(cle_by_lsid, keys.ls_id, cle);
+
+	cle_by_id.erase(res);
+}
+
+void ClientList::CLEKeysChanged(ClientListEntry* cle) {
+	//CLEs set themselves up before they are added to the list
+	std::unordered_map<uint32, CLEIndexKeys>::iterator res = cle_by_id.find(cle->GetID());
+	if (res == cle_by_id.end() || res->second.cle != cle)
+		return;
+
+	CLEIndexKeys &keys = res->second;
+	if (keys.account_id == cle->AccountID() && keys.char_id == cle->CharID() && keys.ls_id == cle->LSID()
+		&& strcasecmp(keys.name.c_str(), cle->name()) == 0)
+		return;
+
+	UnindexCLE(cle);
+	IndexCLE(cle);
 }
 
 //Account Limiting Code to limit the number of characters allowed on from a single account at once.
@@ -239,6 +320,9 @@ void ClientList::DisconnectByIP(uint32 iIP) {
 }
 
 ClientListEntry* ClientList::FindCharacter(const char* name) {
+	if (name && name[0] != '\0')
+		return CLEIndexFind(cle_by_name, CLEIndexName(name));
+
 	LinkedListIterator<ClientListEntry*> iterator(clientlist);
 
 	iterator.Reset();
@@ -254,6 +338,9 @@ ClientListEntry* ClientList::FindCharacter(const char* name) {
 
 
 ClientListEntry* ClientList::FindCLEByAccountID(uint32 iAccID) {
+	if (iAccID != 0)
+		return CLEIndexFind(cle_by_account, iAccID);
+
 	LinkedListIterator<ClientListEntry*> iterator(clientlist);
 
 	iterator.Reset();
@@ -267,6 +354,9 @@ ClientListEntry* ClientList::FindCLEByAccountID(uint32 iAccID) {
 }
 
 ClientListEntry* ClientList::FindCLEByCharacterID(uint32 iCharID) {
+	if (iCharID != 0)
+		return CLEIndexFind(cle_by_char, iCharID);
+
 	LinkedListIterator<ClientListEntry*> iterator(clientlist);
 
 	iterator.Reset();
@@ -331,6 +421,7 @@ void ClientList::CLEAdd(uint32 iLSID, const char* iLoginName, const char* iLogin
 	ClientListEntry* tmp = new ClientListEntry(GetNextCLEID(), iLSID, iLoginName, iLoginKey, iWorldAdmin, ip, local);
 
 	clientlist.Append(tmp);
+	IndexCLE(tmp);
 }
 
 void ClientList::CLCheckStale() {
@@ -347,22 +438,16 @@ void ClientList::CLCheckStale() {
 }
 
 void ClientList::ClientUpdate(ZoneServer* zoneserver, ServerClientList_Struct* scl) {
-	LinkedListIterator<ClientListEntry*> iterator(clientlist);
-	ClientListEntry* cle;
-	iterator.Reset();
-	while(iterator.MoreElements()) {
-		if (iterator.GetData()->GetID() == scl->wid) {
-			cle = iterator.GetData();
-			if (scl->remove == 2){
-				cle->LeavingZone(zoneserver, CLE_Status_Offline);
-			}
-			else if (scl->remove == 1)
-				cle->LeavingZone(zoneserver, CLE_Status_Zoning);
-			else
-				cle->Update(zoneserver, scl);
-			return;
+	ClientListEntry* cle = GetCLE(scl->wid);
+	if (cle) {
+		if (scl->remove == 2){
+			cle->LeavingZone(zoneserver, CLE_Status_Offline);
 		}
-		iterator.Advance();
+		else if (scl->remove == 1)
+			cle->LeavingZone(zoneserver, CLE_Status_Zoning);
+		else
+			cle->Update(zoneserver, scl);
+		return;
 	}
 	if (scl->remove == 2)
 		cle = new ClientListEntry(GetNextCLEID(), zoneserver, scl, CLE_Status_Online);
@@ -371,20 +456,17 @@ void ClientList::ClientUpdate(ZoneServer* zoneserver, ServerClientList_Struct* s
 	else
 		cle = new ClientListEntry(GetNextCLEID(), zoneserver, scl, CLE_Status_InZone);
 	clientlist.Insert(cle);
+	IndexCLE(cle);
 	zoneserver->ChangeWID(scl->charid, cle->GetID());
 }
 
 void ClientList::CLEKeepAlive(uint32 numupdates, uint32* wid) {
-	LinkedListIterator<ClientListEntry*> iterator(clientlist);
 	uint32 i;
 
-	iterator.Reset();
-	while(iterator.MoreElements()) {
-		for (i=0; i<numupdates; i++) {
-			if (wid[i] == iterator.GetData()->GetID())
-				iterator.GetData()->KeepAlive();
-		}
-		iterator.Advance();
+	for (i=0; i<numupdates; i++) {
+		ClientListEntry* cle = GetCLE(wid[i]);
+		if (cle)
+			cle->KeepAlive();
 	}
 }
 
@@ -401,6 +483,20 @@ ClientListEntry* ClientList::CheckAuth(uint32 id, const char* iKey, uint32 ip )
 	return 0;
 }
 ClientListEntry* ClientList::CheckAuth(uint32 iLSID, const char* iKey) {
+	//the key is what's checked, the LS id only narrows down where to look for it first
+	if (iLSID != 0) {
+		//a passing CheckAuth can reindex the entry, so don't hold index iterators across it
+		typedef std::unordered_multimap<uint32, ClientListEntry*>::iterator iter_type;
+		std::pair<iter_type, iter_type> range = cle_by_lsid.equal_range(iLSID);
+		std::vector<ClientListEntry*> candidates;
+		for(iter_type cur = range.first; cur != range.second; ++cur)
+			candidates.push_back(cur->second);
+		for(size_t i = 0; i < candidates.size(); i++) {
+			if (candidates[i]->CheckAuth(iLSID, iKey))
+				return candidates[i];
+		}
+	}
+
 	LinkedListIterator<ClientListEntry*> iterator(clientlist);
 
 	iterator.Reset();
@@ -430,6 +526,7 @@ ClientListEntry* ClientList::CheckAuth(const char* iName, const char* iPassword)
 	if (accid) {
 		ClientListEntry* tmp = new ClientListEntry(GetNextCLEID(), accid, iName, tmpMD5, tmpadmin);
 		clientlist.Append(tmp);
+		IndexCLE(tmp);
 		return tmp;
 	}
 	return 0;
@@ -1197,15 +1294,10 @@ void ClientList::SendGuildPacket(uint32 guild_id, ServerPacket* pack) {
 }
 
 void ClientList::UpdateClientGuild(uint32 char_id, uint32 guild_id) {
-	LinkedListIterator<ClientListEntry*> iterator(clientlist);
-
-	iterator.Reset();
-	while(iterator.MoreElements()) {
-		ClientListEntry *cle = iterator.GetData();
-		if (cle->CharID() == char_id) {
-			cle->SetGuild(guild_id);
-		}
-		iterator.Advance();
+	typedef std::unordered_multimap<uint32, ClientListEntry*>::iterator iter_type;
+	std::pair<iter_type, iter_type> range = cle_by_char.equal_range(char_id);
+	for(iter_type cur = range.first; cur != range.second; ++cur) {
+		cur->second->SetGuild(guild_id);
 	}
 }
 
@@ -8,6 +8,7 @@
 #include "../common/servertalk.h"
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 class Client;
 class ZoneServer;
@@ -54,6 +55,9 @@ public:
 	ClientListEntry* FindCLEByAccountID(uint32 iAccID);
 	ClientListEntry* FindCLEByCharacterID(uint32 iCharID);
 	ClientListEntry* GetCLE(uint32 iID);
+	//called by a CLE whenever its name, account, character or LS id may have changed
+	void	CLEKeysChanged(ClientListEntry* cle);
+	void	UnindexCLE(ClientListEntry* cle);
 	void	GetCLEIP(uint32 iIP);
 	void	DisconnectByIP(uint32 iIP);
 	void	EnforceSessionLimit(uint32 iLSAccountID);
@@ -67,6 +71,7 @@ public:
 
 protected:
 	inline uint32 GetNextCLEID() { return NextCLEID++; }
+	void	IndexCLE(ClientListEntry* cle);
 
 	//this is the list of people actively connected to zone
 	LinkedList<Client*> list;
@@ -74,6 +79,24 @@ protected:
 	//this is the list of people in any zone, not nescesarily connected to world
 	Timer	CLStale_timer;
 	uint32 NextCLEID;
+
+	//indexes over clientlist so finding one entry doesn't walk the whole population.
+	//by_id holds the keys each entry was indexed under so they can be taken out again
+	//after the entry has changed them. Declared ahead of clientlist, CLEs unindex
+	//themselves as clientlist deletes them.
+	struct CLEIndexKeys {
+		ClientListEntry* cle;
+		std::string name;	//lower case
+		uint32 account_id;
+		uint32 char_id;
+		uint32 ls_id;
+	};
+	std::unordered_map<uint32, CLEIndexKeys> cle_by_id;
+	std::unordered_multimap<std::string, ClientListEntry*> cle_by_name;
+	std::unordered_multimap<uint32, ClientListEntry*> cle_by_account;
+	std::unordered_multimap<uint32, ClientListEntry*> cle_by_char;
+	std::unordered_multimap<uint32, ClientListEntry*> cle_by_lsid;
+
 	LinkedList<ClientListEntry *> clientlist;
 
 };
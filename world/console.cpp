@@ -444,6 +444,7 @@ void Console::ProcessCommand(const char* command) {
 				SendMessage(1, "  whoami");
 				SendMessage(1, "  who");
 				SendMessage(1, "  zonestatus");
+				SendMessage(1, "  zoneprofile [ZoneServerID]");
 				SendMessage(1, "  uptime [zoneID#]");
 				SendMessage(1, "  emote [zonename or charname or world] [type] [message]");
 				SendMessage(1, "  echo [on/off]");
@@ -677,6 +678,9 @@ void Console::ProcessCommand(const char* command) {
 			else if (strcasecmp(sep.arg[0], "zonestatus") == 0) {
 				zoneserver_list.SendZoneStatus(0, admin, this);
 			}
+			else if (strcasecmp(sep.arg[0], "zoneprofile") == 0) {
+				zoneserver_list.SendZoneProfile(0, this, sep.IsNumber(1) ? atoi(sep.arg[1]) : 0);
+			}
 			else if (strcasecmp(sep.arg[0], "exit") == 0 || strcasecmp(sep.arg[0], "quit") == 0) {
 				SendMessage(1, "Bye Bye.");
 				state = CONSOLE_STATE_CLOSED;
@@ -180,7 +180,7 @@ int main(int argc, char** argv) {
 		_log(WORLD__INIT_ERR, "Cannot continue without a database connection.");
 		return 1;
 	}
-	dbasync = new DBAsync(&database);
+	dbasync = new DBAsync(&database, Config->DatabaseAsyncWorkers);
 	guild_mgr.SetDatabase(&database);
 
 	if (argc >= 2) {
@@ -355,6 +355,7 @@ int main(int argc, char** argv) {
 		_log(WORLD__INIT_ERR,"        %s",errbuf);
 		return 1;
 	}
+	eqsf.SetReaderThreads(Config->WorldUDPReaders);
 	if (eqsf.Open()) {
 		_log(WORLD__INIT,"Client (UDP) listener started.");
 	} else {
@@ -447,6 +448,8 @@ int main(int argc, char** argv) {
 		//check for timeouts in other threads
 		timeout_manager.CheckTimeouts();
 
+		dbasync->DispatchCallbacks();
+
 		loginserverlist.Process();
 
 		console_list.Process();
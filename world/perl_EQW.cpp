@@ -276,6 +276,53 @@ XS(XS_EQW_GetZoneDetails)
 	XSRETURN(1);
 }
 
+XS(XS_EQW_GetZoneProfile); /* prototype to pass -Wmissing-prototypes */
+XS(XS_EQW_GetZoneProfile)
+{
+	dXSARGS;
+	if (items != 2)
+		Perl_croak(aTHX_ "Usage: EQW::GetZoneProfile(THIS, zone_ref)");
+	{
+		EQW *		THIS;
+		std::map<std::string,std::string>		RETVAL;
+		Const_char *		zone_ref = (Const_char *)SvPV_nolen(ST(1));
+
+		if (sv_derived_from(ST(0), "EQW")) {
+			IV tmp = SvIV((SV*)SvRV(ST(0)));
+			THIS = INT2PTR(EQW *,tmp);
+		}
+		else
+			Perl_croak(aTHX_ "THIS is not of type EQW");
+		if(THIS == nullptr)
+			Perl_croak(aTHX_ "THIS is nullptr, avoiding crash.");
+
+		RETVAL = THIS->GetZoneProfile(zone_ref);
+		ST(0) = sv_newmortal();
+		if (RETVAL.begin()!=RETVAL.end())
+		{
+				//NOTE: we are leaking the original ST(0) right now
+				HV *hv = newHV();
+				sv_2mortal((SV*)hv);
+				ST(0) = newRV((SV*)hv);
+
+				std::map<std::string,std::string>::const_iterator cur, end;
+				cur = RETVAL.begin();
+				end = RETVAL.end();
+				for(; cur != end; cur++) {
+						/* get the element from the hash, creating if needed (will be needed) */
+						SV**ele = hv_fetch(hv, cur->first.c_str(), cur->first.length(), TRUE);
+						if(ele == nullptr) {
+								Perl_croak(aTHX_ "Unable to create a hash element for RETVAL");
+								break;
+						}
+						/* put our string in the SV associated with this element in the hash */
+						sv_setpvn(*ele, cur->second.c_str(), cur->second.length());
+				}
+		}
+	}
+	XSRETURN(1);
+}
+
 XS(XS_EQW_CountPlayers); /* prototype to pass -Wmissing-prototypes */
 XS(XS_EQW_CountPlayers)
 {
@@ -986,6 +1033,7 @@ XS(boot_EQW)
 		newXSproto(strcpy(buf, "CountZones"), XS_EQW_CountZones, file, "$");
 		newXSproto(strcpy(buf, "ListBootedZones"), XS_EQW_ListBootedZones, file, "$");
 		newXSproto(strcpy(buf, "GetZoneDetails"), XS_EQW_GetZoneDetails, file, "$$");
+		newXSproto(strcpy(buf, "GetZoneProfile"), XS_EQW_GetZoneProfile, file, "$$");
 		newXSproto(strcpy(buf, "CountPlayers"), XS_EQW_CountPlayers, file, "$");
 		newXSproto(strcpy(buf, "ListPlayers"), XS_EQW_ListPlayers, file, "$;$");
 		newXSproto(strcpy(buf, "GetPlayerDetails"), XS_EQW_GetPlayerDetails, file, "$$");
@@ -24,13 +24,21 @@
 #include "WorldConfig.h"
 #include "../common/servertalk.h"
 #include "../common/StringUtil.h"
+#include "../common/rulesys.h"
+#include "LauncherList.h"
+#include "LauncherLink.h"
+#include "EQLConfig.h"
+#include <map>
+#include <string>
 
 extern uint32			numzones;
 extern bool holdzones;
 extern ConsoleList		console_list;
+extern LauncherList		launcher_list;
 void CatchSignal(int sig_num);
 
 ZSList::ZSList()
+:	standby_timer(10000)
 {
 	NextID = 1;
 	CurGroupID = 1;
@@ -60,15 +68,60 @@ void ZSList::ShowUpTime(WorldTCPConnection* con, const char* adminname) {
 
 void ZSList::Add(ZoneServer* zoneserver) {
 	list.Insert(zoneserver);
+	by_id[zoneserver->GetID()] = zoneserver;
+	IndexZone(zoneserver);
 	zoneserver->SendGroupIDs();	//send its initial set of group ids
 }
 
+void ZSList::IndexZone(ZoneServer* zs) {
+	if (zs->GetZoneID() != 0)
+		by_zone.insert(std::make_pair(zs->GetZoneID(), zs));
+	if (zs->GetInstanceID() != 0)
+		by_instance.insert(std::make_pair(zs->GetInstanceID(), zs));
+}
+
+static void ZSIndexErase(std::unordered_multimap<uint32, ZoneServer*> &index, uint32 key, ZoneServer* zs) {
+	std::pair<std::unordered_multimap<uint32, ZoneServer*>::iterator, std::unordered_multimap<uint32, ZoneServer*>::iterator> range = index.equal_range(key);
+	for(std::unordered_multimap<uint32, ZoneServer*>::iterator cur = range.first; cur != range.second; ++cur) {
+		if (cur->second == zs) {
+			index.erase(cur);
+			return;
+		}
+	}
+}
+
+void ZSList::UnindexZone(ZoneServer* zs, uint32 zone, uint32 instance) {
+	if (zone != 0)
+		ZSIndexErase(by_zone, zone, zs);
+	if (instance != 0)
+		ZSIndexErase(by_instance, instance, zs);
+}
+
+void ZSList::ZoneIDsChanged(ZoneServer* zs, uint32 old_zone, uint32 old_instance) {
+	//not in the list yet, Add indexes it
+	std::unordered_map<uint32, ZoneServer*>::iterator res = by_id.find(zs->GetID());
+	if (res == by_id.end() || res->second != zs)
+		return;
+
+	UnindexZone(zs, old_zone, old_instance);
+	IndexZone(zs);
+}
+
+//takes zs out of the indexes, the caller removes it from list
+void ZSList::Remove(ZoneServer* zs) {
+	UnindexZone(zs, zs->GetZoneID(), zs->GetInstanceID());
+	std::unordered_map<uint32, ZoneServer*>::iterator res = by_id.find(zs->GetID());
+	if (res != by_id.end() && res->second == zs)
+		by_id.erase(res);
+}
+
 void ZSList::KillAll() {
 	LinkedListIterator<ZoneServer*> iterator(list);
 
 	iterator.Reset();
 	while(iterator.MoreElements()) {
 		iterator.GetData()->Disconnect();
+		Remove(iterator.GetData());
 		iterator.RemoveCurrent();
 		numzones--;
 	}
@@ -107,6 +160,7 @@ void ZSList::Process() {
 					RebootZone(inet_ntoa(in),zs->GetCPort(),zs->GetCAddress(),zs->GetID(),database.GetZoneID(zs->GetZoneName()));
 			}
 
+			Remove(zs);
 			iterator.RemoveCurrent();
 			numzones--;
 		}
@@ -114,59 +168,182 @@ void ZSList::Process() {
 			iterator.Advance();
 		}
 	}
+
+	if(standby_timer.Check())
+		CheckStandbyZones();
 }
 
-bool ZSList::SendPacket(ServerPacket* pack) {
-	LinkedListIterator<ZoneServer*> iterator(list);
+//keeps StandbyZonesPerLauncher idle zones on every connected launcher by starting
+//extra dynamics, at most that many past the launcher's configured count. Never
+//stops any, an admin lowering the dynamic count does that.
+void ZSList::CheckStandbyZones() {
+	int standby = RuleI(World, StandbyZonesPerLauncher);
+	if(standby <= 0)
+		return;
 
+	std::map<std::string, int> idle;
+	LinkedListIterator<ZoneServer*> iterator(list);
 	iterator.Reset();
 	while(iterator.MoreElements()) {
-		iterator.GetData()->SendPacket(pack);
+		ZoneServer* zs = iterator.GetData();
+		if(zs->GetZoneID() == 0 && !zs->IsBootingUp() && !zs->IsWarm())
+			idle[zs->GetLaunchName()]++;
 		iterator.Advance();
 	}
-	return true;
+
+	std::vector<std::string> names;
+	launcher_list.GetLauncherNameList(names);
+	std::vector<std::string>::iterator cur, end;
+	cur = names.begin();
+	end = names.end();
+	for(; cur != end; ++cur) {
+		LauncherLink *ll = launcher_list.Get(cur->c_str());
+		EQLConfig *config = launcher_list.GetConfig(cur->c_str());
+		if(ll == nullptr || config == nullptr)
+			continue;
+
+		int have = idle[*cur];
+		if(have >= standby)
+			continue;
+		//wait for the last one to come up before deciding we need another
+		if(ll->CountStartingDynamics() > 0)
+			continue;
+		int count = ll->GetDynamicCount();
+		if(count >= config->GetDynamicCount() + standby || count >= 250)
+			continue;
+
+		_log(WORLD__ZONELIST, "Launcher %s has %d idle zones of %d standby, starting dynamic %d", cur->c_str(), have, standby, count + 1);
+		ll->BootDynamics(count + 1);
+	}
 }
 
-bool ZSList::SendPacket(uint32 ZoneID, ServerPacket* pack) {
+ZoneServer* ZSList::FindBootTarget() {
 	LinkedListIterator<ZoneServer*> iterator(list);
 
+	if(!RuleB(World, ZoneBootByLoad)) {
+		iterator.Reset();
+		while(iterator.MoreElements()) {
+			if (iterator.GetData()->GetZoneID() == 0 && !iterator.GetData()->IsBootingUp() && !iterator.GetData()->IsWarm())
+				return iterator.GetData();
+			iterator.Advance();
+		}
+		return nullptr;
+	}
+
+	//zone servers on the same host share its load, the launcher is the host unless
+	//the zone was started by hand, then it's the address it connected from.
+	struct HostLoad {
+		uint32 load;	//percent of the host's cores busy by its load average, the worst recent report
+		uint32 cpus;
+		uint32 zone_cpu;	//cpu used by its zone processes, percent of one core x100
+		uint32 tick;	//the slowest zone's ticks, usec halfway between average and p99
+		uint32 clients;
+	};
+	std::map<std::string, HostLoad> hosts;
+	std::vector<std::pair<ZoneServer*, std::string> > candidates;
+
 	iterator.Reset();
 	while(iterator.MoreElements()) {
-		if (iterator.GetData()->GetZoneID() == ZoneID) {
-			ZoneServer* tmp = iterator.GetData();
-			return(tmp->SendPacket(pack));
+		ZoneServer* zs = iterator.GetData();
+		std::string host = zs->GetLaunchName();
+		if(host.empty() || host == "NONE")
+			StringFormat(host, "ip:%u", zs->GetIP());
+
+		std::map<std::string, HostLoad>::iterator res = hosts.find(host);
+		if(res == hosts.end()) {
+			HostLoad h;
+			h.load = 0;
+			h.cpus = 0;
+			h.zone_cpu = 0;
+			h.tick = 0;
+			h.clients = 0;
+			res = hosts.insert(std::make_pair(host, h)).first;
+		}
+
+		const ServerZoneLoad_Struct* zl = zs->GetLoad();
+		if(zl != nullptr) {
+			//there's no load average on windows, its host_load is 0 and the zones' own cpu use has to do
+			if(zl->host_cpus > 0) {
+				uint32 load = zl->host_load / zl->host_cpus;
+				if(load > res->second.load)
+					res->second.load = load;
+				res->second.cpus = zl->host_cpus;
+			}
+			res->second.zone_cpu += zl->cpu;
+			uint32 tick = (zl->tick_avg + zl->tick_p99) / 2;
+			if(tick > res->second.tick)
+				res->second.tick = tick;
 		}
+		res->second.clients += zs->NumPlayers();
+
+		if(zs->GetZoneID() == 0 && !zs->IsBootingUp() && !zs->IsWarm())
+			candidates.push_back(std::make_pair(zs, host));
 		iterator.Advance();
 	}
-	return(false);
+
+	ZoneServer* best = nullptr;
+	uint32 best_score = 0;
+	uint32 client_weight = RuleI(World, ZoneBootClientWeight);
+	uint32 tick_weight = RuleI(World, ZoneBootTickWeight);
+	uint32 tick_budget = RuleI(Zone, TickProfileBudget) > 0 ? RuleI(Zone, TickProfileBudget) * 1000 : 1000;
+	std::vector<std::pair<ZoneServer*, std::string> >::iterator cur, end;
+	cur = candidates.begin();
+	end = candidates.end();
+	for(; cur != end; ++cur) {
+		const HostLoad &h = hosts[cur->second];
+		//percent of the host busy, by whichever of its load average and its zones' cpu says more
+		uint32 busy = h.load;
+		uint32 zone_busy = h.zone_cpu / 100 / (h.cpus > 0 ? h.cpus : 1);
+		if(zone_busy > busy)
+			busy = zone_busy;
+		uint32 tick_pct = (uint32)((uint64)h.tick * 100 / tick_budget);
+		uint32 score = busy + tick_pct * tick_weight / 100 + h.clients * client_weight;
+		//ties keep list order, which is what booting on the first idle zone did
+		if(best == nullptr || score < best_score) {
+			best = cur->first;
+			best_score = score;
+		}
+	}
+
+	if(best != nullptr && candidates.size() > 1)
+		_log(WORLD__ZONELIST, "Placing boot on zoneserver #%d (%s), host score %u of %d idle zones", best->GetID(), best->GetLaunchName(), best_score, (int)candidates.size());
+	return best;
 }
 
-bool ZSList::SendPacket(uint32 ZoneID, uint16 instanceID, ServerPacket* pack) {
+bool ZSList::SendPacket(ServerPacket* pack) {
 	LinkedListIterator<ZoneServer*> iterator(list);
 
 	iterator.Reset();
-	if(instanceID != 0)
-	{
-		while(iterator.MoreElements()) {
-			if(iterator.GetData()->GetInstanceID() == instanceID) {
-				ZoneServer* tmp = iterator.GetData();
-				return(tmp->SendPacket(pack));
-			}
-			iterator.Advance();
-		}
+	while(iterator.MoreElements()) {
+		iterator.GetData()->SendPacket(pack);
+		iterator.Advance();
 	}
-	else
-	{
-		while(iterator.MoreElements()) {
-			if (iterator.GetData()->GetZoneID() == ZoneID
-				&& iterator.GetData()->GetInstanceID() == 0) {
-				ZoneServer* tmp = iterator.GetData();
-				return(tmp->SendPacket(pack));
-			}
-			iterator.Advance();
-		}
+	return true;
+}
+
+bool ZSList::SendPacket(uint32 ZoneID, ServerPacket* pack) {
+	ZoneServer* tmp = FindByZoneID(ZoneID);
+	if (tmp == nullptr && ZoneID != 0) {
+		//only instanced copies of the zone are up, any of them will do
+		std::unordered_multimap<uint32, ZoneServer*>::iterator res = by_zone.find(ZoneID);
+		if (res != by_zone.end())
+			tmp = res->second;
 	}
-	return(false);
+	if (tmp == nullptr)
+		return(false);
+	return(tmp->SendPacket(pack));
+}
+
+bool ZSList::SendPacket(uint32 ZoneID, uint16 instanceID, ServerPacket* pack) {
+	ZoneServer* tmp;
+	if(instanceID != 0)
+		tmp = FindByInstanceID(instanceID);
+	else
+		tmp = FindByZoneID(ZoneID);
+
+	if (tmp == nullptr)
+		return(false);
+	return(tmp->SendPacket(pack));
 }
 
 ZoneServer* ZSList::FindByName(const char* zonename) {
@@ -185,20 +362,23 @@ ZoneServer* ZSList::FindByName(const char* zonename) {
 }
 
 ZoneServer* ZSList::FindByID(uint32 ZoneID) {
-	LinkedListIterator<ZoneServer*> iterator(list);
+	std::unordered_map<uint32, ZoneServer*>::iterator res = by_id.find(ZoneID);
+	if (res == by_id.end())
+		return 0;
+	return res->second;
+}
 
-	iterator.Reset();
-	while(iterator.MoreElements()) {
-		if (iterator.GetData()->GetID() == ZoneID) {
-			ZoneServer* tmp = iterator.GetData();
-			return tmp;
+ZoneServer* ZSList::FindByZoneID(uint32 ZoneID) {
+	if (ZoneID != 0) {
+		std::pair<std::unordered_multimap<uint32, ZoneServer*>::iterator, std::unordered_multimap<uint32, ZoneServer*>::iterator> range = by_zone.equal_range(ZoneID);
+		for(std::unordered_multimap<uint32, ZoneServer*>::iterator cur = range.first; cur != range.second; ++cur) {
+			if (cur->second->GetInstanceID() == 0)
+				return cur->second;
 		}
-		iterator.Advance();
+		return 0;
 	}
-	return 0;
-}
 
-ZoneServer* ZSList::FindByZoneID(uint32 ZoneID) {
+	//idle zone servers aren't indexed
 	LinkedListIterator<ZoneServer*> iterator(list);
 	iterator.Reset();
 	while(iterator.MoreElements())
@@ -229,6 +409,13 @@ ZoneServer* ZSList::FindByPort(uint16 port) {
 
 ZoneServer* ZSList::FindByInstanceID(uint32 InstanceID)
 {
+	if (InstanceID != 0) {
+		std::unordered_multimap<uint32, ZoneServer*>::iterator res = by_instance.find(InstanceID);
+		if (res == by_instance.end())
+			return 0;
+		return res->second;
+	}
+
 	LinkedListIterator<ZoneServer*> iterator(list);
 
 	iterator.Reset();
@@ -243,6 +430,21 @@ ZoneServer* ZSList::FindByInstanceID(uint32 InstanceID)
 	return 0;
 }
 
+ZoneServer* ZSList::FindByLaunchedName(const char* launcher_name, const char* launched_name)
+{
+	LinkedListIterator<ZoneServer*> iterator(list);
+
+	iterator.Reset();
+	while(iterator.MoreElements())
+	{
+		ZoneServer* tmp = iterator.GetData();
+		if (strcmp(tmp->GetLaunchName(), launcher_name) == 0 && strcmp(tmp->GetLaunchedName(), launched_name) == 0)
+			return tmp;
+		iterator.Advance();
+	}
+	return 0;
+}
+
 bool ZSList::SetLockedZone(uint16 iZoneID, bool iLock) {
 	for (int i=0; i<MaxLockedZones; i++) {
 		if (iLock) {
@@ -381,6 +583,65 @@ void ZSList::SendZoneStatus(const char* to, int16 admin, WorldTCPConnection* con
 	safe_delete(output);
 }
 
+//zoneserver_id 0 lists the tick totals of every zone, otherwise every section of that zone
+void ZSList::SendZoneProfile(const char* to, WorldTCPConnection* connection, uint32 zoneserver_id) {
+	const char *eol = connection->IsConsole() ? "\r\n" : "^";
+	char* output = 0;
+	uint32 outsize = 0, outlen = 0;
+
+	if (zoneserver_id != 0) {
+		ZoneServer* zs = FindByID(zoneserver_id);
+		if (zs == nullptr) {
+			connection->SendEmoteMessage(to, 0, 0, 0, "Zoneserver #%u not found.", zoneserver_id);
+			return;
+		}
+
+		const ServerZoneTickProfile_Struct* tp = zs->GetTickProfile();
+		if (tp == nullptr) {
+			connection->SendEmoteMessage(to, 0, 0, 0, "Zoneserver #%u has not reported a profile.", zoneserver_id);
+			return;
+		}
+
+		AppendAnyLenString(&output, &outsize, &outlen, "#%i %s (%i:%i), last %u ticks, reported %us ago, usec per tick:%s",
+			zs->GetID(), zs->GetZoneName(), tp->zone_id, tp->instance_id, tp->ticks, zs->GetTickProfileAge() / 1000, eol);
+		for (int i = 0; i < TickSectionCount; i++) {
+			const TickSectionSummary &s = tp->sections[i];
+			AppendAnyLenString(&output, &outsize, &outlen, "  %-8s p50 %7u  p99 %7u  max %7u  avg %7u%s",
+				TickProfiler::SectionName(i), s.p50, s.p99, s.max, s.avg, eol);
+		}
+		AppendAnyLenString(&output, &outsize, &outlen, "%u ticks over the %ums budget in the last %us.",
+			tp->over_budget, tp->budget / 1000, tp->interval / 1000);
+		connection->SendEmoteMessageRaw(to, 0, 0, 10, output);
+		safe_delete(output);
+		return;
+	}
+
+	AppendAnyLenString(&output, &outsize, &outlen, "Zone main loop usec per tick:%s", eol);
+	int x = 0;
+	LinkedListIterator<ZoneServer*> iterator(list);
+	iterator.Reset();
+	while(iterator.MoreElements()) {
+		ZoneServer* zs = iterator.GetData();
+		const ServerZoneTickProfile_Struct* tp = zs->GetTickProfile();
+		if (tp != nullptr) {
+			const TickSectionSummary &s = tp->sections[TickSectionTotal];
+			AppendAnyLenString(&output, &outsize, &outlen, "  #%-3i %-16s p50 %7u  p99 %7u  max %7u  over budget %u in %us%s",
+				zs->GetID(), zs->GetZoneName(), s.p50, s.p99, s.max, tp->over_budget, tp->interval / 1000, eol);
+			if (outlen >= 3584) {
+				connection->SendEmoteMessageRaw(to, 0, 0, 10, output);
+				safe_delete(output);
+				outsize = 0;
+				outlen = 0;
+			}
+			x++;
+		}
+		iterator.Advance();
+	}
+	AppendAnyLenString(&output, &outsize, &outlen, "%i zones reporting, use zoneprofile [ZoneServerID] for a breakdown.", x);
+	connection->SendEmoteMessageRaw(to, 0, 0, 10, output);
+	safe_delete(output);
+}
+
 void ZSList::SendChannelMessage(const char* from, const char* to, uint8 chan_num, uint8 language, const char* message, ...) {
 	if (!message)
 		return;
@@ -609,47 +870,27 @@ uint16	ZSList::GetAvailableZonePort()
 uint32 ZSList::TriggerBootup(uint32 iZoneID, uint32 iInstanceID) {
 	if(iInstanceID > 0)
 	{
-		LinkedListIterator<ZoneServer*> iterator(list);
-		iterator.Reset();
-		while(iterator.MoreElements()) {
-			if(iterator.GetData()->GetInstanceID() == iInstanceID)
-			{
-				return iterator.GetData()->GetID();
-			}
-			iterator.Advance();
-		}
-
-		iterator.Reset();
-		while(iterator.MoreElements()) {
-			if (iterator.GetData()->GetZoneID() == 0 && !iterator.GetData()->IsBootingUp()) {
-				ZoneServer* zone=iterator.GetData();
-				zone->TriggerBootup(iZoneID, iInstanceID);
-				return zone->GetID();
-			}
-			iterator.Advance();
+		ZoneServer* running = FindByInstanceID(iInstanceID);
+		if (running)
+			return running->GetID();
+
+		ZoneServer* zone = FindBootTarget();
+		if (zone) {
+			zone->TriggerBootup(iZoneID, iInstanceID);
+			return zone->GetID();
 		}
 		return 0;
 	}
 	else
 	{
-		LinkedListIterator<ZoneServer*> iterator(list);
-		iterator.Reset();
-		while(iterator.MoreElements()) {
-			if(iterator.GetData()->GetZoneID() == iZoneID && iterator.GetData()->GetInstanceID() == 0)
-			{
-				return iterator.GetData()->GetID();
-			}
-			iterator.Advance();
-		}
-
-		iterator.Reset();
-		while(iterator.MoreElements()) {
-			if (iterator.GetData()->GetZoneID() == 0 && !iterator.GetData()->IsBootingUp()) {
-				ZoneServer* zone=iterator.GetData();
-				zone->TriggerBootup(iZoneID);
-				return zone->GetID();
-			}
-			iterator.Advance();
+		ZoneServer* running = FindByZoneID(iZoneID);
+		if (running)
+			return running->GetID();
+
+		ZoneServer* zone = FindBootTarget();
+		if (zone) {
+			zone->TriggerBootup(iZoneID);
+			return zone->GetID();
 		}
 		return 0;
 	}
@@ -6,6 +6,7 @@
 #include "../common/timer.h"
 #include "../common/linked_list.h"
 #include <vector>
+#include <unordered_map>
 
 class WorldTCPConnection;
 class ServerPacket;
@@ -25,6 +26,9 @@ public:
 	ZoneServer* FindByZoneID(uint32 ZoneID);
 	ZoneServer*	FindByPort(uint16 port);
 	ZoneServer* FindByInstanceID(uint32 InstanceID);
+	ZoneServer* FindByLaunchedName(const char* launcher_name, const char* launched_name);
+	//called by a zone server once it has moved from old_zone/old_instance
+	void	ZoneIDsChanged(ZoneServer* zs, uint32 old_zone, uint32 old_instance);
 
 	void	SendChannelMessage(const char* from, const char* to, uint8 chan_num, uint8 language, const char* message, ...);
 	void	SendChannelMessageRaw(const char* from, const char* to, uint8 chan_num, uint8 language, const char* message);
@@ -32,6 +36,7 @@ public:
 	void	SendEmoteMessageRaw(const char* to, uint32 to_guilddbid, int16 to_minstatus, uint32 type, const char* message);
 
 	void	SendZoneStatus(const char* to, int16 admin, WorldTCPConnection* connection);
+	void	SendZoneProfile(const char* to, WorldTCPConnection* connection, uint32 zoneserver_id = 0);
 
 	void	SendTimeSync();
 	void	Add(ZoneServer* zoneserver);
@@ -43,6 +48,8 @@ public:
 	inline uint32	GetNextID()		{ return NextID++; }
 	void	RebootZone(const char* ip1,uint16 port, const char* ip2, uint32 skipid, uint32 zoneid = 0);
 	uint32	TriggerBootup(uint32 iZoneID, uint32 iInstanceID = 0);
+	//the idle zone server a boot should go to, nullptr if there are none
+	ZoneServer* FindBootTarget();
 	void	SOPZoneBootup(const char* adminname, uint32 ZoneServerID, const char* zonename, bool iMakeStatic = false);
 	EQTime	worldclock;
 	bool	SetLockedZone(uint16 iZoneID, bool iLock);
@@ -59,12 +66,22 @@ public:
 	void WorldShutDown(uint32 time, uint32 interval);
 
 protected:
+	void	CheckStandbyZones();
+	void	IndexZone(ZoneServer* zs);
+	void	UnindexZone(ZoneServer* zs, uint32 zone, uint32 instance);
+	void	Remove(ZoneServer* zs);
+
 	uint32 NextID;
 	LinkedList<ZoneServer*> list;
+	//indexes over list: by ZoneServer::GetID, and by the zone and instance id of every
+	//server with a zone up. Servers without a zone or instance aren't in those two.
+	std::unordered_map<uint32, ZoneServer*> by_id;
+	std::unordered_multimap<uint32, ZoneServer*> by_zone;
+	std::unordered_multimap<uint32, ZoneServer*> by_instance;
 	uint16	pLockedZones[MaxLockedZones];
 	uint32 CurGroupID;
 	uint16 LastAllocatedPort;
-
+	Timer	standby_timer;
 
 };
 
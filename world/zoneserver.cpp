@@ -34,6 +34,8 @@
 #include "wguild_mgr.h"
 #include "ucs.h"
 #include "queryserv.h"
+#include "LauncherList.h"
+#include "LauncherLink.h"
 
 extern ClientList client_list;
 extern ZSList zoneserver_list;
@@ -42,6 +44,7 @@ extern LoginServerList loginserverlist;
 extern volatile bool RunLoops;
 extern UCSConnection UCSLink;
 extern QueryServConnection QSLink;
+extern LauncherList launcher_list;
 void CatchSignal(int sig_num);
 
 ZoneServer::ZoneServer(EmuTCPConnection* itcpc)
@@ -58,6 +61,12 @@ ZoneServer::ZoneServer(EmuTCPConnection* itcpc)
 	authenticated = false;
 	staticzone = false;
 	pNumPlayers = 0;
+	has_tick_profile = false;
+	tick_profile_time = 0;
+	memset(&tick_profile, 0, sizeof(tick_profile));
+	has_load = false;
+	load_time = 0;
+	memset(&load, 0, sizeof(load));
 }
 
 ZoneServer::~ZoneServer() {
@@ -66,6 +75,15 @@ ZoneServer::~ZoneServer() {
 	tcpc->Free();
 }
 
+void ZoneServer::SetZoneIDs(uint32 iZoneID, uint32 iInstanceID) {
+	uint32 old_zone = zoneID;
+	uint32 old_instance = instanceID;
+	zoneID = iZoneID;
+	instanceID = iInstanceID;
+	if (old_zone != zoneID || old_instance != instanceID)
+		zoneserver_list.ZoneIDsChanged(this, old_zone, old_instance);
+}
+
 bool ZoneServer::SetZone(uint32 iZoneID, uint32 iInstanceID, bool iStaticZone) {
 	BootingUp = false;
 
@@ -76,8 +94,8 @@ bool ZoneServer::SetZone(uint32 iZoneID, uint32 iInstanceID, bool iStaticZone) {
 		zlog(WORLD__ZONE,"Setting to '%s' (%d:%d)%s",(zn) ? zn : "",iZoneID, iInstanceID,
 			iStaticZone ? " (Static)" : "");
 
-	zoneID = iZoneID;
-	instanceID = iInstanceID;
+	SetZoneIDs(iZoneID, iInstanceID);
+	has_tick_profile = false;
 	if(iZoneID!=0)
 		oldZoneID = iZoneID;
 	if (zoneID == 0) {
@@ -583,6 +601,11 @@ bool ZoneServer::Process() {
 				launcher_name = ln->launcher_name;
 				launched_name = ln->zone_name;
 				zlog(WORLD__ZONE, "Zone started with name %s by launcher %s", launched_name.c_str(), launcher_name.c_str());
+				if(IsWarm() && zoneID == 0) {
+					LauncherLink *ll = launcher_list.Get(launcher_name.c_str());
+					if(ll != nullptr)
+						ll->WarmReady(launched_name.c_str());
+				}
 				break;
 			}
 			case ServerOP_ShutdownAll: {
@@ -1220,6 +1243,25 @@ bool ZoneServer::Process() {
 				zoneserver_list.SendPacket(pack);
 				break;
 			}
+			case ServerOP_ZoneTickProfile: {
+				if (pack->size != sizeof(ServerZoneTickProfile_Struct))
+					break;
+				ServerZoneTickProfile_Struct* tp = (ServerZoneTickProfile_Struct*) pack->pBuffer;
+				if (tp->zone_id != zoneID || tp->instance_id != instanceID)
+					break;
+				memcpy(&tick_profile, tp, sizeof(tick_profile));
+				tick_profile_time = Timer::GetCurrentTime();
+				has_tick_profile = true;
+				break;
+			}
+			case ServerOP_ZoneLoad: {
+				if (pack->size != sizeof(ServerZoneLoad_Struct))
+					break;
+				memcpy(&load, pack->pBuffer, sizeof(load));
+				load_time = Timer::GetCurrentTime();
+				has_load = true;
+				break;
+			}
 			case ServerOP_DepopAllPlayersCorpses:
 			case ServerOP_DepopPlayerCorpse:
 			case ServerOP_ReloadTitles:
@@ -1303,8 +1345,7 @@ void ZoneServer::ChangeWID(uint32 iCharID, uint32 iWID) {
 
 void ZoneServer::TriggerBootup(uint32 iZoneID, uint32 iInstanceID, const char* adminname, bool iMakeStatic) {
 	BootingUp = true;
-	zoneID = iZoneID;
-	instanceID = iInstanceID;
+	SetZoneIDs(iZoneID, iInstanceID);
 
 	ServerPacket* pack = new ServerPacket(ServerOP_ZoneBootup, sizeof(ServerZoneStateChange_struct));
 	ServerZoneStateChange_struct* s = (ServerZoneStateChange_struct *) pack->pBuffer;
@@ -20,12 +20,16 @@
 
 #include "WorldTCPConnection.h"
 #include "../common/EmuTCPConnection.h"
+#include "../common/servertalk.h"
 #include <string.h>
 #include <string>
 
 class Client;
 class ServerPacket;
 
+//ms a zone's load report is used for, a few missed reports and it is ignored
+#define ZONE_LOAD_MAX_AGE 30000
+
 
 class ZoneServer : public WorldTCPConnection {
 public:
@@ -65,10 +69,23 @@ public:
 	inline void			RemovePlayer()		{ pNumPlayers--; }
 	inline const char * GetLaunchName() const { return(launcher_name.c_str()); }
 	inline const char * GetLaunchedName() const { return(launched_name.c_str()); }
+	inline void			SetLaunchedName(const char *n) { launched_name = n; }
+	//an idle process its launcher keeps for static zones, not used for other boots
+	inline bool			IsWarm() const { return(launched_name.compare(0, 5, "warm_") == 0); }
 
 	inline uint32		GetInstanceID() { return instanceID; }
 	inline void			SetInstanceID(uint32 i) { instanceID = i; }
+
+	//the last main loop profile the zone reported for the zone it is running now, nullptr if none
+	inline const ServerZoneTickProfile_Struct* GetTickProfile() const { return has_tick_profile ? &tick_profile : nullptr; }
+	//ms since the tick profile was received
+	inline uint32		GetTickProfileAge() const { return Timer::GetCurrentTime() - tick_profile_time; }
+	//the process and host load the zone last reported, nullptr if none or too old to trust
+	inline const ServerZoneLoad_Struct* GetLoad() const { return (has_load && Timer::GetCurrentTime() - load_time < ZONE_LOAD_MAX_AGE) ? &load : nullptr; }
 private:
+	//changes the zone and instance, keeping zoneserver_list's index in step
+	void	SetZoneIDs(uint32 iZoneID, uint32 iInstanceID);
+
 	EmuTCPConnection* const tcpc;
 
 	uint32	ID;
@@ -87,6 +104,12 @@ private:
 	uint32	instanceID;	//instance ids contain a zone id, and a zone version
 	std::string launcher_name;	//the launcher which started us
 	std::string launched_name;	//the name of the zone we launched.
+	bool	has_tick_profile;
+	uint32	tick_profile_time;
+	ServerZoneTickProfile_Struct tick_profile;
+	bool	has_load;
+	uint32	load_time;
+	ServerZoneLoad_Struct load;
 };
 
 #endif
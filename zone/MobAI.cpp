@@ -552,7 +552,7 @@ void Mob::AI_Stop() {
 }
 
 void NPC::AI_Stop() {
-	Waypoints.clear();
+	waypoint_grid.reset();
 	safe_delete(AIautocastspell_timer);
 }
 
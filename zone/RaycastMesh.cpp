@@ -643,98 +643,39 @@ public:
 			}
 		}
 
-
-		virtual void raycast(bool &hit,
-							const RmReal *from,
-							const RmReal *to,
-							const RmReal *dir,
-							RmReal *hitLocation,
-							RmReal *hitNormal,
-							RmReal *hitDistance,
-							const RmReal *vertices,
-							const RmUint32 *indices,
-							RmReal &nearestDistance,
-							NodeInterface *callback,
-							RmUint32 *raycastTriangles,
-							RmUint32 raycastFrame,
-							const TriVector &leafTriangles,
-							RmUint32 &nearestTriIndex)
-		{
-			RmReal sect[3];
-			RmReal nd = nearestDistance;
-			if ( !intersectLineSegmentAABB(mBounds.mMin,mBounds.mMax,from,dir,nd,sect) )
-			{
-				return;	
-			}
-			if ( mLeafTriangleIndex != TRI_EOF )
-			{
-				const RmUint32 *scan = &leafTriangles[mLeafTriangleIndex];
-				RmUint32 count = *scan++;
-				for (RmUint32 i=0; i<count; i++)
-				{
-					RmUint32 tri = *scan++;
-					if ( raycastTriangles[tri] != raycastFrame )
-					{
-						raycastTriangles[tri] = raycastFrame;
-						RmUint32 i1 = indices[tri*3+0];
-						RmUint32 i2 = indices[tri*3+1];
-						RmUint32 i3 = indices[tri*3+2];
-
-						const RmReal *p1 = &vertices[i1*3];
-						const RmReal *p2 = &vertices[i2*3];
-						const RmReal *p3 = &vertices[i3*3];
-
-						RmReal t;
-						if ( rayIntersectsTriangle(from,dir,p1,p2,p3,t))
-						{
-							bool accept = false;
-							if ( t == nearestDistance && tri < nearestTriIndex )
-							{
-								accept = true;
-							}
-							if ( t < nearestDistance || accept )
-							{
-								nearestDistance = t;
-								if ( hitLocation )
-								{
-									hitLocation[0] = from[0]+dir[0]*t;
-									hitLocation[1] = from[1]+dir[1]*t;
-									hitLocation[2] = from[2]+dir[2]*t;
-								}
-								if ( hitNormal )
-								{
-									callback->getFaceNormal(tri,hitNormal);
-								}
-								if ( hitDistance )
-								{
-									*hitDistance = t;
-								}
-								nearestTriIndex = tri;
-								hit = true;
-							}
-						}
-					}
-				}
-			}
-			else
-			{
-				if ( mLeft )
-				{
-					mLeft->raycast(hit,from,to,dir,hitLocation,hitNormal,hitDistance,vertices,indices,nearestDistance,callback,raycastTriangles,raycastFrame,leafTriangles,nearestTriIndex);
-				}
-				if ( mRight )
-				{
-					mRight->raycast(hit,from,to,dir,hitLocation,hitNormal,hitDistance,vertices,indices,nearestDistance,callback,raycastTriangles,raycastFrame,leafTriangles,nearestTriIndex);
-				}
-			}
-		}
-
 		NodeAABB		*mLeft;			// left node
 		NodeAABB		*mRight;		// right node
 		BoundsAABB		mBounds;		// bounding volume of node
 		RmUint32		mLeafTriangleIndex;	// if it is a leaf node; then these are the triangle indices.
 	};
 
+
+// The tree as it is queried. Children are indices into the node array instead of pointers so
+// the whole thing can be written out and raycast straight from a mapped file.
+struct FlatNodeAABB
+{
+	RmReal		mMin[3];
+	RmReal		mMax[3];
+	RmUint32	mLeft;				// TRI_EOF if there is no left node
+	RmUint32	mRight;				// TRI_EOF if there is no right node
+	RmUint32	mLeafTriangleIndex;	// TRI_EOF if this is not a leaf node
+};
+
+#define RAYCAST_MESH_MAGIC 0x48534D52	// "RMSH"
+#define RAYCAST_MESH_VERSION 1
+
+// Serialized layout: this header followed by the vertices, the triangle indices, the nodes
+// and the leaf triangle lists. Everything is 4 byte aligned so it can be used in place.
+struct SerializedHeader
+{
+	RmUint32	mMagic;
+	RmUint32	mVersion;
+	RmUint32	mVcount;
+	RmUint32	mTcount;
+	RmUint32	mNodeCount;
+	RmUint32	mLeafCount;
+};
+
 class MyRaycastMesh : public RaycastMesh, public NodeInterface
 {
 public:
@@ -758,24 +699,66 @@ public:
 		}
 		mNodes = new NodeAABB[mMaxNodeCount];
 		mNodeCount = 0;
+		mVertexStore.assign(vertices,vertices+vcount*3);
+		mIndexStore.assign(indices,indices+tcount*3);
 		mVcount = vcount;
-		mVertices = (RmReal *)::malloc(sizeof(RmReal)*3*vcount);
-		memcpy(mVertices,vertices,sizeof(RmReal)*3*vcount);
+		mVertices = mVertexStore.empty() ? NULL : &mVertexStore[0];
 		mTcount = tcount;
-		mIndices = (RmUint32 *)::malloc(sizeof(RmUint32)*tcount*3);
-		memcpy(mIndices,indices,sizeof(RmUint32)*tcount*3);
+		mIndices = mIndexStore.empty() ? NULL : &mIndexStore[0];
 		mRaycastTriangles = (RmUint32 *)::malloc(tcount*sizeof(RmUint32));
 		memset(mRaycastTriangles,0,tcount*sizeof(RmUint32));
-		mRoot = getNode();
 		mFaceNormals = NULL;
-		new ( mRoot ) NodeAABB(mVcount,mVertices,mTcount,mIndices,maxDepth,minLeafSize,minAxisSize,this,mLeafTriangles);
+		NodeAABB *root = getNode();
+		new ( root ) NodeAABB(mVcount,mVertices,mTcount,mIndexStore.empty() ? NULL : &mIndexStore[0],maxDepth,minLeafSize,minAxisSize,this,mLeafStore);
+
+		// the pointer tree is only needed while splitting
+		mFlatStore.resize(mNodeCount);
+		for (RmUint32 i=0; i<mNodeCount; i++)
+		{
+			const NodeAABB &src = mNodes[i];
+			FlatNodeAABB &dest = mFlatStore[i];
+			memcpy(dest.mMin,src.mBounds.mMin,sizeof(dest.mMin));
+			memcpy(dest.mMax,src.mBounds.mMax,sizeof(dest.mMax));
+			dest.mLeft = src.mLeft ? (RmUint32)(src.mLeft - mNodes) : TRI_EOF;
+			dest.mRight = src.mRight ? (RmUint32)(src.mRight - mNodes) : TRI_EOF;
+			dest.mLeafTriangleIndex = src.mLeafTriangleIndex;
+		}
+		delete []mNodes;
+		mNodes = NULL;
+
+		mFlatNodes = &mFlatStore[0];
+		mFlatNodeCount = (RmUint32)mFlatStore.size();
+		mLeafTriangles = mLeafStore.empty() ? NULL : &mLeafStore[0];
+		mLeafCount = (RmUint32)mLeafStore.size();
+	}
+
+	// Uses a serialized mesh in place, the memory has to outlive the mesh.
+	MyRaycastMesh(const SerializedHeader *header)
+	{
+		const RmUint32 *data = (const RmUint32 *)(header+1);
+		mRaycastFrame = 0;
+		mNodes = NULL;
+		mNodeCount = 0;
+		mMaxNodeCount = 0;
+		mVcount = header->mVcount;
+		mVertices = (const RmReal *)data;
+		data+=mVcount*3;
+		mTcount = header->mTcount;
+		mIndices = data;
+		data+=mTcount*3;
+		mFlatNodeCount = header->mNodeCount;
+		mFlatNodes = (const FlatNodeAABB *)data;
+		data+=mFlatNodeCount*(sizeof(FlatNodeAABB)/sizeof(RmUint32));
+		mLeafCount = header->mLeafCount;
+		mLeafTriangles = data;
+		mRaycastTriangles = (RmUint32 *)::malloc(mTcount*sizeof(RmUint32));
+		memset(mRaycastTriangles,0,mTcount*sizeof(RmUint32));
+		mFaceNormals = NULL;
 	}
 
 	~MyRaycastMesh(void)
 	{
 		delete []mNodes;
-		::free(mVertices);
-		::free(mIndices);
 		::free(mFaceNormals);
 		::free(mRaycastTriangles);
 	}
@@ -796,10 +779,90 @@ public:
 		dir[2]*=recipDistance;
 		mRaycastFrame++;
 		RmUint32 nearestTriIndex=TRI_EOF;
-		mRoot->raycast(ret,from,to,dir,hitLocation,hitNormal,hitDistance,mVertices,mIndices,distance,this,mRaycastTriangles,mRaycastFrame,mLeafTriangles,nearestTriIndex);
+		raycastNode(0,ret,from,dir,hitLocation,hitNormal,hitDistance,distance,nearestTriIndex);
 		return ret;
 	}
 
+	void raycastNode(RmUint32 node,
+					bool &hit,
+					const RmReal *from,
+					const RmReal *dir,
+					RmReal *hitLocation,
+					RmReal *hitNormal,
+					RmReal *hitDistance,
+					RmReal &nearestDistance,
+					RmUint32 &nearestTriIndex)
+	{
+		const FlatNodeAABB &n = mFlatNodes[node];
+		RmReal sect[3];
+		RmReal nd = nearestDistance;
+		if ( !intersectLineSegmentAABB(n.mMin,n.mMax,from,dir,nd,sect) )
+		{
+			return;
+		}
+		if ( n.mLeafTriangleIndex != TRI_EOF )
+		{
+			const RmUint32 *scan = &mLeafTriangles[n.mLeafTriangleIndex];
+			RmUint32 count = *scan++;
+			for (RmUint32 i=0; i<count; i++)
+			{
+				RmUint32 tri = *scan++;
+				if ( mRaycastTriangles[tri] != mRaycastFrame )
+				{
+					mRaycastTriangles[tri] = mRaycastFrame;
+					RmUint32 i1 = mIndices[tri*3+0];
+					RmUint32 i2 = mIndices[tri*3+1];
+					RmUint32 i3 = mIndices[tri*3+2];
+
+					const RmReal *p1 = &mVertices[i1*3];
+					const RmReal *p2 = &mVertices[i2*3];
+					const RmReal *p3 = &mVertices[i3*3];
+
+					RmReal t;
+					if ( rayIntersectsTriangle(from,dir,p1,p2,p3,t))
+					{
+						bool accept = false;
+						if ( t == nearestDistance && tri < nearestTriIndex )
+						{
+							accept = true;
+						}
+						if ( t < nearestDistance || accept )
+						{
+							nearestDistance = t;
+							if ( hitLocation )
+							{
+								hitLocation[0] = from[0]+dir[0]*t;
+								hitLocation[1] = from[1]+dir[1]*t;
+								hitLocation[2] = from[2]+dir[2]*t;
+							}
+							if ( hitNormal )
+							{
+								getFaceNormal(tri,hitNormal);
+							}
+							if ( hitDistance )
+							{
+								*hitDistance = t;
+							}
+							nearestTriIndex = tri;
+							hit = true;
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			if ( n.mLeft != TRI_EOF )
+			{
+				raycastNode(n.mLeft,hit,from,dir,hitLocation,hitNormal,hitDistance,nearestDistance,nearestTriIndex);
+			}
+			if ( n.mRight != TRI_EOF )
+			{
+				raycastNode(n.mRight,hit,from,dir,hitLocation,hitNormal,hitDistance,nearestDistance,nearestTriIndex);
+			}
+		}
+	}
+
 	virtual void release(void)
 	{
 		delete this;
@@ -807,11 +870,39 @@ public:
 
 	virtual const RmReal * getBoundMin(void) const // return the minimum bounding box
 	{
-		return mRoot->mBounds.mMin;
+		return mFlatNodes[0].mMin;
 	}
 	virtual const RmReal * getBoundMax(void) const // return the maximum bounding box.
 	{
-		return mRoot->mBounds.mMax;
+		return mFlatNodes[0].mMax;
+	}
+
+	virtual RmUint32 getSerializedSize(void) const
+	{
+		return sizeof(SerializedHeader) + sizeof(RmReal)*3*mVcount + sizeof(RmUint32)*3*mTcount +
+			sizeof(FlatNodeAABB)*mFlatNodeCount + sizeof(RmUint32)*mLeafCount;
+	}
+
+	virtual void serialize(void *dest) const
+	{
+		SerializedHeader header;
+		header.mMagic = RAYCAST_MESH_MAGIC;
+		header.mVersion = RAYCAST_MESH_VERSION;
+		header.mVcount = mVcount;
+		header.mTcount = mTcount;
+		header.mNodeCount = mFlatNodeCount;
+		header.mLeafCount = mLeafCount;
+
+		char *out = (char *)dest;
+		memcpy(out,&header,sizeof(header));
+		out+=sizeof(header);
+		memcpy(out,mVertices,sizeof(RmReal)*3*mVcount);
+		out+=sizeof(RmReal)*3*mVcount;
+		memcpy(out,mIndices,sizeof(RmUint32)*3*mTcount);
+		out+=sizeof(RmUint32)*3*mTcount;
+		memcpy(out,mFlatNodes,sizeof(FlatNodeAABB)*mFlatNodeCount);
+		out+=sizeof(FlatNodeAABB)*mFlatNodeCount;
+		memcpy(out,mLeafTriangles,sizeof(RmUint32)*mLeafCount);
 	}
 
 	virtual NodeAABB * getNode(void) 
@@ -904,20 +995,95 @@ public:
 		return ret;
 	}
 
-	RmUint32		mRaycastFrame;
-	RmUint32		*mRaycastTriangles;
-	RmUint32		mVcount;
-	RmReal			*mVertices;
-	RmReal			*mFaceNormals;
-	RmUint32		mTcount;
-	RmUint32		*mIndices;
-	NodeAABB		*mRoot;
-	RmUint32		mNodeCount;
-	RmUint32		mMaxNodeCount;
-	NodeAABB		*mNodes;
-	TriVector		mLeafTriangles;
+	RmUint32			mRaycastFrame;
+	RmUint32			*mRaycastTriangles;
+	RmUint32			mVcount;
+	const RmReal		*mVertices;
+	RmReal				*mFaceNormals;
+	RmUint32			mTcount;
+	const RmUint32		*mIndices;
+	RmUint32			mFlatNodeCount;
+	const FlatNodeAABB	*mFlatNodes;
+	RmUint32			mLeafCount;
+	const RmUint32		*mLeafTriangles;
+	// only used while building
+	RmUint32			mNodeCount;
+	RmUint32			mMaxNodeCount;
+	NodeAABB			*mNodes;
+	// storage for a mesh built in this process, empty when the mesh is used in place
+	std::vector< RmReal >		mVertexStore;
+	TriVector					mIndexStore;
+	std::vector< FlatNodeAABB >	mFlatStore;
+	TriVector					mLeafStore;
 };
 
+// Checks everything the raycast trusts so a damaged file can't send it outside the buffer.
+static bool validateSerialized(const SerializedHeader *header,RmUint32 size)
+{
+	if ( header->mMagic != RAYCAST_MESH_MAGIC || header->mVersion != RAYCAST_MESH_VERSION )
+	{
+		return false;
+	}
+	if ( header->mNodeCount == 0 )
+	{
+		return false;
+	}
+	unsigned long long expected = sizeof(SerializedHeader);
+	expected+=(unsigned long long)sizeof(RmReal)*3*header->mVcount;
+	expected+=(unsigned long long)sizeof(RmUint32)*3*header->mTcount;
+	expected+=(unsigned long long)sizeof(FlatNodeAABB)*header->mNodeCount;
+	expected+=(unsigned long long)sizeof(RmUint32)*header->mLeafCount;
+	if ( expected != size )
+	{
+		return false;
+	}
+
+	const RmUint32 *indices = (const RmUint32 *)(header+1) + header->mVcount*3;
+	for (RmUint32 i=0; i<header->mTcount*3; i++)
+	{
+		if ( indices[i] >= header->mVcount )
+		{
+			return false;
+		}
+	}
+
+	const FlatNodeAABB *nodes = (const FlatNodeAABB *)(indices + header->mTcount*3);
+	const RmUint32 *leaf = (const RmUint32 *)(nodes + header->mNodeCount);
+	for (RmUint32 i=0; i<header->mNodeCount; i++)
+	{
+		const FlatNodeAABB &n = nodes[i];
+		// children always come after their parent, which also rules out cycles
+		if ( n.mLeft != TRI_EOF && (n.mLeft <= i || n.mLeft >= header->mNodeCount) )
+		{
+			return false;
+		}
+		if ( n.mRight != TRI_EOF && (n.mRight <= i || n.mRight >= header->mNodeCount) )
+		{
+			return false;
+		}
+		if ( n.mLeafTriangleIndex != TRI_EOF )
+		{
+			if ( n.mLeafTriangleIndex >= header->mLeafCount )
+			{
+				return false;
+			}
+			RmUint32 count = leaf[n.mLeafTriangleIndex];
+			if ( count > header->mLeafCount - n.mLeafTriangleIndex - 1 )
+			{
+				return false;
+			}
+			for (RmUint32 j=0; j<count; j++)
+			{
+				if ( leaf[n.mLeafTriangleIndex+1+j] >= header->mTcount )
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
 };
 
 
@@ -938,4 +1104,17 @@ RaycastMesh * createRaycastMesh(RmUint32 vcount,		// The number of vertices in t
 	return static_cast< RaycastMesh * >(m);
 }
 
-
+RaycastMesh * createRaycastMeshInPlace(const void *data,RmUint32 size)
+{
+	if ( data == NULL || size < sizeof(SerializedHeader) || ((size_t)data & 3) != 0 )
+	{
+		return NULL;
+	}
+	const SerializedHeader *header = (const SerializedHeader *)data;
+	if ( !validateSerialized(header,size) )
+	{
+		return NULL;
+	}
+	MyRaycastMesh *m = new MyRaycastMesh(header);
+	return static_cast< RaycastMesh * >(m);
+}
@@ -41,6 +41,8 @@ public:
 
 	virtual const RmReal * getBoundMin(void) const = 0; // return the minimum bounding box
 	virtual const RmReal * getBoundMax(void) const = 0; // return the maximum bounding box.
+	virtual RmUint32 getSerializedSize(void) const = 0; // bytes needed to serialize the mesh and its tree.
+	virtual void serialize(void *dest) const = 0; // writes getSerializedSize() bytes to dest.
 	virtual void release(void) = 0;
 protected:
 	virtual ~RaycastMesh(void) { };
@@ -56,5 +58,10 @@ RaycastMesh * createRaycastMesh(RmUint32 vcount,		// The number of vertices in t
 								RmReal	minAxisSize=0.01f	// once a particular axis is less than this size, stop sub-dividing.
 								);
 
+// Uses a mesh written by RaycastMesh::serialize without copying it, e.g. straight out of a mapped file.
+// The data must be 4 byte aligned and stay valid until the mesh is released. Returns NULL if the data
+// is not a valid serialized mesh.
+RaycastMesh * createRaycastMeshInPlace(const void *data,RmUint32 size);
+
 
 #endif
\ No newline at end of file
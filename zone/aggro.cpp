@@ -35,10 +35,12 @@ extern Zone* zone;
 //look around a client for things which might aggro the client.
 void EntityList::CheckClientAggro(Client *around)
 {
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
-		Mob *mob = it->second;
-		if (mob->IsClient())	//also ensures that mob != around
-			continue;
+	// CheckWillAggro uses each npc's own aggro range, so gather everything the widest one could reach
+	std::vector<NPC *> close_npcs;
+	GetNPCsInRange(around->GetX(), around->GetY(), npc_aggro_range_max, close_npcs);
+
+	for (auto it = close_npcs.begin(); it != close_npcs.end(); ++it) {
+		Mob *mob = *it;
 
 		if (mob->CheckWillAggro(around)) {
 			if (mob->IsEngaged())
@@ -361,15 +363,20 @@ Mob* EntityList::AICheckCloseAggro(Mob* sender, float iAggroRange, float iAssist
 	if (!sender || !sender->IsNPC())
 		return(nullptr);
 
+	//CheckWillAggro only looks as far as the sender's own aggro range
+	std::vector<Mob *> close_mobs;
 #ifdef REVERSE_AGGRO
 	//with reverse aggro, npc->client is checked elsewhere, no need to check again
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
+	std::vector<NPC *> close_npcs;
+	GetNPCsInRange(sender->GetX(), sender->GetY(), sender->GetAggroRange(), close_npcs);
+	close_mobs.insert(close_mobs.end(), close_npcs.begin(), close_npcs.end());
 #else
-	auto it = mob_list.begin();
-	while (it != mob_list.end()) {
+	GetMobsInRange(sender->GetX(), sender->GetY(), sender->GetAggroRange(), close_mobs);
 #endif
-		Mob *mob = it->second;
+
+	auto it = close_mobs.begin();
+	while (it != close_mobs.end()) {
+		Mob *mob = *it;
 
 		if (sender->CheckWillAggro(mob))
 			return mob;
@@ -387,8 +394,11 @@ int EntityList::GetHatedCount(Mob *attacker, Mob *exclude)
 
 	int Count = 0;
 
-	for (auto it = npc_list.begin(); it != npc_list.end(); ++it) {
-		NPC *mob = it->second;
+	std::vector<NPC *> close_npcs;
+	GetNPCsInRange(attacker->GetX(), attacker->GetY(), npc_aggro_range_max, close_npcs);
+
+	for (auto it = close_npcs.begin(); it != close_npcs.end(); ++it) {
+		NPC *mob = *it;
 		if (!mob || (mob == exclude))
 			continue;
 
@@ -933,7 +943,7 @@ bool Mob::CheckLosFN(float posX, float posY, float posZ, float mobSize) {
 #if LOSDEBUG>=5
 	LogFile->write(EQEMuLog::Debug, "LOS from (%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f) sizes: (%.2f, %.2f)", myloc.x, myloc.y, myloc.z, oloc.x, oloc.y, oloc.z, GetSize(), mobSize);
 #endif
-	return zone->zonemap->CheckLoS(myloc, oloc);
+	return zone->los_cache.CheckLoS(zone->zonemap, myloc, oloc);
 }
 
 //offensive spell aggro
@@ -75,6 +75,9 @@ void Client::CalcBonuses()
 
 	CalcSpellBonuses(&spellbonuses);
 
+	//item faction bonuses were just rebuilt
+	ClearFactionConCache();
+
 	_log(AA__BONUSES, "Calculating AA Bonuses for %s.", this->GetCleanName());
 	CalcAABonuses(&aabonuses);	//we're not quite ready for this
 	_log(AA__BONUSES, "Finished calculating AA Bonuses for %s.", this->GetCleanName());
@@ -76,6 +76,7 @@ bool commandlogged;
 char entirecommand[255];
 extern DBAsyncFinishedQueue MTdbafq;
 extern DBAsync *dbasync;
+extern TimerWheel timer_wheel;
 
 Client::Client(EQStreamInterface* ieqs)
 : Mob("No name",	// name
@@ -131,30 +132,33 @@ Client::Client(EQStreamInterface* ieqs)
 
 	),
 	//these must be listed in the order they appear in client.h
-	position_timer(100), //WAS 250 CAVEDUDE
-	hpupdate_timer(1800),
-	camp_timer(29000),
+	position_timer(this, &Client::PositionUpdateExpired),
+	hpupdate_timer(this, &Client::HPUpdateExpired),
+	mana_timer(this, &Client::ManaUpdateExpired),
+	camp_timer(this, &Client::CampExpired),
 	process_timer(100),
 	stamina_timer(40000),
 	zoneinpacket_timer(3000),
-	linkdead_timer(RuleI(Zone,ClientLinkdeadMS)),
+	linkdead_timer(this, &Client::LinkdeadExpired),
 	dead_timer(2000),
 	global_channel_timer(1000),
-	shield_timer(500),
+	shield_timer(this, &Client::ShieldExpired),
+	bindwound_timer(this, &Client::BindWoundExpired),
 	fishing_timer(8000),
-	endupkeep_timer(1000),
-	forget_timer(0),
-	autosave_timer(RuleI(Character, AutosaveIntervalS)*1000),
+	endupkeep_timer(this, &Client::EnduranceUpkeepExpired),
+	forget_timer(this, &Client::ForgetExpired),
+	autosave_timer(this, &Client::AutosaveExpired),
 #ifdef REVERSE_AGGRO
 	scanarea_timer(AIClientScanarea_delay),
 #endif
 	proximity_timer(ClientProximity_interval),
-	charm_update_timer(6000),
+	charm_update_timer(this, &Client::CharmUpdateExpired),
 	rest_timer(1),
 	charm_class_attacks_timer(3000),
 	charm_cast_timer(3500),
-	qglobal_purge_timer(30000),
+	qglobal_purge_timer(this, &Client::QGlobalPurgeExpired),
 	TrackingTimer(2000),
+	KarmaUpdateTimer(this, &Client::KarmaUpdateExpired),
 	ItemTickTimer(10000),
 	ItemQuestTimer(500)
 {
@@ -175,6 +179,11 @@ Client::Client(EQStreamInterface* ieqs)
 	CustomerID = 0;
 	TrackingID = 0;
 	WID = 0;
+	faction_con_cache_race = 0;
+	faction_con_cache_class = 0;
+	faction_con_cache_deity = 0;
+	faction_con_cache_hits = 0;
+	faction_con_cache_misses = 0;
 	account_id = 0;
 	admin = 0;
 	lsaccountid = 0;
@@ -194,7 +203,7 @@ Client::Client(EQStreamInterface* ieqs)
 	SetTarget(0);
 	auto_attack = false;
 	auto_fire = false;
-	linkdead_timer.Disable();
+	linkdead_expired = false;
 	zonesummon_x = -2;
 	zonesummon_y = -2;
 	zonesummon_z = -2;
@@ -209,12 +218,10 @@ Client::Client(EQStreamInterface* ieqs)
 	npcflag = false;
 	npclevel = 0;
 	pQueuedSaveWorkID = 0;
+	save_dirty = SaveSectionAll;
 	position_timer_counter = 0;
 	fishing_timer.Disable();
-	shield_timer.Disable();
 	dead_timer.Disable();
-	camp_timer.Disable();
-	autosave_timer.Disable();
 	instalog = false;
 	pLastUpdate = 0;
 	pLastUpdateWZ = 0;
@@ -237,11 +244,14 @@ Client::Client(EQStreamInterface* ieqs)
 	//for good measure:
 	memset(&m_pp, 0, sizeof(m_pp));
 	memset(&m_epp, 0, sizeof(m_epp));
+	memset(&m_saved_pp, 0, sizeof(m_saved_pp));
+	memset(&m_saved_epp, 0, sizeof(m_saved_epp));
+	memset(&m_saved_petinfo, 0, sizeof(m_saved_petinfo));
+	memset(&m_saved_suspendedminion, 0, sizeof(m_saved_suspendedminion));
 	PendingTranslocate = false;
 	PendingSacrifice = false;
 	BoatID = 0;
 
-	KarmaUpdateTimer = new Timer(RuleI(Chat, KarmaUpdateIntervalMS));
 	GlobalChatLimiterTimer = new Timer(RuleI(Chat, IntervalDurationMS));
 	AttemptedMessages = 0;
 	TotalKarma = 0;
@@ -287,6 +297,16 @@ Client::Client(EQStreamInterface* ieqs)
 
 	last_used_slot = -1;
 //	walkspeed = 0.46;
+
+	timer_wheel.Schedule(&position_timer, 100);
+	timer_wheel.Schedule(&hpupdate_timer, 1800);
+	timer_wheel.Schedule(&mana_timer, 2000);
+	timer_wheel.Schedule(&endupkeep_timer, 1000);
+	timer_wheel.Schedule(&charm_update_timer, 6000);
+	timer_wheel.Schedule(&qglobal_purge_timer, 30000);
+	if(RuleI(Chat, KarmaUpdateIntervalMS) > 0)
+		timer_wheel.Schedule(&KarmaUpdateTimer, RuleI(Chat, KarmaUpdateIntervalMS));
+	timer_wheel.Schedule(&tic_timer, 6000);
 }
 
 Client::~Client() {
@@ -344,7 +364,6 @@ Client::~Client() {
 	// will need this data right away
 	Save(2); // This fails when database destructor is called first on shutdown
 
-	safe_delete(KarmaUpdateTimer);
 	safe_delete(GlobalChatLimiterTimer);
 	safe_delete(qGlobals);
 
@@ -475,17 +494,11 @@ bool Client::Save(uint8 iCommitNow) {
 	m_pp.mana = cur_mana;
 	m_pp.endurance = cur_end;
 
-	database.SaveBuffs(this);
-
 	TotalSecondsPlayed += (time(nullptr) - m_pp.lastlogin);
 	m_pp.timePlayedMin = (TotalSecondsPlayed / 60);
 	m_pp.RestTimer = rest_timer.GetRemainingTime() / 1000;
 
 	m_pp.lastlogin = time(nullptr);
-	if (pQueuedSaveWorkID) {
-		dbasync->CancelWork(pQueuedSaveWorkID);
-		pQueuedSaveWorkID = 0;
-	}
 
 	if (GetPet() && !GetPet()->IsFamiliar() && GetPet()->CastToNPC()->GetPetSpellID() && !dead) {
 		NPC *pet = GetPet()->CastToNPC();
@@ -498,13 +511,58 @@ bool Client::Save(uint8 iCommitNow) {
 	} else {
 		memset(&m_petinfo, 0, sizeof(struct PetInfo));
 	}
-	database.SavePetInfo(this);
 
-	p_timers.Store(&database);
+	// Work out which sections changed since the last save. lastlogin moves on every
+	// save so it alone doesnt make the profile dirty, but a sync save (zoning, logging
+	// out) always writes it so played time is never lost.
+	uint32 dirty = save_dirty;
+	save_dirty = 0;
+
+	m_saved_pp.lastlogin = m_pp.lastlogin;
+	if (iCommitNow == 2 || pQueuedSaveWorkID
+		|| memcmp(&m_pp, &m_saved_pp, sizeof(PlayerProfile_Struct))
+		|| memcmp(&m_epp, &m_saved_epp, sizeof(ExtendedProfile_Struct)))
+		dirty |= SaveSectionProfile;
+
+	uint32 buff_count = GetMaxBuffSlots();
+	if (m_saved_buffs.size() != buff_count || (buff_count > 0 && memcmp(&m_saved_buffs[0], GetBuffs(), sizeof(Buffs_Struct) * buff_count)))
+		dirty |= SaveSectionBuffs;
+
+	if (memcmp(&m_petinfo, &m_saved_petinfo, sizeof(PetInfo)) || memcmp(&m_suspendedminion, &m_saved_suspendedminion, sizeof(PetInfo)))
+		dirty |= SaveSectionPet;
+
+	uint32 written = 0;
+
+	if (dirty & SaveSectionBuffs) {
+		written += database.SaveBuffs(this);
+		m_saved_buffs.assign(GetBuffs(), GetBuffs() + buff_count);
+	}
+
+	if (dirty & SaveSectionPet) {
+		written += database.SavePetInfo(this);
+		memcpy(&m_saved_petinfo, &m_petinfo, sizeof(PetInfo));
+		memcpy(&m_saved_suspendedminion, &m_suspendedminion, sizeof(PetInfo));
+	}
+
+	// timers keep their own dirty flags
+	p_timers.Store(&database, &written);
 
 //	printf("Dumping inventory on save:\n");
 //	m_inv.dumpEntireInventory();
 
+	if (!(dirty & SaveSectionProfile)) {
+		_log(CLIENT__SAVE, "Save of %s: profile unchanged, sections 0x%x, %u bytes written", GetName(), dirty, written);
+		return true;
+	}
+
+	if (pQueuedSaveWorkID) {
+		dbasync->CancelWork(pQueuedSaveWorkID);
+		pQueuedSaveWorkID = 0;
+	}
+
+	memcpy(&m_saved_pp, &m_pp, sizeof(PlayerProfile_Struct));
+	memcpy(&m_saved_epp, &m_epp, sizeof(ExtendedProfile_Struct));
+
 	if (iCommitNow <= 1) {
 		char* query = 0;
 		uint32_breakdown workpt;
@@ -512,7 +570,10 @@ bool Client::Save(uint8 iCommitNow) {
 		workpt.w2_3() = GetID();
 		workpt.b1() = DBA_b1_Entity_Client_Save;
 		DBAsyncWork* dbaw = new DBAsyncWork(&database, &MTdbafq, workpt, DBAsync::Write, 0xFFFFFFFF);
-		dbaw->AddQuery(iCommitNow == 0 ? true : false, &query, database.SetPlayerProfile_MQ(&query, account_id, character_id, &m_pp, &m_inv, &m_epp, 0, 0), false);
+		dbaw->SetCoalesceKey(DBAsyncWork::MakeCoalesceKey(DBA_Coalesce_Character, character_id));
+		uint32 len = database.SetPlayerProfile_MQ(&query, account_id, character_id, &m_pp, &m_inv, &m_epp, 0, 0);
+		written += len;
+		dbaw->AddQuery(iCommitNow == 0 ? true : false, &query, len, false);
 		if (iCommitNow == 0){
 			pQueuedSaveWorkID = dbasync->AddWork(&dbaw, 2500);
 		}
@@ -521,16 +582,19 @@ bool Client::Save(uint8 iCommitNow) {
 			SaveBackup();
 		}
 		safe_delete_array(query);
+		_log(CLIENT__SAVE, "Save of %s: sections 0x%x, %u bytes queued", GetName(), dirty | SaveSectionProfile, written);
 		return true;
 	}
-	else if (database.SetPlayerProfile(account_id, character_id, &m_pp, &m_inv, &m_epp,0,0)) {
+	else if (database.SetPlayerProfile(account_id, character_id, &m_pp, &m_inv, &m_epp, 0, 0, &written)) {
 		SaveBackup();
 	}
 	else {
 		std::cerr << "Failed to update player profile" << std::endl;
+		MarkSaveDirty(SaveSectionProfile);
 		return false;
 	}
 
+	_log(CLIENT__SAVE, "Save of %s: sections 0x%x, %u bytes written", GetName(), dirty | SaveSectionProfile, written);
 	return true;
 }
 
@@ -539,6 +603,7 @@ void Client::SaveBackup() {
 		return;
 	char* query = 0;
 	DBAsyncWork* dbaw = new DBAsyncWork(&database, &DBAsyncCB_CharacterBackup, this->CharacterID(), DBAsync::Read);
+	dbaw->SetCoalesceKey(DBAsyncWork::MakeCoalesceKey(DBA_Coalesce_Character, this->CharacterID()));
 	dbaw->AddQuery(0, &query, MakeAnyLenString(&query, "Select id, UNIX_TIMESTAMP()-UNIX_TIMESTAMP(ts) as age from character_backup where charid=%u and backupreason=0 order by ts asc", this->CharacterID()), true);
 	dbasync->AddWork(&dbaw, 0);
 }
@@ -628,6 +693,24 @@ void Client::QueuePacket(const EQApplicationPacket* app, bool ack_req, CLIENT_CO
 			eqs->QueuePacket(app, ack_req);
 }
 
+//same as above, but the packet is only encoded once for everyone it is queued to
+void Client::QueuePacket(EQBroadcastPacket* bp, bool ack_req, CLIENT_CONN_STATUS required_state, eqFilterType filter) {
+	if(filter!=FilterNone){
+		if(GetFilter(filter) == FilterHide)
+			return; //Client has this filter on, no need to send packet
+	}
+	if(client_state != CLIENT_CONNECTED && required_state == CLIENT_CONNECTED){
+		AddPacket(bp->GetPacket(), ack_req);
+		return;
+	}
+
+	if (required_state != CLIENT_CONNECTINGALL && client_state != required_state)
+		AddPacket(bp->GetPacket(), ack_req);
+	else
+		if(eqs)
+			eqs->QueueBroadcastPacket(bp, ack_req);
+}
+
 void Client::FastQueuePacket(EQApplicationPacket** app, bool ack_req, CLIENT_CONN_STATUS required_state) {
 
 	//std::cout << "Sending: 0x" << std::hex << std::setw(4) << std::setfill('0') << (*app)->GetOpcode() << std::dec << ", size=" << (*app)->size << std::endl;
@@ -2081,9 +2164,9 @@ void Client::SetFeigned(bool in_feigned) {
 		}
 		SetHorseId(0);
 		entity_list.ClearFeignAggro(this);
-		forget_timer.Start(FeignMemoryDuration);
+		timer_wheel.Schedule(&forget_timer, FeignMemoryDuration);
 	} else {
-		forget_timer.Disable();
+		timer_wheel.Cancel(&forget_timer);
 	}
 	feigned=in_feigned;
  }
@@ -2155,7 +2238,7 @@ bool Client::BindWound(Mob* bindmob, bool start, bool fail){
 		outapp = new EQApplicationPacket(OP_Bind_Wound, sizeof(BindWound_Struct));
 		BindWound_Struct* bind_out = (BindWound_Struct*) outapp->pBuffer;
 		// Start bind
-		if(!bindwound_timer.Enabled()) {
+		if(!bindwound_timer.Scheduled()) {
 			//make sure we actually have a bandage... and consume it.
 			int16 bslot = m_inv.HasItemByUse(ItemTypeBandage, 1, invWhereWorn|invWherePersonal);
 			if(bslot == SLOT_INVALID) {
@@ -2168,7 +2251,7 @@ bool Client::BindWound(Mob* bindmob, bool start, bool fail){
 			DeleteItemInInventory(bslot, 1, true);	//do we need client update?
 
 			// start complete timer
-			bindwound_timer.Start(10000);
+			timer_wheel.Schedule(&bindwound_timer, 10000);
 			bindwound_target = bindmob;
 
 			// Send client unlock
@@ -2181,7 +2264,7 @@ bool Client::BindWound(Mob* bindmob, bool start, bool fail){
 				bind_out->type = 4;
 				QueuePacket(outapp);
 				bind_out->type = 0;
-				bindwound_timer.Disable();
+				timer_wheel.Cancel(&bindwound_timer);
 				bindwound_target = 0;
 			}
 			else {
@@ -2204,7 +2287,7 @@ bool Client::BindWound(Mob* bindmob, bool start, bool fail){
 		} else {
 		// finish bind
 			// disable complete timer
-			bindwound_timer.Disable();
+			timer_wheel.Cancel(&bindwound_timer);
 			bindwound_target = 0;
 			if(!bindmob){
 					// send "bindmob gone" to client
@@ -2295,11 +2378,11 @@ bool Client::BindWound(Mob* bindmob, bool start, bool fail){
 			}
 		}
 	}
-	else if (bindwound_timer.Enabled()) {
+	else if (bindwound_timer.Scheduled()) {
 		// You moved
 		outapp = new EQApplicationPacket(OP_Bind_Wound, sizeof(BindWound_Struct));
 		BindWound_Struct* bind_out = (BindWound_Struct*) outapp->pBuffer;
-		bindwound_timer.Disable();
+		timer_wheel.Cancel(&bindwound_timer);
 		bindwound_target = 0;
 		bind_out->type = 7;
 		QueuePacket(outapp);
@@ -2719,7 +2802,7 @@ void Client::LinkDead()
 		raid->MemberZoned(this);
 	}
 //	save_timer.Start(2500);
-	linkdead_timer.Start(RuleI(Zone,ClientLinkdeadMS));
+	timer_wheel.Schedule(&linkdead_timer, RuleI(Zone,ClientLinkdeadMS));
 	SendAppearancePacket(AT_Linkdead, 1);
 	client_state = CLIENT_LINKDEAD;
 	AI_Start(CLIENT_LD_TIMEOUT);
@@ -4946,9 +5029,24 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 	//First get the NPC's Primary faction
 	if(pFaction > 0)
 	{
+		//an illusion changes the race the con is figured for
+		if(p_race != faction_con_cache_race || p_class != faction_con_cache_class || p_deity != faction_con_cache_deity) {
+			faction_con_cache.clear();
+			faction_con_cache_race = p_race;
+			faction_con_cache_class = p_class;
+			faction_con_cache_deity = p_deity;
+		}
+
+		std::unordered_map<int32, FACTION_VALUE>::const_iterator cached = faction_con_cache.find(pFaction);
+		if(cached != faction_con_cache.end())
+		{
+			++faction_con_cache_hits;
+			fac = cached->second;
+		}
 		//Get the faction data from the database
-		if(database.GetFactionData(&fmods, p_class, p_race, p_deity, pFaction))
+		else if(database.GetFactionData(&fmods, p_class, p_race, p_deity, pFaction))
 		{
+			++faction_con_cache_misses;
 			//Get the players current faction with pFaction
 			tmpFactionValue = GetCharacterFactionLevel(pFaction);
 			// Everhood - tack on any bonuses from Alliance type spell effects
@@ -4956,6 +5054,7 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 			tmpFactionValue += GetItemFactionBonus(pFaction);
 			//Return the faction to the client
 			fac = CalculateFaction(&fmods, tmpFactionValue);
+			faction_con_cache[pFaction] = fac;
 		}
 	}
 	else
@@ -4991,6 +5090,7 @@ void Client::SetFactionLevel(uint32 char_id, uint32 npc_id, uint8 char_class, ui
 	// Get the npc faction list
 	if(!database.GetNPCFactionList(npc_id, faction_id, npc_value, temp))
 		return;
+	ClearFactionConCache();
 	for(int i = 0;i<MAX_NPC_FACTIONS;i++)
 	{
 		if(faction_id[i] <= 0)
@@ -5090,6 +5190,7 @@ void Client::SetFactionLevel2(uint32 char_id, int32 faction_id, uint8 char_class
 	if(faction_id > 0 && value != 0) {
 		//Get the faction modifiers
 		current_value = GetCharacterFactionLevel(faction_id) + value;
+		ClearFactionConCache();
 		if(!(database.SetCharacterFactionLevel(char_id, faction_id, current_value, temp, factionvalues)))
 			return;
 
@@ -36,6 +36,7 @@ class Client;
 #include "../common/guilds.h"
 #include "../common/item_struct.h"
 #include "../common/clientversions.h"
+#include "../common/timer_wheel.h"
 
 #include "zonedb.h"
 #include "errno.h"
@@ -226,9 +227,27 @@ public:
 
 	void	FillSpawnStruct(NewSpawn_Struct* ns, Mob* ForWho);
 	virtual bool Process();
+	//run from the zone's timer wheel instead of being polled by Process. Process only
+	//looked at these while we're connected or linkdead, so they skip their work otherwise
+	void HPUpdateExpired();
+	void ManaUpdateExpired();
+	void CharmUpdateExpired();
+	void LinkdeadExpired();
+	void CampExpired();
+	void PositionUpdateExpired();
+	void AutosaveExpired();
+	void QGlobalPurgeExpired();
+	void KarmaUpdateExpired();
+	void ShieldExpired();
+	void BindWoundExpired();
+	void EnduranceUpkeepExpired();
+	void ForgetExpired();
+	virtual void TicExpired();
+	virtual void BardSongExpired();
 	void	LogMerchant(Client* player, Mob* merchant, uint32 quantity, uint32 price, const Item_Struct* item, bool buying);
 	void	SendPacketQueue(bool Block = true);
 	void	QueuePacket(const EQApplicationPacket* app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
+	void	QueuePacket(EQBroadcastPacket* bp, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
 	void	FastQueuePacket(EQApplicationPacket** app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL);
 	void	ChannelMessageReceived(uint8 chan_num, uint8 language, uint8 lang_skill, const char* orig_message, const char* targetname=nullptr);
 	void	ChannelMessageSend(const char* from, const char* to, uint8 chan_num, uint8 language, const char* message, ...);
@@ -254,6 +273,10 @@ public:
 	virtual bool	Save() { return Save(0); }
 			bool	Save(uint8 iCommitNow); // 0 = delayed, 1=async now, 2=sync now
 			void	SaveBackup();
+	// Save() compares each section with what it last wrote and skips the unchanged ones,
+	// this forces sections to be written on the next save.
+	enum SaveSection { SaveSectionProfile = 1, SaveSectionBuffs = 2, SaveSectionPet = 4, SaveSectionAll = 7 };
+	inline void		MarkSaveDirty(uint32 sections) { save_dirty |= sections; }
 
 	inline bool ClientDataLoaded() const { return client_data_loaded; }
 	inline bool	Connected()		const { return (client_state == CLIENT_CONNECTED); }
@@ -508,6 +531,10 @@ public:
 	FACTION_VALUE	GetReverseFactionCon(Mob* iOther);
 	FACTION_VALUE	GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_race, uint32 p_class, uint32 p_deity, int32 pFaction, Mob* tnpc);
 	int32	GetCharacterFactionLevel(int32 faction_id);
+	//forget every cached faction con, for anything that changes a faction value or bonus
+	inline void	ClearFactionConCache() { faction_con_cache.clear(); }
+	inline uint32	GetFactionConCacheHits() const { return faction_con_cache_hits; }
+	inline uint32	GetFactionConCacheMisses() const { return faction_con_cache_misses; }
 	int32	GetModCharacterFactionLevel(int32 faction_id);
 	bool	HatedByClass(uint32 p_race, uint32 p_class, uint32 p_deity, int32 pFaction);
 	void	SendFactionMessage(int32 tmpvalue, int32 faction_id, int32 totalvalue, uint8 temp);
@@ -1026,6 +1053,13 @@ private:
 	PetInfo						m_petinfo; // current pet data, used while loading from and saving to DB
 	PetInfo						m_suspendedminion; // pet data for our suspended minion.
 
+	uint32						save_dirty; // SaveSection flags to write on the next save no matter what
+	PlayerProfile_Struct		m_saved_pp; // what the last save wrote, see Save()
+	ExtendedProfile_Struct		m_saved_epp;
+	PetInfo						m_saved_petinfo;
+	PetInfo						m_saved_suspendedminion;
+	std::vector<Buffs_Struct>	m_saved_buffs;
+
 	void NPCSpawn(const Seperator* sep);
 	uint32 GetEXPForLevel(uint16 level);
 
@@ -1050,32 +1084,35 @@ private:
 	ZoneMode zone_mode;
 
 
-	Timer	position_timer;
+	TimerWheel::Callback<Client>	position_timer;
 	uint8	position_timer_counter;
 
 	PTimerList p_timers;		//persistent timers
-	Timer	hpupdate_timer;
-	Timer	camp_timer;
+	TimerWheel::Callback<Client>	hpupdate_timer;
+	TimerWheel::Callback<Client>	mana_timer;
+	TimerWheel::Callback<Client>	camp_timer;
 	Timer	process_timer;
 	Timer	stamina_timer;
 	Timer	zoneinpacket_timer;
-	Timer	linkdead_timer;
+	TimerWheel::Callback<Client>	linkdead_timer;
+	bool	linkdead_expired;	//set by linkdead_timer, Process drops the client when it sees it
 	Timer	dead_timer;
 	Timer	global_channel_timer;
-	Timer	shield_timer;
+	TimerWheel::Callback<Client>	shield_timer;
+	TimerWheel::Callback<Client>	bindwound_timer;
 	Timer	fishing_timer;
-	Timer	endupkeep_timer;
-	Timer	forget_timer;	// our 2 min everybody forgets you timer
-	Timer	autosave_timer;
+	TimerWheel::Callback<Client>	endupkeep_timer;
+	TimerWheel::Callback<Client>	forget_timer;	// our 2 min everybody forgets you timer
+	TimerWheel::Callback<Client>	autosave_timer;
 #ifdef REVERSE_AGGRO
 	Timer	scanarea_timer;
 #endif
 	Timer	proximity_timer;
-	Timer	charm_update_timer;
+	TimerWheel::Callback<Client>	charm_update_timer;
 	Timer	rest_timer;
 	Timer	charm_class_attacks_timer;
 	Timer	charm_cast_timer;
-	Timer	qglobal_purge_timer;
+	TimerWheel::Callback<Client>	qglobal_purge_timer;
 	Timer	TrackingTimer;
 
 	float	proximity_x;
@@ -1088,6 +1125,15 @@ private:
 
 	faction_map factionvalues;
 
+	//the con CalculateFaction gave for each primary faction, for the race, class and deity
+	//below. Aggro scans ask for the same few factions over and over between changes.
+	std::unordered_map<int32, FACTION_VALUE> faction_con_cache;
+	uint32 faction_con_cache_race;
+	uint32 faction_con_cache_class;
+	uint32 faction_con_cache_deity;
+	uint32 faction_con_cache_hits;
+	uint32 faction_con_cache_misses;
+
 	uint32 tribute_master_id;
 
 	FILE *SQL_log;
@@ -1115,7 +1161,7 @@ private:
 	int TotalSecondsPlayed;
 
 	//Anti Spam Stuff
-	Timer *KarmaUpdateTimer;
+	TimerWheel::Callback<Client> KarmaUpdateTimer;
 	uint32 TotalKarma;
 
 	Timer *GlobalChatLimiterTimer; //60 seconds
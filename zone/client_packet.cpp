@@ -76,6 +76,7 @@ extern PetitionList petition_list;
 extern EntityList entity_list;
 extern DBAsyncFinishedQueue MTdbafq;
 extern DBAsync *dbasync;
+extern TimerWheel timer_wheel;
 
 typedef void (Client::*ClientPacketProc)(const EQApplicationPacket *app);
 
@@ -424,6 +425,7 @@ void Client::Handle_Connect_OP_ZoneEntry(const EQApplicationPacket *app)
 	workpt.w2_3() = GetID();
 	workpt.b1() = DBA_b1_Entity_Client_InfoForLogin;
 	DBAsyncWork* dbaw = new DBAsyncWork(&database, &MTdbafq, workpt, DBAsync::Read);
+	dbaw->SetCoalesceKey(DBAsyncWork::MakeCoalesceKey(DBA_Coalesce_Character, character_id));
 	dbaw->AddQuery(1, &query, MakeAnyLenString(&query,
 		"SELECT status,name,lsaccount_id,gmspeed,revoked,hideme,time_creation FROM account WHERE id=%i",
 		account_id));
@@ -1327,7 +1329,7 @@ void Client::Handle_OP_Shielding(const EQApplicationPacket *app)
 							break;
 					}
 					shield_target->shielder[x].shielder_bonus = shieldbonus;
-					shield_timer.Start();
+					timer_wheel.Schedule(&shield_timer, 500);
 					ack = true;
 					break;
 				}
@@ -1885,7 +1887,7 @@ void Client::Handle_OP_SpawnAppearance(const EQApplicationPacket *app)
 			playeraction = 0;
 			SetFeigned(false);
 			BindWound(this, false, true);
-			camp_timer.Disable();
+			timer_wheel.Cancel(&camp_timer);
 		}
 		else if (sa->parameter == ANIM_SIT) {
 			SetAppearance(eaSitting);
@@ -2205,7 +2207,7 @@ void Client::Handle_OP_Camp(const EQApplicationPacket *app) {
 		OnDisconnect(true);
 		return;
 	}
-	camp_timer.Start(29000,true);
+	timer_wheel.Schedule(&camp_timer, 29000);
 	return;
 }
 
@@ -6466,6 +6468,7 @@ void Client::DBAWComplete(uint8 workpt_b1, DBAsyncWork* dbaw) {
 				Message(13, "Error: Asyncronous save of your character failed.");
 				if (Admin() >= 200)
 					Message(13, "errbuf: %s", errbuf);
+				MarkSaveDirty(SaveSectionProfile);
 			}
 			pQueuedSaveWorkID = 0;
 			break;
@@ -6509,6 +6512,7 @@ bool Client::FinishConnState2(DBAsyncWork* dbaw) {
 		else if (dbaq->QPT() == 3) {
 			database.RemoveTempFactions(this);
 			database.LoadFactionValues_result(result, factionvalues);
+			ClearFactionConCache();
 		}
 		else {
 			std::cout << "Error in FinishConnState2(): dbaq->PQT() unknown" << std::endl;
@@ -7015,9 +7019,10 @@ void Client::CompleteConnect()
 	UpdateWho();
 	client_state = CLIENT_CONNECTED;
 
-	hpupdate_timer.Start();
-	position_timer.Start();
-	autosave_timer.Start();
+	timer_wheel.Schedule(&hpupdate_timer, 1800);
+	timer_wheel.Schedule(&position_timer, 100);
+	if(RuleI(Character, AutosaveIntervalS) > 0)
+		timer_wheel.Schedule(&autosave_timer, RuleI(Character, AutosaveIntervalS) * 1000);
 	SetDuelTarget(0);
 	SetDueling(false);
 
@@ -69,6 +69,7 @@ extern volatile bool ZoneLoaded;
 extern WorldServer worldserver;
 extern PetitionList petition_list;
 extern EntityList entity_list;
+extern TimerWheel timer_wheel;
 
 bool Client::Process() {
 	bool ret = true;
@@ -85,11 +86,6 @@ bool Client::Process() {
 			SetHP(-100);
 		}
 
-		if(hpupdate_timer.Check())
-			SendHPUpdate();
-
-		if(mana_timer.Check())
-			SendManaUpdatePacket();
 		if(dead && dead_timer.Check()) {
 			database.MoveCharacterToZone(GetName(),database.GetZoneName(m_pp.binds[0].zoneId));
 			m_pp.zone_id = m_pp.binds[0].zoneId;
@@ -113,12 +109,7 @@ bool Client::Process() {
 			return(false);
 		}
 
-		if(charm_update_timer.Check())
-		{
-			CalcItemScale();
-		}
-
-		if(linkdead_timer.Check()){
+		if(linkdead_expired){
 			Save();
 			LeaveGroup();
 			Raid *myraid = entity_list.GetRaidByClient(this);
@@ -129,65 +120,14 @@ bool Client::Process() {
 			return false; //delete client
 		}
 
-		if (camp_timer.Check()) {
-			LeaveGroup();
-			Save();
-			instalog = true;
-		}
-
-		if (IsStunned() && stunned_timer.Check()) {
-			this->stunned = false;
-			this->stunned_timer.Disable();
-		}
-
 		if(!m_CheatDetectMoved)
 		{
 			m_TimeSinceLastPositionCheck = Timer::GetCurrentTime();
 		}
 
-		if (bardsong_timer.Check() && bardsong != 0) {
-			//NOTE: this is kinda a heavy-handed check to make sure the mob still exists before
-			//doing the next pulse on them...
-			Mob *song_target;
-			if(bardsong_target_id == GetID()) {
-				song_target = this;
-			} else {
-				song_target = entity_list.GetMob(bardsong_target_id);
-			}
-
-			if (song_target == nullptr) {
-				InterruptSpell(SONG_ENDS_ABRUPTLY, 0x121, bardsong);
-			} else {
-				if(!ApplyNextBardPulse(bardsong, song_target, bardsong_slot))
-					InterruptSpell(SONG_ENDS_ABRUPTLY, 0x121, bardsong);
-//				SpellFinished(bardsong, bardsong_target, bardsong_slot, spells[bardsong].mana);
-			}
-		}
-
 		if(IsAIControlled())
 			AI_Process();
 
-		if (bindwound_timer.Check() && bindwound_target != 0) {
-			BindWound(bindwound_target, false);
-		}
-
-		if(KarmaUpdateTimer)
-		{
-			if(KarmaUpdateTimer->Check(false))
-			{
-				KarmaUpdateTimer->Start(RuleI(Chat, KarmaUpdateIntervalMS));
-				database.UpdateKarma(AccountID(), ++TotalKarma);
-			}
-		}
-
-		if(qGlobals)
-		{
-			if(qglobal_purge_timer.Check())
-			{
-				qGlobals->PurgeExpiredGlobals();
-			}
-		}
-
 		bool may_use_attacks = false;
 		/*
 			Things which prevent us from attacking:
@@ -403,35 +343,6 @@ bool Client::Process() {
 			}
 		}
 
-		if (position_timer.Check()) {
-			if (IsAIControlled())
-			{
-				if(IsMoving())
-					SendPosUpdate(2);
-				else
-				{
-					animation = 0;
-					delta_x = 0;
-					delta_y = 0;
-					delta_z = 0;
-					SendPosUpdate(2);
-				}
-			}
-
-			// Send a position packet every 8 seconds - if not done, other clients
-			// see this char disappear after 10-12 seconds of inactivity
-			if (position_timer_counter >= 16) { // Approx. 4 ticks per second
-				entity_list.SendPositionUpdates(this, pLastUpdateWZ, 500, GetTarget(), true);
-				pLastUpdate = Timer::GetCurrentTime();
-				pLastUpdateWZ = pLastUpdate;
-				position_timer_counter = 0;
-			}
-			else {
-				pLastUpdate = Timer::GetCurrentTime();
-				position_timer_counter++;
-			}
-		}
-
 		if(HasVirus()) {
 			if(viral_timer.Check()) {
 				viral_timer_counter++;
@@ -452,74 +363,7 @@ bool Client::Process() {
 				DoGravityEffect();
 		}
 
-		if (shield_timer.Check())
-		{
-			if (shield_target)
-			{
-				if (!CombatRange(shield_target))
-				{
-					entity_list.MessageClose_StringID(this, false, 100, 0,
-						END_SHIELDING, GetCleanName(), shield_target->GetCleanName());
-					for (int y = 0; y < 2; y++)
-					{
-						if (shield_target->shielder[y].shielder_id == GetID())
-						{
-							shield_target->shielder[y].shielder_id = 0;
-							shield_target->shielder[y].shielder_bonus = 0;
-						}
-					}
-					shield_target = 0;
-					shield_timer.Disable();
-				}
-			}
-			else
-			{
-				shield_target = 0;
-				shield_timer.Disable();
-			}
-		}
-
 		SpellProcess();
-		if (endupkeep_timer.Check() && !dead){
-			DoEnduranceUpkeep();
-		}
-
-		if (tic_timer.Check() && !dead) {
-			CalcMaxHP();
-			CalcMaxMana();
-			CalcATK();
-			CalcMaxEndurance();
-			CalcRestState();
-			DoHPRegen();
-			DoManaRegen();
-			DoEnduranceRegen();
-			BuffProcess();
-			DoStaminaUpdate();
-
-			if (fishing_timer.Check()) {
-				GoFish();
-			}
-
-			if (autosave_timer.Check()) {
-				Save(0);
-			}
-
-			if(m_pp.intoxication > 0)
-			{
-				--m_pp.intoxication;
-				CalcBonuses();
-			}
-
-			if(ItemTickTimer.Check())
-			{
-				TickItemCheck();
-			}
-
-			if(ItemQuestTimer.Check())
-			{
-				ItemTimerCheck();
-			}
-		}
 	}
 
 	if (client_state == CLIENT_KICKED) {
@@ -548,8 +392,8 @@ bool Client::Process() {
 
 		if (GetGM()) 
 			return false;
-		else if(!linkdead_timer.Enabled()){
-			linkdead_timer.Start(RuleI(Zone,ClientLinkdeadMS));
+		else if(!linkdead_timer.Scheduled()){
+			timer_wheel.Schedule(&linkdead_timer, RuleI(Zone,ClientLinkdeadMS));
 			client_state = CLIENT_LINKDEAD;
 			AI_Start(CLIENT_LD_TIMEOUT);
 			SendAppearancePacket(AT_Linkdead, 1);
@@ -620,14 +464,249 @@ bool Client::Process() {
 		}
 		OnDisconnect(true);
 	}
-	// Feign Death 2 minutes and zone forgets you
-	if (forget_timer.Check()) {
-		forget_timer.Disable();
-		entity_list.ClearZoneFeignAggro(this);
-		//Message(0,"Your enemies have forgotten you!");
+	return ret;
+}
+
+void Client::HPUpdateExpired()
+{
+	timer_wheel.Schedule(&hpupdate_timer, 1800);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	SendHPUpdate();
+}
+
+void Client::ManaUpdateExpired()
+{
+	timer_wheel.Schedule(&mana_timer, 2000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	SendManaUpdatePacket();
+}
+
+void Client::CharmUpdateExpired()
+{
+	timer_wheel.Schedule(&charm_update_timer, 6000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	CalcItemScale();
+}
+
+// Process() does the save and returns false to delete the client
+void Client::LinkdeadExpired()
+{
+	linkdead_expired = true;
+}
+
+void Client::CampExpired()
+{
+	if (!Connected() && !IsLD())
+		return;
+
+	LeaveGroup();
+	Save();
+	instalog = true;
+}
+
+void Client::PositionUpdateExpired()
+{
+	timer_wheel.Schedule(&position_timer, 100);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if (IsAIControlled())
+	{
+		if(IsMoving())
+			SendPosUpdate(2);
+		else
+		{
+			animation = 0;
+			delta_x = 0;
+			delta_y = 0;
+			delta_z = 0;
+			SendPosUpdate(2);
+		}
+	}
+
+	// Send a position packet every 8 seconds - if not done, other clients
+	// see this char disappear after 10-12 seconds of inactivity
+	if (position_timer_counter >= 16) { // Approx. 4 ticks per second
+		entity_list.SendPositionUpdates(this, pLastUpdateWZ, 500, GetTarget(), true);
+		pLastUpdate = Timer::GetCurrentTime();
+		pLastUpdateWZ = pLastUpdate;
+		position_timer_counter = 0;
+	}
+	else {
+		pLastUpdate = Timer::GetCurrentTime();
+		position_timer_counter++;
 	}
+}
 
-	return ret;
+void Client::AutosaveExpired()
+{
+	timer_wheel.Schedule(&autosave_timer, RuleI(Character, AutosaveIntervalS) * 1000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	Save(0);
+}
+
+void Client::QGlobalPurgeExpired()
+{
+	timer_wheel.Schedule(&qglobal_purge_timer, 30000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if(qGlobals)
+		qGlobals->PurgeExpiredGlobals();
+}
+
+void Client::KarmaUpdateExpired()
+{
+	timer_wheel.Schedule(&KarmaUpdateTimer, RuleI(Chat, KarmaUpdateIntervalMS));
+
+	if (!Connected() && !IsLD())
+		return;
+
+	database.UpdateKarma(AccountID(), ++TotalKarma);
+}
+
+void Client::ShieldExpired()
+{
+	timer_wheel.Schedule(&shield_timer, 500);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if (shield_target)
+	{
+		if (!CombatRange(shield_target))
+		{
+			entity_list.MessageClose_StringID(this, false, 100, 0,
+				END_SHIELDING, GetCleanName(), shield_target->GetCleanName());
+			for (int y = 0; y < 2; y++)
+			{
+				if (shield_target->shielder[y].shielder_id == GetID())
+				{
+					shield_target->shielder[y].shielder_id = 0;
+					shield_target->shielder[y].shielder_bonus = 0;
+				}
+			}
+			shield_target = 0;
+			timer_wheel.Cancel(&shield_timer);
+		}
+	}
+	else
+	{
+		shield_target = 0;
+		timer_wheel.Cancel(&shield_timer);
+	}
+}
+
+void Client::BindWoundExpired()
+{
+	timer_wheel.Schedule(&bindwound_timer, 10000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if (bindwound_target != 0)
+		BindWound(bindwound_target, false);
+}
+
+void Client::EnduranceUpkeepExpired()
+{
+	timer_wheel.Schedule(&endupkeep_timer, 1000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if (!dead)
+		DoEnduranceUpkeep();
+}
+
+// Feign Death 2 minutes and zone forgets you
+void Client::ForgetExpired()
+{
+	entity_list.ClearZoneFeignAggro(this);
+	//Message(0,"Your enemies have forgotten you!");
+}
+
+void Client::TicExpired()
+{
+	timer_wheel.Schedule(&tic_timer, 6000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if (dead)
+		return;
+
+	CalcMaxHP();
+	CalcMaxMana();
+	CalcATK();
+	CalcMaxEndurance();
+	CalcRestState();
+	DoHPRegen();
+	DoManaRegen();
+	DoEnduranceRegen();
+	BuffProcess();
+	DoStaminaUpdate();
+
+	if (fishing_timer.Check()) {
+		GoFish();
+	}
+
+	if(m_pp.intoxication > 0)
+	{
+		--m_pp.intoxication;
+		CalcBonuses();
+	}
+
+	if(ItemTickTimer.Check())
+	{
+		TickItemCheck();
+	}
+
+	if(ItemQuestTimer.Check())
+	{
+		ItemTimerCheck();
+	}
+}
+
+void Client::BardSongExpired()
+{
+	timer_wheel.Schedule(&bardsong_timer, 6000);
+
+	if (!Connected() && !IsLD())
+		return;
+
+	if (bardsong == 0)
+		return;
+
+	//NOTE: this is kinda a heavy-handed check to make sure the mob still exists before
+	//doing the next pulse on them...
+	Mob *song_target;
+	if(bardsong_target_id == GetID()) {
+		song_target = this;
+	} else {
+		song_target = entity_list.GetMob(bardsong_target_id);
+	}
+
+	if (song_target == nullptr) {
+		InterruptSpell(SONG_ENDS_ABRUPTLY, 0x121, bardsong);
+	} else {
+		if(!ApplyNextBardPulse(bardsong, song_target, bardsong_slot))
+			InterruptSpell(SONG_ENDS_ABRUPTLY, 0x121, bardsong);
+	}
 }
 
 //just a set of actions preformed all over in Client::Process
@@ -267,6 +267,8 @@ int command_init(void){
 		command_add("logs","[status|normal|error|debug|quest|all] - Subscribe to a log type",250,command_logs) ||
 		command_add("logsql","- enable SQL logging",200,command_logsql) ||
 		command_add("los",nullptr,0,command_checklos) ||
+		command_add("hatelistbench","[entries] [rounds] - Time a simulated raid (72 entries by default) on your target's hate list",200,command_hatelistbench) ||
+		command_add("loscache","[stats|clear|record|stop|benchmark] - Line of sight cache stats and replay benchmark",200,command_loscache) ||
 		
 		command_add("makepet","[level] [class] [race] [texture] - Make a pet",50,command_makepet) ||
 		command_add("mana","- Fill your or your target's mana",50,command_mana) ||
@@ -6032,6 +6034,57 @@ void command_checklos(Client *c, const Seperator *sep){
 	}
 }
 
+void command_loscache(Client *c, const Seperator *sep){
+	if(!strcasecmp(sep->arg[1], "clear"))
+	{
+		zone->los_cache.Clear();
+		c->Message(0, "LOS cache cleared.");
+	}
+	else if(!strcasecmp(sep->arg[1], "record"))
+	{
+		zone->los_cache.StartRecording();
+		c->Message(0, "Recording up to %i line of sight checks, use #loscache benchmark to replay them.", LOS_CACHE_RECORD_MAX);
+		return;
+	}
+	else if(!strcasecmp(sep->arg[1], "stop"))
+	{
+		zone->los_cache.StopRecording();
+	}
+	else if(!strcasecmp(sep->arg[1], "benchmark"))
+	{
+		if(!zone->zonemap)
+		{
+			c->Message(0, "This zone has no map.");
+			return;
+		}
+
+		zone->los_cache.StopRecording();
+		zone->los_cache.Benchmark(c, zone->zonemap);
+		return;
+	}
+
+	zone->los_cache.ShowStats(c);
+}
+
+void command_hatelistbench(Client *c, const Seperator *sep){
+	Mob *center = c->GetTarget();
+	if(!center)
+	{
+		c->Message(0, "Usage: #hatelistbench [entries] [rounds] (requires a target)");
+		return;
+	}
+
+	uint32 entries = sep->IsNumber(1) ? atoi(sep->arg[1]) : 72;
+	uint32 rounds = sep->IsNumber(2) ? atoi(sep->arg[2]) : 1000;
+	if(entries == 0 || rounds == 0 || rounds > 100000)
+	{
+		c->Message(0, "Entries must be at least 1 and rounds between 1 and 100000.");
+		return;
+	}
+
+	HateList::Benchmark(c, center, entries, rounds);
+}
+
 void command_npcsay(Client *c, const Seperator *sep){
 	if(c->GetTarget() && c->GetTarget()->IsNPC() && sep->arg[1][0])
 	{
@@ -6958,6 +7011,8 @@ void command_path(Client *c, const Seperator *sep)
 		c->Message(0, "#path move: Moves your targeted node to your current position");
 		c->Message(0, "#path process file_name: processes the map file and tries to automatically generate a rudimentary path setup and then dumps the current zone->pathing to a file of your naming.");
 		c->Message(0, "#path resort [nodes]: resorts the connections/nodes after you've manually altered them so they'll work.");
+		c->Message(0, "#path benchmark [count]: times count random node to node route searches and nearest node lookups.");
+		c->Message(0, "#path cache [clear]: shows the route cache hit/miss counters, or empties the route cache.");
 		return;
 	}
 	if(!strcasecmp(sep->arg[1], "shownodes"))
@@ -7215,6 +7270,29 @@ void command_path(Client *c, const Seperator *sep)
 		}
 	}
 
+	if(!strcasecmp(sep->arg[1], "cache"))
+	{
+		if(zone->pathing)
+		{
+			if(!strcasecmp(sep->arg[2], "clear"))
+			{
+				zone->pathing->ClearRouteCache();
+				c->Message(0, "Route cache cleared.");
+			}
+			zone->pathing->ShowRouteCacheStats(c);
+			return;
+		}
+	}
+
+	if(!strcasecmp(sep->arg[1], "benchmark"))
+	{
+		if(zone->pathing)
+		{
+			zone->pathing->RouteBenchmark(c, atoi(sep->arg[2]));
+			return;
+		}
+	}
+
 	if(!strcasecmp(sep->arg[1], "allspawns"))
 	{
 		if(zone->pathing)
@@ -7341,6 +7419,9 @@ void command_aggro(Client *c, const Seperator *sep){
 	}
 
 	entity_list.DescribeAggro(c, c->GetTarget()->CastToNPC(), d, verbose);
+
+	if(verbose)
+		c->Message(0, "Your faction con cache: %u hits, %u misses.", c->GetFactionConCacheHits(), c->GetFactionConCacheMisses());
 }
 
 void command_pf(Client *c, const Seperator *sep){
@@ -7380,6 +7461,13 @@ void command_bestz(Client *c, const Seperator *sep){
 		{
 			c->Message(0, "Found no Z.");
 		}
+
+		if (zone->zonemap->HasHeightField())
+		{
+			uint32 hits, fallbacks;
+			zone->zonemap->GetHeightFieldStats(hits, fallbacks);
+			c->Message(0, "Height field answered %u of %u FindBestZ calls.", hits, hits + fallbacks);
+		}
 	}
 
 	if(zone->watermap == nullptr) {
@@ -247,6 +247,8 @@ void command_ipban(Client *c, const Seperator *sep);
 void command_oocmute(Client *c, const Seperator *sep);
 void command_revoke(Client *c, const Seperator *sep);
 void command_checklos(Client *c, const Seperator *sep);
+void command_hatelistbench(Client *c, const Seperator *sep);
+void command_loscache(Client *c, const Seperator *sep);
 void command_npcsay(Client *c, const Seperator *sep);
 void command_npcshout(Client *c, const Seperator *sep);
 void command_npcemote(Client *c, const Seperator *sep);
@@ -40,12 +40,23 @@ Child of the Mob class.
 #include "StringIDs.h"
 #include "worldserver.h"
 #include "../common/rulesys.h"
+#include "../common/breakdowns.h"
 #include "QuestParserCollection.h"
 
 extern EntityList entity_list;
 extern Zone* zone;
 extern WorldServer worldserver;
 extern npcDecayTimes_Struct npcCorpseDecayTimes[100];
+extern DBAsyncFinishedQueue MTdbafq;
+extern DBAsync *dbasync;
+
+// Corpse::Save updates existing corpses from the DBAsync workers. Everything else touching
+// player_corpses runs on the main connection, so it lets those go out first to not be
+// overwritten by, or read around, an older save.
+static void CommitCorpseWrites() {
+	if (dbasync)
+		dbasync->CommitWrites(DBA_Coalesce_Corpse);
+}
 
 void Corpse::SendEndLootErrorPacket(Client* client) {
 	EQApplicationPacket* outapp = new EQApplicationPacket(OP_LootComplete, 0);
@@ -586,8 +597,20 @@ bool Corpse::Save() {
 		if(RuleB(Zone, UsePlayerCorpseBackups) == true)
 			database.CreatePlayerCorpseBackup(dbid, charid, orgname, zone->GetZoneID(), zone->GetInstanceID(), (uchar*) dbpc, tmpsize, x_pos, y_pos, z_pos, heading);
 	}
-	else
-		dbid = database.UpdatePlayerCorpse(dbid, charid, orgname, zone->GetZoneID(), zone->GetInstanceID(), (uchar*) dbpc, tmpsize, x_pos, y_pos, z_pos, heading,Rezzed());
+	else {
+		//looting saves once per item, when the workers are behind only the last one is written
+		char* query = 0;
+		uint32_breakdown workpt;
+		workpt.b4() = DBA_b4_Entity;
+		workpt.w2_3() = GetID();
+		workpt.b1() = DBA_b1_Entity_Corpse_Save;
+		DBAsyncWork* dbaw = new DBAsyncWork(&database, &MTdbafq, workpt, DBAsync::Write, 0xFFFFFFFF);
+		dbaw->SetCoalesceKey(DBAsyncWork::MakeCoalesceKey(DBA_Coalesce_Corpse, dbid));
+		uint32 len = database.UpdatePlayerCorpse_MQ(&query, dbid, charid, orgname, zone->GetZoneID(), zone->GetInstanceID(), (uchar*) dbpc, tmpsize, x_pos, y_pos, z_pos, heading, Rezzed());
+		dbaw->AddQuery(0, &query, len, false);
+		dbasync->AddWork(&dbaw, 0);
+		safe_delete_array(query);
+	}
 	safe_delete_array(dbpc);
 	if (dbid == 0) {
 		std::cout << "Error: Failed to save player corpse '" << this->GetName() << "'" << std::endl;
@@ -596,6 +619,23 @@ bool Corpse::Save() {
 	return true;
 }
 
+void Corpse::DBAWComplete(uint8 workpt_b1, DBAsyncWork* dbaw) {
+	Entity::DBAWComplete(workpt_b1, dbaw);
+	switch (workpt_b1) {
+		case DBA_b1_Entity_Corpse_Save: {
+			char errbuf[MYSQL_ERRMSG_SIZE] = "dbaq == 0";
+			DBAsyncQuery* dbaq = dbaw->PopAnswer();
+			if (!dbaq || !dbaq->GetAnswer(errbuf))
+				LogFile->write(EQEMuLog::Error, "Async save of player corpse '%s' (%u) failed: %s", GetName(), dbid, errbuf);
+			break;
+		}
+		default: {
+			std::cout << "Error: Corpse::DBAWComplete(): Unknown workpt_b1" << std::endl;
+			break;
+		}
+	}
+}
+
 void Corpse::Delete() {
 	if (IsPlayerCorpse() && dbid != 0)
 		database.DeletePlayerCorpse(dbid);
@@ -1466,6 +1506,8 @@ uint32 ZoneDatabase::GraveyardPlayerCorpse(uint32 dbid, uint32 zoneid, uint16 in
 	char* end = query;
 	uint32 affected_rows = 0;
 
+	CommitCorpseWrites();
+
 	// We probably don't want a graveyard located in an instance.
 	end += sprintf(end,"Update player_corpses SET zoneid=%u, instanceid=0, x=%1.1f, y=%1.1f, z=%1.1f, heading=%1.1f, WasAtGraveyard=1 WHERE id=%d", zoneid, x, y, z, heading, dbid);
 
@@ -1482,19 +1524,26 @@ uint32 ZoneDatabase::GraveyardPlayerCorpse(uint32 dbid, uint32 zoneid, uint16 in
 	}
 	return dbid;
 }
-uint32 ZoneDatabase::UpdatePlayerCorpse(uint32 dbid, uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading, bool rezzed) {
-	char errbuf[MYSQL_ERRMSG_SIZE];
-	char* query = new char[256+(datasize*2)];
-	char* end = query;
-	uint32 affected_rows = 0;
+uint32 ZoneDatabase::UpdatePlayerCorpse_MQ(char** query, uint32 dbid, uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading, bool rezzed) {
+	*query = new char[256+(datasize*2)];
+	char* end = *query;
 
 	end += sprintf(end, "Update player_corpses SET data=");
 	*end++ = '\'';
 	end += DoEscapeString(end, (char*)data, datasize);
 	*end++ = '\'';
-	end += sprintf(end,", charname='%s', zoneid=%u, instanceid=%u, charid=%d, x=%1.1f, y=%1.1f, z=%1.1f, heading=%1.1f WHERE id=%d", charname, zoneid, instanceid, charid, x, y, z, heading, dbid);
+	end += sprintf(end,", charname='%s', zoneid=%u, instanceid=%u, charid=%d, x=%1.1f, y=%1.1f, z=%1.1f, heading=%1.1f%s WHERE id=%d", charname, zoneid, instanceid, charid, x, y, z, heading, rezzed ? ", rezzed=1" : "", dbid);
+	return (uint32) (end - *query);
+}
 
-	if (!RunQuery(query, (uint32) (end - query), errbuf, 0, &affected_rows)) {
+uint32 ZoneDatabase::UpdatePlayerCorpse(uint32 dbid, uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading, bool rezzed) {
+	char errbuf[MYSQL_ERRMSG_SIZE];
+	char* query = 0;
+	uint32 affected_rows = 0;
+
+	CommitCorpseWrites();
+	uint32 len = UpdatePlayerCorpse_MQ(&query, dbid, charid, charname, zoneid, instanceid, data, datasize, x, y, z, heading, rezzed);
+	if (!RunQuery(query, len, errbuf, 0, &affected_rows)) {
 		safe_delete_array(query);
 		std::cerr << "Error1 in UpdatePlayerCorpse query " << errbuf << std::endl;
 		return 0;
@@ -1505,12 +1554,6 @@ uint32 ZoneDatabase::UpdatePlayerCorpse(uint32 dbid, uint32 charid, const char*
 		std::cerr << "Error2 in UpdatePlayerCorpse query: affected_rows = 0" << std::endl;
 		return 0;
 	}
-	if(rezzed){
-		if (!RunQuery(query, MakeAnyLenString(&query, "update player_corpses set rezzed = 1 WHERE id=%d",dbid), errbuf)) {
-			std::cerr << "Error in UpdatePlayerCorpse/Rezzed query: " << errbuf << std::endl;
-		}
-		safe_delete_array(query);
-	}
 	return dbid;
 }
 
@@ -1519,6 +1562,8 @@ void ZoneDatabase::MarkCorpseAsRezzed(uint32 dbid)
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char* query = 0;
 
+	CommitCorpseWrites();
+
 	if(!database.RunQuery(query,MakeAnyLenString(&query, "UPDATE player_corpses SET rezzed = 1 WHERE id = %i", dbid), errbuf))
 	{
 		LogFile->write(EQEMuLog::Error, "MarkCorpseAsRezzed failed: %s, %s", query, errbuf);
@@ -1679,6 +1724,8 @@ Corpse* ZoneDatabase::SummonBurriedPlayerCorpse(uint32 char_id, uint32 dest_zone
 	Corpse* NewCorpse = 0;
 	unsigned long* lengths;
 
+	CommitCorpseWrites();
+
 	if (RunQuery(query, MakeAnyLenString(&query, "SELECT id, charname, data, timeofdeath, rezzed FROM player_corpses WHERE charid='%u' AND IsBurried=1 ORDER BY timeofdeath LIMIT 1", char_id), errbuf, &result)) {
 		row = mysql_fetch_row(result);
 		lengths = mysql_fetch_lengths(result);
@@ -1717,6 +1764,8 @@ bool ZoneDatabase::SummonAllPlayerCorpses(uint32 char_id, uint32 dest_zoneid, ui
 	int CorpseCount = 0;
 	unsigned long* lengths;
 
+	CommitCorpseWrites();
+
 	if(!RunQuery(query, MakeAnyLenString(&query, "UPDATE player_corpses SET zoneid = %i, instanceid = %i, x = %f, y = %f, z = %f, "
 							"heading = %f, IsBurried = 0, WasAtGraveyard = 0 WHERE charid = %i",
 							dest_zoneid, dest_instanceid, dest_x, dest_y, dest_z, dest_heading, char_id), errbuf))
@@ -1759,6 +1808,8 @@ bool ZoneDatabase::UnburyPlayerCorpse(uint32 dbid, uint32 new_zoneid, uint16 new
 	uint32 affected_rows = 0;
 	bool Result = false;
 
+	CommitCorpseWrites();
+
 	end += sprintf(end, "UPDATE player_corpses SET IsBurried=0, zoneid=%u, instanceid=%u, x=%f, y=%f, z=%f, heading=%f, timeofdeath=Now(), WasAtGraveyard=0 WHERE id=%u", new_zoneid, new_instanceid, new_x, new_y, new_z, new_heading, dbid);
 
 	if (RunQuery(query, (uint32) (end - query), errbuf, 0, &affected_rows)) {
@@ -1783,6 +1834,8 @@ Corpse* ZoneDatabase::LoadPlayerCorpse(uint32 player_corpse_id) {
 	Corpse* NewCorpse = 0;
 	unsigned long* lengths;
 
+	CommitCorpseWrites();
+
 	if (RunQuery(query, MakeAnyLenString(&query, "SELECT id, charid, charname, x, y, z, heading, data, timeofdeath, rezzed, WasAtGraveyard FROM player_corpses WHERE id='%u'", player_corpse_id), errbuf, &result)) {
 		row = mysql_fetch_row(result);
 		lengths = mysql_fetch_lengths(result);
@@ -1864,6 +1917,8 @@ bool ZoneDatabase::BuryPlayerCorpse(uint32 dbid) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char *query = 0;
 
+	CommitCorpseWrites();
+
 	if (!RunQuery(query, MakeAnyLenString(&query, "UPDATE player_corpses SET IsBurried = 1 WHERE id=%d", dbid), errbuf)) {
 		std::cerr << "Error in BuryPlayerCorpse query '" << query << "' " << errbuf << std::endl;
 		safe_delete_array(query);
@@ -1878,6 +1933,8 @@ bool ZoneDatabase::BuryAllPlayerCorpses(uint32 charid) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char *query = 0;
 
+	CommitCorpseWrites();
+
 	if (!RunQuery(query, MakeAnyLenString(&query, "UPDATE player_corpses SET IsBurried = 1 WHERE charid=%d", charid), errbuf)) {
 		std::cerr << "Error in BuryPlayerCorpse query '" << query << "' " << errbuf << std::endl;
 		safe_delete_array(query);
@@ -1892,6 +1949,8 @@ bool ZoneDatabase::DeletePlayerCorpse(uint32 dbid) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char *query = 0;
 
+	CommitCorpseWrites();
+
 	if (!RunQuery(query, MakeAnyLenString(&query, "Delete from player_corpses where id=%d", dbid), errbuf)) {
 		std::cerr << "Error in DeletePlayerCorpse query '" << query << "' " << errbuf << std::endl;
 		safe_delete_array(query);
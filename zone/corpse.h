@@ -56,6 +56,7 @@ public:
 	bool	IsBecomeNPCCorpse() const { return become_npc; }
 	bool	Process();
 	bool	Save();
+	virtual void DBAWComplete(uint8 workpt_b1, DBAsyncWork* dbaw);
 	uint32	GetCharID()			{ return charid; }
 	uint32	SetCharID(uint32 iCharID) { if (IsPlayerCorpse()) { return (charid=iCharID); } return 0xFFFFFFFF; };
 	uint32	GetDecayTime()		{ if (!corpse_decay_timer.Enabled()) return 0xFFFFFFFF; else return corpse_decay_timer.GetRemainingTime(); }
@@ -27,6 +27,8 @@
 #include "../common/packet_dump.h"
 #include "../common/StringUtil.h"
 #include "guild_mgr.h"
+#include "zone.h"
+#include "pathing.h"
 
 #define OPEN_DOOR 0x02
 #define CLOSE_DOOR 0x03
@@ -59,7 +61,7 @@ Doors::Doors(const Door* door)
 	door_param = door->door_param;
 	size = door->size;
 	invert_state = door->invert_state;
-	SetOpenState(false);
+	isopen = false;
 
 	close_timer.Disable();
 
@@ -96,7 +98,7 @@ Doors::Doors(const char *dmodel, float dx, float dy, float dz, float dheading, u
 	door_param = 0;
 	size = dsize;
 	invert_state = 0;
-	SetOpenState(false);
+	isopen = false;
 
 	close_timer.Disable();
 
@@ -115,6 +117,18 @@ Doors::~Doors()
 {
 }
 
+void Doors::SetOpenState(bool st)
+{
+	if(isopen == st)
+		return;
+
+	isopen = st;
+
+	// cached npc routes through this door were found with it in the other state
+	if(zone && zone->pathing)
+		zone->pathing->InvalidateDoorRoutes(door_id);
+}
+
 bool Doors::Process()
 {
 	if(close_timer.Enabled() && close_timer.Check() && IsDoorOpen())
@@ -428,16 +442,16 @@ void Doors::NPCOpen(NPC* sender, bool alt_mode)
 		if(!alt_mode) { // original function
 			if(!isopen) {
 				close_timer.Start();
-				isopen=true;
+				SetOpenState(true);
 			}
 			else {
 				close_timer.Disable();
-				isopen=false;
+				SetOpenState(false);
 			}
 		}
 		else { // alternative function
 			close_timer.Start();
-			isopen=true;
+			SetOpenState(true);
 		}
 	}
 }
@@ -454,16 +468,16 @@ void Doors::ForceOpen(Mob *sender, bool alt_mode)
 	if(!alt_mode) { // original function
 		if(!isopen) {
 			close_timer.Start();
-			isopen=true;
+			SetOpenState(true);
 		}
 		else {
 			close_timer.Disable();
-			isopen=false;
+			SetOpenState(false);
 		}
 	}
 	else { // alternative function
 		close_timer.Start();
-		isopen=true;
+		SetOpenState(true);
 	}
 }
 
@@ -479,11 +493,11 @@ void Doors::ForceClose(Mob *sender, bool alt_mode)
 	if(!alt_mode) { // original function
 		if(!isopen) {
 			close_timer.Start();
-			isopen=true;
+			SetOpenState(true);
 		}
 		else {
 			close_timer.Disable();
-			isopen=false;
+			SetOpenState(false);
 		}
 	}
 	else { // alternative function
@@ -504,12 +518,12 @@ void Doors::ToggleState(Mob *sender)
 
 	if(!isopen) {
 		md->action = invert_state == 0 ? OPEN_DOOR : OPEN_INVDOOR;
-		isopen=true;
+		SetOpenState(true);
 	}
 	else
 	{
 		md->action = invert_state == 0 ? CLOSE_DOOR : CLOSE_INVDOOR;
-		isopen=false;
+		SetOpenState(false);
 	}
 
 	entity_list.QueueClients(sender,outapp,false);
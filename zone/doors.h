@@ -31,7 +31,7 @@ public:
 	float	GetHeading() { return heading; }
 	int		GetIncline() { return incline; }
 	bool	triggered;
-	void	SetOpenState(bool st) { isopen = st; }
+	void	SetOpenState(bool st);
 	bool	IsDoorOpen() { return isopen; }
 
 	uint8	GetTriggerDoorID() { return trigger_door; }
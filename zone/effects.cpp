@@ -750,8 +750,11 @@ void EntityList::AESpell(Mob *caster, Mob *center, uint16 spell_id, bool affect_
 	const int MAX_TARGETS_ALLOWED = 4;
 	int iCounter = 0;
 
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
-		curmob = it->second;
+	std::vector<Mob *> close_mobs;
+	GetMobsInRange(center->GetX(), center->GetY(), dist, close_mobs);
+
+	for (auto it = close_mobs.begin(); it != close_mobs.end(); ++it) {
+		curmob = *it;
 		// test to fix possible cause of random zone crashes..external methods accessing client properties before they're initialized
 		if (curmob->IsClient() && !curmob->CastToClient()->ClientFinishedLoading())
 			continue;
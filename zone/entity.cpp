@@ -18,6 +18,7 @@
 #include "../common/debug.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 #include <stdarg.h>
 #include <ctype.h>
 #include <string.h>
@@ -264,6 +265,8 @@ EntityList::EntityList()
 	// enough entities to exhaust this list
 	for (uint16 i = 1; i <= 1500; i++)
 		free_ids.push(i);
+
+	npc_aggro_range_max = 0.0f;
 }
 
 EntityList::~EntityList()
@@ -298,6 +301,7 @@ void EntityList::AddClient(Client *client)
 	client->SetID(GetFreeID());
 	client_list.insert(std::pair<uint16, Client *>(client->GetID(), client));
 	mob_list.insert(std::pair<uint16, Mob *>(client->GetID(), client));
+	client_grid.insert(client->GetID(), client, client->GetX(), client->GetY());
 }
 
 
@@ -448,6 +452,7 @@ void EntityList::MobProcess()
 	if (numclients < 1)
 		return;
 #endif
+	float aggro_range_max = 0.0f;
 	auto it = mob_list.begin();
 	while (it != mob_list.end()) {
 		if (!it->second) {
@@ -481,9 +486,23 @@ void EntityList::MobProcess()
 			}
 			entity_list.RemoveMob(tempid);
 		} else {
+			// catches anything that moved without going through ProcessMove (warps, gm moves, etc)
+			UpdateGridPosition(it->second);
+			if (it->second->IsNPC() && it->second->GetAggroRange() > aggro_range_max)
+				aggro_range_max = it->second->GetAggroRange();
 			++it;
 		}
 	}
+
+	npc_aggro_range_max = aggro_range_max;
+}
+
+void EntityList::UpdateGridPosition(Mob *mob)
+{
+	if (mob->IsNPC())
+		npc_grid.update(mob->GetID(), mob->GetX(), mob->GetY());
+	else if (mob->IsClient())
+		client_grid.update(mob->GetID(), mob->GetX(), mob->GetY());
 }
 
 void EntityList::BeaconProcess()
@@ -596,6 +615,9 @@ void EntityList::AddNPC(NPC *npc, bool SendSpawnPacket, bool dontqueue)
 
 	npc_list.insert(std::pair<uint16, NPC *>(npc->GetID(), npc));
 	mob_list.insert(std::pair<uint16, Mob *>(npc->GetID(), npc));
+	npc_grid.insert(npc->GetID(), npc, npc->GetX(), npc->GetY());
+	if (npc->GetAggroRange() > npc_aggro_range_max)
+		npc_aggro_range_max = npc->GetAggroRange();
 }
 
 void EntityList::AddObject(Object *obj, bool SendSpawnPacket)
@@ -1256,6 +1278,8 @@ void EntityList::RemoveFromTargets(Mob *mob)
 void EntityList::QueueClientsByTarget(Mob *sender, const EQApplicationPacket *app,
 		bool iSendToSender, Mob *SkipThisMob, bool ackreq, bool HoTT, uint32 ClientVersionBits)
 {
+	EQBroadcastPacket broadcast(app);
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *c = it->second;
@@ -1289,7 +1313,7 @@ void EntityList::QueueClientsByTarget(Mob *sender, const EQApplicationPacket *ap
 		}
 
 		if (Send && (c->GetClientVersionBit() & ClientVersionBits))
-			c->QueuePacket(app, ackreq);
+			c->QueuePacket(&broadcast, ackreq);
 	}
 }
 
@@ -1305,9 +1329,14 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 		dist = 600;
 	float dist2 = dist * dist; //pow(dist, 2);
 
-	auto it = client_list.begin();
-	while (it != client_list.end()) {
-		Client *ent = it->second;
+	std::vector<Client *> close_clients;
+	GetClientsInRange(sender->GetX(), sender->GetY(), dist, close_clients);
+
+	EQBroadcastPacket broadcast(app);
+
+	auto it = close_clients.begin();
+	while (it != close_clients.end()) {
+		Client *ent = *it;
 
 		if ((!ignore_sender || ent != sender) && (ent != SkipThisMob)) {
 			eqFilterMode filter2 = ent->GetFilter(filter);
@@ -1318,7 +1347,7 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 					(ent->GetGroup() && ent->GetGroup()->IsGroupMember(sender))))
 				|| (filter2 == FilterShowSelfOnly && ent == sender))
 			&& (ent->DistNoRoot(*sender) <= dist2)) {
-				ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+				ent->QueuePacket(&broadcast, ackreq, Client::CLIENT_CONNECTED);
 			}
 		}
 		++it;
@@ -1329,12 +1358,14 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 void EntityList::QueueClients(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	EQBroadcastPacket broadcast(app);
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(&broadcast, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
@@ -1343,12 +1374,14 @@ void EntityList::QueueClients(Mob *sender, const EQApplicationPacket *app,
 void EntityList::QueueManaged(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	EQBroadcastPacket broadcast(app);
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(&broadcast, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
@@ -1358,11 +1391,13 @@ void EntityList::QueueManaged(Mob *sender, const EQApplicationPacket *app,
 void EntityList::QueueClientsStatus(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, uint8 minstatus, uint8 maxstatus)
 {
+	EQBroadcastPacket broadcast(app);
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		if ((!ignore_sender || it->second != sender) &&
 				(it->second->Admin() >= minstatus && it->second->Admin() <= maxstatus))
-			it->second->QueuePacket(app);
+			it->second->QueuePacket(&broadcast);
 
 		++it;
 	}
@@ -1430,11 +1465,16 @@ Client *EntityList::GetClientByWID(uint32 iWID)
 Client *EntityList::GetRandomClient(float x, float y, float z, float Distance, Client *ExcludeClient)
 {
 	std::vector<Client *> ClientsInRange;
+	std::vector<Client *> close_clients;
 
-	auto it = client_list.begin();
-	while (it != client_list.end()) {
-		if ((it->second != ExcludeClient) && (it->second->DistNoRoot(x, y, z) <= Distance))
-			ClientsInRange.push_back(it->second);
+	// Distance is already squared
+	if (Distance >= 0)
+		GetClientsInRange(x, y, sqrtf(Distance), close_clients);
+
+	auto it = close_clients.begin();
+	while (it != close_clients.end()) {
+		if ((*it != ExcludeClient) && ((*it)->DistNoRoot(x, y, z) <= Distance))
+			ClientsInRange.push_back(*it);
 		++it;
 	}
 
@@ -1737,11 +1777,13 @@ void EntityList::Message(uint32 to_guilddbid, uint32 type, const char *message,
 void EntityList::QueueClientsGuild(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, uint32 guild_id)
 {
+	EQBroadcastPacket broadcast(app);
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *client = it->second;
 		if (client->IsInGuild(guild_id))
-			client->QueuePacket(app);
+			client->QueuePacket(&broadcast);
 		++it;
 	}
 }
@@ -1770,8 +1812,11 @@ void EntityList::MessageClose_StringID(Mob *sender, bool skipsender, float dist,
 	Client *c;
 	float dist2 = dist * dist;
 
-	for (auto it = client_list.begin(); it != client_list.end(); ++it) {
-		c = it->second;
+	std::vector<Client *> close_clients;
+	GetClientsInRange(sender->GetX(), sender->GetY(), dist, close_clients);
+
+	for (auto it = close_clients.begin(); it != close_clients.end(); ++it) {
+		c = *it;
 		if(c && c->DistNoRoot(*sender) <= dist2 && (!skipsender || c != sender))
 			c->Message_StringID(type, string_id, message1, message2, message3, message4, message5, message6, message7, message8, message9);
 	}
@@ -1786,8 +1831,11 @@ void EntityList::FilteredMessageClose_StringID(Mob *sender, bool skipsender,
 	Client *c;
 	float dist2 = dist * dist;
 
-	for (auto it = client_list.begin(); it != client_list.end(); ++it) {
-		c = it->second;
+	std::vector<Client *> close_clients;
+	GetClientsInRange(sender->GetX(), sender->GetY(), dist, close_clients);
+
+	for (auto it = close_clients.begin(); it != close_clients.end(); ++it) {
+		c = *it;
 		if (c && c->DistNoRoot(*sender) <= dist2 && (!skipsender || c != sender))
 			c->FilteredMessage_StringID(sender, type, filter, string_id,
 					message1, message2, message3, message4, message5,
@@ -1834,10 +1882,13 @@ void EntityList::MessageClose(Mob* sender, bool skipsender, float dist, uint32 t
 
 	float dist2 = dist * dist;
 
-	auto it = client_list.begin();
-	while (it != client_list.end()) {
-		if (it->second->DistNoRoot(*sender) <= dist2 && (!skipsender || it->second != sender))
-			it->second->Message(type, buffer);
+	std::vector<Client *> close_clients;
+	GetClientsInRange(sender->GetX(), sender->GetY(), dist, close_clients);
+
+	auto it = close_clients.begin();
+	while (it != close_clients.end()) {
+		if ((*it)->DistNoRoot(*sender) <= dist2 && (!skipsender || *it != sender))
+			(*it)->Message(type, buffer);
 		++it;
 	}
 }
@@ -1856,6 +1907,7 @@ void EntityList::RemoveAllClients()
 {
 	// doesn't clear the data
 	client_list.clear();
+	client_grid.clear();
 }
 
 void EntityList::RemoveAllNPCs()
@@ -1863,6 +1915,7 @@ void EntityList::RemoveAllNPCs()
 	// doesn't clear the data
 	npc_list.clear();
 	npc_limit_list.clear();
+	npc_grid.clear();
 }
 
 void EntityList::RemoveAllGroups()
@@ -1969,6 +2022,8 @@ bool EntityList::RemoveMob(Mob *delete_mob)
 	auto it = mob_list.begin();
 	while (it != mob_list.end()) {
 		if (it->second == delete_mob) {
+			npc_grid.erase(it->first);
+			client_grid.erase(it->first);
 			safe_delete(it->second);
 			if (!corpse_list.count(it->first))
 				free_ids.push(it->first);
@@ -1988,6 +2043,7 @@ bool EntityList::RemoveNPC(uint16 delete_id)
 		RemoveProximity(delete_id);
 		// remove from the list
 		npc_list.erase(it);
+		npc_grid.erase(delete_id);
 		// remove from limit list if needed
 		if (npc_limit_list.count(delete_id))
 			npc_limit_list.erase(delete_id);
@@ -2001,6 +2057,7 @@ bool EntityList::RemoveClient(uint16 delete_id)
 	auto it = client_list.find(delete_id);
 	if (it != client_list.end()) {
 		client_list.erase(it); // Already deleted
+		client_grid.erase(delete_id);
 		return true;
 	}
 	return false;
@@ -2012,6 +2069,7 @@ bool EntityList::RemoveClient(Client *delete_client)
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		if (it->second == delete_client) {
+			client_grid.erase(it->first);
 			client_list.erase(it);
 			return true;
 		}
@@ -2978,6 +3036,8 @@ struct quest_proximity_event {
 
 void EntityList::ProcessMove(Client *c, float x, float y, float z)
 {
+	client_grid.update(c->GetID(), x, y);
+
 	float last_x = c->ProximityX();
 	float last_y = c->ProximityY();
 	float last_z = c->ProximityZ();
@@ -3075,6 +3135,8 @@ void EntityList::ProcessMove(Client *c, float x, float y, float z)
 
 void EntityList::ProcessMove(NPC *n, float x, float y, float z)
 {
+	npc_grid.update(n->GetID(), x, y);
+
 	float last_x = n->GetX();
 	float last_y = n->GetY();
 	float last_z = n->GetZ();
@@ -3412,8 +3474,11 @@ void EntityList::QuestJournalledSayClose(Mob *sender, Client *QuestInitiator,
 		safe_delete_array(buf);
 	}
 	// Use the old method for all other nearby clients
-	for (auto it = client_list.begin(); it != client_list.end(); ++it) {
-		c = it->second;
+	std::vector<Client *> close_clients;
+	GetClientsInRange(sender->GetX(), sender->GetY(), dist, close_clients);
+
+	for (auto it = close_clients.begin(); it != close_clients.end(); ++it) {
+		c = *it;
 		if(c && (c != QuestInitiator) && c->DistNoRoot(*sender) <= dist2)
 			c->Message_StringID(10, GENERIC_SAY, mobname, message);
 	}
@@ -4213,6 +4278,28 @@ void EntityList::GetTargetsForConeArea(Mob *start, uint32 radius, uint32 height,
 	}
 }
 
+void EntityList::GetClientsInRange(float x, float y, float range, std::vector<Client*> &c_list)
+{
+	client_grid.query(x, y, range, c_list);
+}
+
+void EntityList::GetNPCsInRange(float x, float y, float range, std::vector<NPC*> &n_list)
+{
+	npc_grid.query(x, y, range, n_list);
+}
+
+void EntityList::GetMobsInRange(float x, float y, float range, std::vector<Mob*> &m_list)
+{
+	std::vector<Client *> close_clients;
+	std::vector<NPC *> close_npcs;
+	client_grid.query(x, y, range, close_clients);
+	npc_grid.query(x, y, range, close_npcs);
+
+	m_list.reserve(m_list.size() + close_clients.size() + close_npcs.size());
+	m_list.insert(m_list.end(), close_clients.begin(), close_clients.end());
+	m_list.insert(m_list.end(), close_npcs.begin(), close_npcs.end());
+}
+
 Client *EntityList::FindCorpseDragger(uint16 CorpseID)
 {
 	auto it = client_list.begin();
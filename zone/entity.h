@@ -25,6 +25,7 @@
 #include "../common/servertalk.h"
 #include "../common/bodytypes.h"
 #include "../common/eq_constants.h"
+#include "../common/spatial_grid.h"
 
 #include "zonedb.h"
 #include "zonedump.h"
@@ -372,6 +373,11 @@ public:
 	void GetSpawnList(std::list<Spawn2*> &d_list);
 	void GetTargetsForConeArea(Mob *start, uint32 radius, uint32 height, std::list<Mob*> &m_list);
 
+	//candidates from the spatial grid, callers still need to do their own distance checks
+	void GetClientsInRange(float x, float y, float range, std::vector<Client*> &c_list);
+	void GetNPCsInRange(float x, float y, float range, std::vector<NPC*> &n_list);
+	void GetMobsInRange(float x, float y, float range, std::vector<Mob*> &m_list);
+
 	void	DepopAll(int NPCTypeID, bool StartSpawnTimer = true);
 
 	uint16 GetFreeID();
@@ -383,6 +389,7 @@ protected:
 private:
 	void	AddToSpawnQueue(uint16 entityid, NewSpawn_Struct** app);
 	void	CheckSpawnQueue();
+	void	UpdateGridPosition(Mob *mob);
 
 	//used for limiting spawns
 	class SpawnLimitRecord { public: uint32 spawngroup_id; uint32 npc_type; };
@@ -406,6 +413,11 @@ private:
 	std::list<Area> area_list;
 	std::queue<uint16> free_ids;
 
+	//spatial index over client_list and npc_list, kept current by ProcessMove and MobProcess
+	EQEmu::SpatialGrid<Client *> client_grid;
+	EQEmu::SpatialGrid<NPC *> npc_grid;
+	float	npc_aggro_range_max;
+
 	// Please Do Not Declare Any EntityList Class Members After This Comment
 };
 
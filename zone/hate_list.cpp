@@ -17,10 +17,13 @@
 */
 
 #include "../common/debug.h"
+#include "../common/rdtsc.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <math.h>
 #include <list>
+#include <unordered_map>
+#include <vector>
 #include "masterentity.h"
 #include "../common/rulesys.h"
 #include "../common/MiscFunctions.h"
@@ -34,6 +37,9 @@ extern Zone *zone;
 HateList::HateList()
 {
 	owner = nullptr;
+	most_hated = -1;
+	frenzy_count = 0;
+	dirty = false;
 }
 
 HateList::~HateList()
@@ -47,29 +53,44 @@ void HateList::CheckFrenzyHate()
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		if ((*iterator)->ent->GetHPRatio() >= 20)
+		if ((*iterator)->bFrenzy && (*iterator)->ent->GetHPRatio() >= 20)
+		{
 			(*iterator)->bFrenzy = false;
+			if(frenzy_count > 0)
+				--frenzy_count;
+		}
 		++iterator;
 	}
 }
 
 void HateList::Wipe()
 {
-	auto iterator = list.begin();
-
-	while(iterator != list.end())
+	//the events below can run quests that touch this list, so empty it first
+	std::vector<Mob*> old;
+	old.reserve(list.size());
+	for(uint32 i = 0; i < list.size(); ++i)
+		old.push_back(list[i]->ent);
+	list.clear();
+	pool.clear();
+	free_entries.clear();
+	index.clear();
+	most_hated = -1;
+	frenzy_count = 0;
+	dirty = false;
+
+	auto iterator = old.begin();
+	while(iterator != old.end())
 	{
-		Mob* m = (*iterator)->ent;
+		Mob* m = *iterator;
 		if(m)
 		{
-			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), m, "0", 0);
+			if(owner)
+				parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), m, "0", 0);
 
 			if(m->IsClient())
 				m->CastToClient()->DecrementAggroCount();
 		}
-		delete (*iterator);
-		iterator = list.erase(iterator);
-
+		++iterator;
 	}
 }
 
@@ -82,14 +103,40 @@ bool HateList::IsOnHateList(Mob *mob)
 
 tHateEntry *HateList::Find(Mob *ent)
 {
-	auto iterator = list.begin();
-	while(iterator != list.end())
+	Refresh();
+	auto iterator = index.find(ent);
+	if(iterator == index.end())
+		return nullptr;
+	return list[iterator->second];
+}
+
+void HateList::Refresh()
+{
+	if(!dirty)
+		return;
+
+	index.clear();
+	most_hated = -1;
+	frenzy_count = 0;
+	for(uint32 i = 0; i < list.size(); ++i)
 	{
-		if((*iterator)->ent == ent)
-			return (*iterator);
-		++iterator;
+		//a quest may have pointed two entries at the same mob, Find has always returned the first
+		index.insert(std::make_pair(list[i]->ent, i));
+		if(list[i]->bFrenzy)
+			++frenzy_count;
+		if(list[i]->ent != nullptr && list[i]->hate > -1 && (most_hated == -1 || list[i]->hate > list[most_hated]->hate))
+			most_hated = i;
 	}
-	return nullptr;
+	dirty = false;
+}
+
+void HateList::HateRaised(uint32 i)
+{
+	if(dirty || list[i]->ent == nullptr || list[i]->hate <= -1)
+		return;
+
+	if(most_hated == -1 || list[i]->hate > list[most_hated]->hate || (list[i]->hate == list[most_hated]->hate && (int32)i < most_hated))
+		most_hated = i;
 }
 
 void HateList::Set(Mob* other, uint32 in_hate, uint32 in_dam)
@@ -100,7 +147,11 @@ void HateList::Set(Mob* other, uint32 in_hate, uint32 in_dam)
 		if(in_dam > 0)
 			p->damage = in_dam;
 		if(in_hate > 0)
+		{
 			p->hate = in_hate;
+			//could have gone either way
+			dirty = true;
+		}
 	}
 }
 
@@ -182,25 +233,64 @@ void HateList::Add(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAd
 	if(ent->IsClient() && ent->CastToClient()->IsDead())
 		return;
 
+	if(AddHate(ent, in_hate, in_dam, bFrenzy, iAddIfNotExist))
+	{
+		if(owner)
+			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "1", 0);
+
+		if(ent->IsClient())
+			ent->CastToClient()->IncrementAggroCount();
+	}
+}
+
+bool HateList::AddHate(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAddIfNotExist)
+{
 	tHateEntry *p = Find(ent);
 	if (p)
 	{
 		p->damage+=(in_dam>=0)?in_dam:0;
 		p->hate+=in_hate;
-		p->bFrenzy = bFrenzy;
+		if(p->bFrenzy != bFrenzy)
+		{
+			p->bFrenzy = bFrenzy;
+			if(bFrenzy)
+				++frenzy_count;
+			else if(frenzy_count > 0)
+				--frenzy_count;
+		}
+
+		uint32 i = index[ent];
+		if(in_hate >= 0)
+			HateRaised(i);
+		else if(most_hated == (int32)i)
+			dirty = true;
+		return false;
 	}
-	else if (iAddIfNotExist) {
-		p = new tHateEntry;
-		p->ent = ent;
-		p->damage = (in_dam>=0)?in_dam:0;
-		p->hate = in_hate;
-		p->bFrenzy = bFrenzy;
-		list.push_back(p);
-		parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "1", 0);
 
-		if(ent->IsClient())
-			ent->CastToClient()->IncrementAggroCount();
+	if(!iAddIfNotExist)
+		return false;
+
+	tHateEntry *e;
+	if(!free_entries.empty())
+	{
+		e = free_entries.back();
+		free_entries.pop_back();
+	}
+	else
+	{
+		pool.push_back(tHateEntry());
+		e = &pool.back();
 	}
+	e->ent = ent;
+	e->damage = (in_dam>=0)?in_dam:0;
+	e->hate = in_hate;
+	e->bFrenzy = bFrenzy;
+	list.push_back(e);
+	index[ent] = (uint32)list.size() - 1;
+	if(bFrenzy)
+		++frenzy_count;
+	HateRaised((uint32)list.size() - 1);
+	return true;
 }
 
 bool HateList::RemoveEnt(Mob *ent)
@@ -208,29 +298,35 @@ bool HateList::RemoveEnt(Mob *ent)
 	if (!ent)
 		return false;
 
-	bool found = false;
-	auto iterator = list.begin();
+	Refresh();
+	if(index.find(ent) == index.end())
+		return false;
 
-	while(iterator != list.end())
+	//erase rather than swap with the back, the order decides hate ties
+	uint32 removed = 0;
+	for(uint32 i = 0; i < list.size(); ++i)
 	{
-		if((*iterator)->ent == ent)
+		if(list[i]->ent == ent)
 		{
-			if(ent)
-			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
-			found = true;
-
-			
-			if(ent && ent->IsClient())
-				ent->CastToClient()->DecrementAggroCount();
+			free_entries.push_back(list[i]);
+			++removed;
+		}
+		else if(removed > 0)
+			list[i - removed] = list[i];
+	}
+	list.resize(list.size() - removed);
+	dirty = true;
 
-			delete (*iterator);
-			iterator = list.erase(iterator);
+	//the event can run quests that touch this list, it's already consistent
+	for(uint32 i = 0; i < removed; ++i)
+	{
+		if(owner)
+			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
 
-		}
-		else
-			++iterator;
+		if(ent->IsClient())
+			ent->CastToClient()->DecrementAggroCount();
 	}
-	return found;
+	return true;
 }
 
 void HateList::DoFactionHits(int32 nfl_id) {
@@ -279,28 +375,37 @@ Mob *HateList::GetTop(Mob *center)
 	if(center == nullptr)
 		return nullptr;
 
+	Refresh();
+	bool underwater_only = center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap();
+
 	if (RuleB(Aggro,SmartAggroList)){
 		Mob* topClientTypeInRange = nullptr;
 		int32 hateClientTypeInRange = -1;
 		int skipped_count = 0;
 
+		//the most the aggro mods below can add, anything that can't beat the current top
+		//even with all of them is skipped before the range, water and status checks
+		int64 max_mod = std::max(0, RuleI(Aggro, SittingAggroMod)) + std::max(0, RuleI(Aggro, CurrentTargetAggroMod)) +
+			std::max(0, RuleI(Aggro, MeleeRangeAggroMod)) + std::max(0, RuleI(Aggro, CriticallyWoundedAggroMod));
+
 		auto iterator = list.begin();
 		while(iterator != list.end())
 		{
-			tHateEntry *cur = (*iterator);
+			tHateEntry *cur = *iterator;
 			int16 aggroMod = 0;
 
-			if(!cur){
+			if(!cur->ent){
 				++iterator;
 				continue;
 			}
 
-			if(!cur->ent){
+			if(hate >= 0 && !cur->bFrenzy && cur->hate >= 0 && cur->hate + cur->hate * max_mod / 100 <= hate &&
+				(!cur->ent->IsClient() || cur->hate <= hateClientTypeInRange)) {
 				++iterator;
 				continue;
 			}
 
-			if(center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
+			if(underwater_only) {
 				if(!zone->watermap->InLiquid(cur->ent->GetX(), cur->ent->GetY(), cur->ent->GetZ())) {
 					skipped_count++;
 					++iterator;
@@ -398,12 +503,16 @@ Mob *HateList::GetTop(Mob *center)
 		}
 	}
 	else{
+		//without frenzy or the water check the answer is the tracked top
+		if(frenzy_count == 0 && !underwater_only)
+			return most_hated == -1 ? nullptr : list[most_hated]->ent;
+
 		auto iterator = list.begin();
 		int skipped_count = 0;
 		while(iterator != list.end())
 		{
-			tHateEntry *cur = (*iterator);
-			if(center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
+			tHateEntry *cur = *iterator;
+			if(underwater_only) {
 				if(!zone->watermap->InLiquid(cur->ent->GetX(), cur->ent->GetY(), cur->ent->GetZ())) {
 					skipped_count++;
 					++iterator;
@@ -427,21 +536,8 @@ Mob *HateList::GetTop(Mob *center)
 }
 
 Mob *HateList::GetMostHate(){
-	Mob* top = nullptr;
-	int32 hate = -1;
-
-	auto iterator = list.begin();
-	while(iterator != list.end())
-	{
-		tHateEntry *cur = (*iterator);
-		if(cur->ent != nullptr && (cur->hate > hate))
-		{
-			top = cur->ent;
-			hate = cur->hate;
-		}
-		++iterator;
-	}
-	return top;
+	Refresh();
+	return most_hated == -1 ? nullptr : list[most_hated]->ent;
 }
 
 
@@ -452,19 +548,9 @@ Mob *HateList::GetRandom()
 		return nullptr;
 
 	if(count == 1) //No need to do all that extra work if we only have one hate entry
-	{
-		if(*list.begin()) // Just in case tHateEntry is invalidated somehow...
-			return (*list.begin())->ent;
-
-		return nullptr;
-	}
+		return list[0]->ent;
 
-	auto iterator = list.begin();
-	int random = MakeRandomInt(0, count - 1);
-	for (int i = 0; i < random; i++)
-		++iterator;
-	
-	return (*iterator)->ent;
+	return list[MakeRandomInt(0, count - 1)]->ent;
 }
 
 int32 HateList::GetEntHate(Mob *ent, bool damage)
@@ -492,7 +578,7 @@ void HateList::PrintToClient(Client *c)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		tHateEntry *e = (*iterator);
+		tHateEntry *e = *iterator;
 		c->Message(0, "- name: %s, damage: %d, hate: %d",
 			(e->ent && e->ent->GetName()) ? e->ent->GetName() : "(null)",
 			e->damage, e->hate);
@@ -511,9 +597,9 @@ int HateList::AreaRampage(Mob *caster, Mob *target, int count, ExtraAttackOption
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		tHateEntry *h = (*iterator);
+		tHateEntry *h = *iterator;
 		++iterator;
-		if(h && h->ent && h->ent != caster)
+		if(h->ent && h->ent != caster)
 		{
 			if(caster->CombatRange(h->ent))
 			{
@@ -555,7 +641,7 @@ void HateList::SpellCast(Mob *caster, uint32 spell_id, float range)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		tHateEntry *h = (*iterator);
+		tHateEntry *h = *iterator;
 		if(range > 0)
 		{
 			if(caster->DistNoRoot(*h->ent) <= range)
@@ -582,3 +668,279 @@ void HateList::SpellCast(Mob *caster, uint32 spell_id, float range)
 	}
 }
 
+
+//GetTop as it was before the list was indexed, the full scan #hatelistbench compares against
+static Mob *ScanTop(std::list<tHateEntry*> &list, Mob *center)
+{
+	Mob* top = nullptr;
+	int32 hate = -1;
+
+	if(center == nullptr)
+		return nullptr;
+
+	if (RuleB(Aggro,SmartAggroList)){
+		Mob* topClientTypeInRange = nullptr;
+		int32 hateClientTypeInRange = -1;
+		int skipped_count = 0;
+
+		auto iterator = list.begin();
+		while(iterator != list.end())
+		{
+			tHateEntry *cur = (*iterator);
+			int16 aggroMod = 0;
+
+			if(!cur){
+				++iterator;
+				continue;
+			}
+
+			if(!cur->ent){
+				++iterator;
+				continue;
+			}
+
+			if(center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
+				if(!zone->watermap->InLiquid(cur->ent->GetX(), cur->ent->GetY(), cur->ent->GetZ())) {
+					skipped_count++;
+					++iterator;
+					continue;
+				}
+			}
+
+			if (cur->ent->Sanctuary()) {
+				if(hate == -1)
+				{
+					top = cur->ent;
+					hate = 1;
+				}
+				++iterator;
+				continue;
+			}
+
+			if(cur->ent->DivineAura() || cur->ent->IsMezzed() || cur->ent->IsFeared()){
+				if(hate == -1)
+				{
+					top = cur->ent;
+					hate = 0;
+				}
+				++iterator;
+				continue;
+			}
+
+			int32 currentHate = cur->hate;
+
+			if(cur->ent->IsClient()){
+
+				if(cur->ent->CastToClient()->IsSitting()){
+					aggroMod += RuleI(Aggro, SittingAggroMod);
+				}
+
+				if(center){
+					if(center->GetTarget() == cur->ent)
+						aggroMod += RuleI(Aggro, CurrentTargetAggroMod);
+					if(RuleI(Aggro, MeleeRangeAggroMod) != 0)
+					{
+						if(center->CombatRange(cur->ent)){
+							aggroMod += RuleI(Aggro, MeleeRangeAggroMod);
+
+							if(currentHate > hateClientTypeInRange || cur->bFrenzy){
+								hateClientTypeInRange = currentHate;
+								topClientTypeInRange = cur->ent;
+							}
+						}
+					}
+				}
+
+			}
+			else{
+				if(center){
+					if(center->GetTarget() == cur->ent)
+						aggroMod += RuleI(Aggro, CurrentTargetAggroMod);
+					if(RuleI(Aggro, MeleeRangeAggroMod) != 0)
+					{
+						if(center->CombatRange(cur->ent)){
+							aggroMod += RuleI(Aggro, MeleeRangeAggroMod);
+						}
+					}
+				}
+			}
+
+			if(cur->ent->GetMaxHP() != 0 && ((cur->ent->GetHP()*100/cur->ent->GetMaxHP()) < 20)){
+				aggroMod += RuleI(Aggro, CriticallyWoundedAggroMod);
+			}
+
+			if(aggroMod){
+				currentHate += (currentHate * aggroMod / 100);
+			}
+
+			if(currentHate > hate || cur->bFrenzy){
+				hate = currentHate;
+				top = cur->ent;
+			}
+
+			++iterator;
+		}
+
+		if(topClientTypeInRange != nullptr && top != nullptr) {
+			bool isTopClientType = top->IsClient();
+
+			if(!isTopClientType)
+				return topClientTypeInRange ? topClientTypeInRange : nullptr;
+
+			return top ? top : nullptr;
+		}
+		else {
+			if(top == nullptr && skipped_count > 0) {
+				return center->GetTarget() ? center->GetTarget() : nullptr;
+			}
+			return top ? top : nullptr;
+		}
+	}
+	else{
+		auto iterator = list.begin();
+		int skipped_count = 0;
+		while(iterator != list.end())
+		{
+			tHateEntry *cur = (*iterator);
+			if(center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
+				if(!zone->watermap->InLiquid(cur->ent->GetX(), cur->ent->GetY(), cur->ent->GetZ())) {
+					skipped_count++;
+					++iterator;
+					continue;
+				}
+			}
+
+			if(cur->ent != nullptr && ((cur->hate > hate) || cur->bFrenzy ))
+			{
+				top = cur->ent;
+				hate = cur->hate;
+			}
+			++iterator;
+		}
+		if(top == nullptr && skipped_count > 0) {
+			return center->GetTarget() ? center->GetTarget() : nullptr;
+		}
+		return top ? top : nullptr;
+	}
+	return nullptr;
+}
+
+//Replays a raid fight: every round each entry takes AE hate, the center runs the AI tick's
+//GetTop and every entry is looked up once. It runs on a scratch HateList and on the list of
+//heap entries it replaced, with linear lookups and the full GetTop scan above, so both sides
+//make the same SmartAggro and water checks. The entries are written straight into both lists,
+//no quest events fire and no client's aggro count changes.
+void HateList::Benchmark(Client *c, Mob *center, uint32 entries, uint32 rounds)
+{
+	if(!c || !center)
+		return;
+
+	std::list<Mob*> mobs;
+	entity_list.GetMobList(mobs);
+
+	std::vector<Mob*> raid;
+	auto iterator = mobs.begin();
+	while(iterator != mobs.end() && raid.size() < entries)
+	{
+		Mob *m = *iterator;
+		++iterator;
+		if(m == center || m->IsCorpse() || (m->IsClient() && m->CastToClient()->IsDead()))
+			continue;
+		raid.push_back(m);
+	}
+
+	if(raid.empty())
+	{
+		c->Message(0, "No mobs in the zone to put on the hate list.");
+		return;
+	}
+
+	std::vector<int32> hate(raid.size() * rounds);
+	for(size_t i = 0; i < hate.size(); ++i)
+		hate[i] = MakeRandomInt(1, 500);
+
+	//the top each round, to check both lists agree
+	std::vector<Mob*> tops(rounds);
+
+	uint32 found = 0;
+	HateList flat;
+	RDTSC_Collector flat_top;
+	RDTSC_Timer flat_timer(true);
+	for(uint32 round = 0; round < rounds; ++round)
+	{
+		for(size_t i = 0; i < raid.size(); ++i)
+			flat.AddHate(raid[i], hate[round * raid.size() + i], hate[round * raid.size() + i], false, true);
+
+		flat_top.start();
+		tops[round] = flat.GetTop(center);
+		flat_top.stop();
+
+		for(size_t i = 0; i < raid.size(); ++i)
+		{
+			if(flat.Find(raid[i]))
+				++found;
+		}
+	}
+	flat_timer.stop();
+
+	uint32 scan_found = 0;
+	uint32 differed = 0;
+	std::list<tHateEntry*> scan;
+	RDTSC_Collector scan_top;
+	RDTSC_Timer scan_timer(true);
+	for(uint32 round = 0; round < rounds; ++round)
+	{
+		for(size_t i = 0; i < raid.size(); ++i)
+		{
+			tHateEntry *e = nullptr;
+			for(auto cur = scan.begin(); cur != scan.end(); ++cur)
+			{
+				if((*cur)->ent == raid[i])
+				{
+					e = *cur;
+					break;
+				}
+			}
+
+			if(!e)
+			{
+				e = new tHateEntry;
+				e->ent = raid[i];
+				e->damage = 0;
+				e->hate = 0;
+				e->bFrenzy = false;
+				scan.push_back(e);
+			}
+			e->hate += hate[round * raid.size() + i];
+			e->damage += hate[round * raid.size() + i];
+		}
+
+		scan_top.start();
+		Mob *top = ScanTop(scan, center);
+		scan_top.stop();
+		if(top != tops[round])
+			++differed;
+
+		for(size_t i = 0; i < raid.size(); ++i)
+		{
+			for(auto cur = scan.begin(); cur != scan.end(); ++cur)
+			{
+				if((*cur)->ent == raid[i])
+				{
+					++scan_found;
+					break;
+				}
+			}
+		}
+	}
+	scan_timer.stop();
+
+	for(auto cur = scan.begin(); cur != scan.end(); ++cur)
+		delete (*cur);
+
+	c->Message(0, "Hate list benchmark, %u entries on %s for %u rounds:", (uint32)raid.size(), center->GetName(), rounds);
+	c->Message(0, "Indexed list: %.3f ms, %.3f ms of it in GetTop (%u found)", flat_timer.getDuration(), flat_top.getTotalDuration(), found);
+	c->Message(0, "Scanned list: %.3f ms, %.3f ms of it in GetTop (%u found)", scan_timer.getDuration(), scan_top.getTotalDuration(), scan_found);
+	if(differed > 0)
+		c->Message(13, "The lists picked a different top in %u rounds.", differed);
+}
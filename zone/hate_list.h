@@ -19,6 +19,10 @@
 #ifndef HATELIST_H
 #define HATELIST_H
 
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 struct tHateEntry
 {
 	Mob *ent;
@@ -69,15 +73,39 @@ public:
 	void PrintToClient(Client *c);
 
 	//For accessing the hate list via perl; don't use for anything else
-	std::list<tHateEntry*>& GetHateList() { return list; }
+	//entries may be edited through it so the cached lookups are rebuilt on next use,
+	//an entry stays put until its mob is removed from the list
+	std::vector<tHateEntry*>& GetHateList() { dirty = true; return list; }
 
 	//setting owner
 	void SetOwner(Mob *newOwner) { owner = newOwner; }
 
+	// times a simulated raid on center against the old linear list, for #hatelistbench
+	static void Benchmark(Client *c, Mob *center, uint32 entries, uint32 rounds);
+
 protected:
 	tHateEntry* Find(Mob *ent);
+	// raises ent's hate or adds its entry, without quest events or aggro counts. true if it was added
+	bool AddHate(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAddIfNotExist);
+	// rebuilds index, most_hated and frenzy_count if anything invalidated them
+	void Refresh();
+	// keeps most_hated current after entry i's hate went up
+	void HateRaised(uint32 i);
 private:
-	std::list<tHateEntry*> list;
+	// entries in the order they were added, the earliest entry wins hate ties. They point
+	// into pool so quests holding one aren't moved under by adds and removals.
+	std::vector<tHateEntry*> list;
+	// the entries themselves, a deque never moves what it already holds. Removed entries
+	// wait in free_entries for the next add, the pool is only emptied by Wipe.
+	std::deque<tHateEntry> pool;
+	std::vector<tHateEntry*> free_entries;
+	// list position of each mob on the list
+	std::unordered_map<Mob*, uint32> index;
+	// list position of the entry with the most hate (ignoring frenzy and aggro mods), -1 if none
+	int32 most_hated;
+	// entries with bFrenzy set
+	uint32 frenzy_count;
+	bool dirty;
 	Mob *owner;
 };
 
@@ -0,0 +1,226 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "../common/debug.h"
+#include "../common/rdtsc.h"
+#include "../common/rulesys.h"
+#include "../common/timer.h"
+#include "los_cache.h"
+#include "client.h"
+#include <math.h>
+#include <string.h>
+
+LOSCache::LOSCache()
+{
+	ConfiguredSize = -1;
+	Mask = 0;
+	Hits = 0;
+	Misses = 0;
+	Expired = 0;
+	Recording = false;
+}
+
+LOSCache::~LOSCache()
+{
+}
+
+int16 LOSCache::Quantize(float Value, float Step)
+{
+	float q = floorf(Value / Step);
+
+	if(!(q > -32768.0f))
+		return -32768;
+
+	if(q > 32767.0f)
+		return 32767;
+
+	return (int16)q;
+}
+
+void LOSCache::Resize()
+{
+	ConfiguredSize = RuleI(Map, LOSCacheSize);
+
+	uint32 Size = 0;
+
+	if(ConfiguredSize > 0)
+	{
+		Size = 1;
+		while((Size << 1) <= (uint32)ConfiguredSize && Size < 0x100000)
+			Size <<= 1;
+	}
+
+	Entries.assign(Size, LOSCacheEntry());
+	Mask = Size > 0 ? Size - 1 : 0;
+}
+
+void LOSCache::Clear()
+{
+	if(!Entries.empty())
+		memset(&Entries[0], 0, Entries.size() * sizeof(LOSCacheEntry));
+
+	Hits = 0;
+	Misses = 0;
+	Expired = 0;
+}
+
+bool LOSCache::CheckLoS(Map *ZoneMap, const Map::Vertex &From, const Map::Vertex &To)
+{
+	uint32 Now = Timer::GetCurrentTime();
+
+	if(Recording)
+	{
+		LOSCacheQuery q;
+		q.From = From;
+		q.To = To;
+		q.Time = Now;
+		Recorded.push_back(q);
+
+		if(Recorded.size() >= LOS_CACHE_RECORD_MAX)
+			Recording = false;
+	}
+
+	return CheckLoSAt(ZoneMap, From, To, Now);
+}
+
+bool LOSCache::CheckLoSAt(Map *ZoneMap, const Map::Vertex &From, const Map::Vertex &To, uint32 Now)
+{
+	if(ConfiguredSize != RuleI(Map, LOSCacheSize))
+		Resize();
+
+	if(Entries.empty())
+		return ZoneMap->CheckLoS(From, To);
+
+	float CellSize = RuleR(Map, LOSCacheCellSize);
+	float ZBand = RuleR(Map, LOSCacheZBand);
+
+	if(CellSize <= 0.0f)
+		CellSize = 1.0f;
+
+	if(ZBand <= 0.0f)
+		ZBand = 1.0f;
+
+	uint32 Key[3];
+	Key[0] = ((uint32)(uint16)Quantize(From.x, CellSize) << 16) | (uint16)Quantize(From.y, CellSize);
+	Key[1] = ((uint32)(uint16)Quantize(From.z, ZBand) << 16) | (uint16)Quantize(To.x, CellSize);
+	Key[2] = ((uint32)(uint16)Quantize(To.y, CellSize) << 16) | (uint16)Quantize(To.z, ZBand);
+
+	uint32 Hash = Key[0] * 0x9E3779B1U ^ Key[1] * 0x85EBCA77U ^ Key[2] * 0xC2B2AE3DU;
+	Hash ^= Hash >> 15;
+
+	LOSCacheEntry &e = Entries[Hash & Mask];
+
+	if(e.Key[0] == Key[0] && e.Key[1] == Key[1] && e.Key[2] == Key[2] && e.Expires != 0)
+	{
+		if(e.Expires > Now)
+		{
+			++Hits;
+			return e.Result;
+		}
+
+		++Expired;
+	}
+
+	++Misses;
+
+	bool Result = ZoneMap->CheckLoS(From, To);
+
+	e.Key[0] = Key[0];
+	e.Key[1] = Key[1];
+	e.Key[2] = Key[2];
+	e.Expires = Now + RuleI(Map, LOSCacheTTL);
+	e.Result = Result;
+
+	// 0 marks an unused slot
+	if(e.Expires == 0)
+		e.Expires = 1;
+
+	return Result;
+}
+
+void LOSCache::ShowStats(Client *c)
+{
+	if(!c)
+		return;
+
+	uint32 Lookups = Hits + Misses;
+
+	c->Message(0, "LOS cache: %u slots, %u hits, %u misses (%.1f%% hit rate), %u of the misses were expired entries.",
+		(uint32)Entries.size(), Hits, Misses, Lookups > 0 ? (float)Hits * 100.0f / Lookups : 0.0f, Expired);
+
+	c->Message(0, "%u line of sight checks recorded%s.", (uint32)Recorded.size(), Recording ? ", still recording" : "");
+}
+
+void LOSCache::StartRecording()
+{
+	Recorded.clear();
+	Recorded.reserve(LOS_CACHE_RECORD_MAX);
+	Recording = true;
+}
+
+void LOSCache::StopRecording()
+{
+	Recording = false;
+}
+
+void LOSCache::Benchmark(Client *c, Map *ZoneMap)
+{
+	if(!c || !ZoneMap)
+		return;
+
+	if(Recorded.empty())
+	{
+		c->Message(0, "No line of sight checks recorded, use #loscache record first.");
+		return;
+	}
+
+	uint32 Count = Recorded.size();
+
+	std::vector<bool> Direct(Count);
+
+	RDTSC_Timer DirectTimer(true);
+
+	for(uint32 i = 0; i < Count; ++i)
+		Direct[i] = ZoneMap->CheckLoS(Recorded[i].From, Recorded[i].To);
+
+	DirectTimer.stop();
+
+	// a fresh cache so the live one's contents and counters don't skew the replay
+	LOSCache Replay;
+
+	uint32 Differ = 0;
+
+	RDTSC_Timer CachedTimer(true);
+
+	for(uint32 i = 0; i < Count; ++i)
+	{
+		if(Replay.CheckLoSAt(ZoneMap, Recorded[i].From, Recorded[i].To, Recorded[i].Time) != Direct[i])
+			++Differ;
+	}
+
+	CachedTimer.stop();
+
+	double DirectMS = DirectTimer.getDuration();
+	double CachedMS = CachedTimer.getDuration();
+
+	c->Message(0, "LOS replay of %u checks from %.1f seconds of play:", Count,
+		(Recorded.back().Time - Recorded.front().Time) / 1000.0f);
+	c->Message(0, "Uncached: %.3f ms, %.0f checks per second.", DirectMS, DirectMS > 0.0 ? Count * 1000.0 / DirectMS : 0.0);
+	c->Message(0, "Cached: %.3f ms, %.0f checks per second, %.1f%% hit rate, %u raycasts, %u results (%.2f%%) differ from a fresh raycast.",
+		CachedMS, CachedMS > 0.0 ? Count * 1000.0 / CachedMS : 0.0, (float)Replay.Hits * 100.0f / Count, Replay.Misses,
+		Differ, (float)Differ * 100.0f / Count);
+}
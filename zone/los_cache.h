@@ -0,0 +1,78 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef LOS_CACHE_H
+#define LOS_CACHE_H
+
+#include "map.h"
+#include "../common/types.h"
+#include <vector>
+
+class Client;
+
+// Most queries kept by #loscache record for the replay benchmark.
+#define LOS_CACHE_RECORD_MAX 65536
+
+struct LOSCacheEntry
+{
+	uint32 Key[3];
+	uint32 Expires;
+	bool Result;
+};
+
+struct LOSCacheQuery
+{
+	Map::Vertex From;
+	Map::Vertex To;
+	uint32 Time;
+};
+
+// Remembers line of sight raycasts for a short time. Both end points are rounded to
+// Map:LOSCacheCellSize in x/y and Map:LOSCacheZBand in z, so a camp re-checking a player
+// who hasn't moved much reuses the earlier raycast instead of casting again. The table is
+// direct mapped, a new result simply replaces whatever was in its slot.
+class LOSCache
+{
+public:
+	LOSCache();
+	~LOSCache();
+
+	bool CheckLoS(Map *ZoneMap, const Map::Vertex &From, const Map::Vertex &To);
+	void Clear();
+	void ShowStats(Client *c);
+	void StartRecording();
+	void StopRecording();
+	// Replays the recorded queries with and without the cache and reports both rates.
+	void Benchmark(Client *c, Map *ZoneMap);
+
+private:
+	bool CheckLoSAt(Map *ZoneMap, const Map::Vertex &From, const Map::Vertex &To, uint32 Now);
+	void Resize();
+	static int16 Quantize(float Value, float Step);
+
+	std::vector<LOSCacheEntry> Entries;
+	int ConfiguredSize;
+	uint32 Mask;
+	uint32 Hits;
+	uint32 Misses;
+	uint32 Expired;
+
+	bool Recording;
+	std::vector<LOSCacheQuery> Recorded;
+};
+
+#endif
@@ -842,7 +842,7 @@ Lua_HateList Lua_Mob::GetHateList() {
 	Lua_Safe_Call_Class(Lua_HateList);
 	Lua_HateList ret;
 	
-	auto h_list = self->GetHateList();
+	auto &h_list = self->GetHateList();
 	auto iter = h_list.begin();
 	while(iter != h_list.end()) {
 		Lua_HateEntry e(*iter);
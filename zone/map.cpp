@@ -2,7 +2,8 @@
 #include "../common/MiscFunctions.h"
 #include "map.h"
 #include "RaycastMesh.h"
-#include "zone.h"
+#include "../common/rulesys.h"
+#include <math.h>
 #include <stdint.h>
 #include <algorithm>
 #include <locale>
@@ -12,6 +13,22 @@
 #include <map>
 #include <zlib.h>
 
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//V3 maps are the prebuilt raycast mesh (see RaycastMesh::serialize) behind the version,
+//they are mapped read only and queried in place so every zone process on the box shares
+//the same pages instead of inflating and splitting its own copy.
+#define MAP_VERSION_V1 0x01000000
+#define MAP_VERSION_V2 0x02000000
+#define MAP_VERSION_V3 0x03000000
+
 uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_len_max) {
 	z_stream zstream;
 	int zerror = 0;
@@ -46,9 +63,170 @@ uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_
 	}
 }
 
+//a whole file mapped read only
+struct MappedMapFile
+{
+	MappedMapFile() : data(nullptr), size(0) {
+#ifdef _WINDOWS
+		mapping = nullptr;
+#endif
+	}
+
+	bool Open(const std::string &filename) {
+		Close();
+#ifdef _WINDOWS
+		HANDLE file = CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= (LONGLONG)sizeof(uint32) || file_size.HighPart != 0) {
+			CloseHandle(file);
+			return false;
+		}
+
+		mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if(!mapping) {
+			return false;
+		}
+
+		data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if(!data) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+			return false;
+		}
+		size = (size_t)file_size.QuadPart;
+#else
+		int fd = open(filename.c_str(), O_RDONLY);
+		if(fd == -1) {
+			return false;
+		}
+
+		struct stat st;
+		if(fstat(fd, &st) != 0 || st.st_size <= (off_t)sizeof(uint32) || (uint64)st.st_size > 0xFFFFFFFFULL) {
+			close(fd);
+			return false;
+		}
+
+		void *res = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if(res == MAP_FAILED) {
+			return false;
+		}
+		data = res;
+		size = (size_t)st.st_size;
+#endif
+		return true;
+	}
+
+	void Close() {
+		if(data) {
+#ifdef _WINDOWS
+			UnmapViewOfFile(data);
+			CloseHandle(mapping);
+			mapping = nullptr;
+#else
+			munmap(data, size);
+#endif
+			data = nullptr;
+			size = 0;
+		}
+	}
+
+	void *data;
+	size_t size;
+#ifdef _WINDOWS
+	HANDLE mapping;
+#endif
+};
+
+//maps and height fields are never rewritten in place, truncating a file a running zone has
+//mapped faults that zone. the new one is written to tmp and renamed over the old, which the
+//zones keep reading until they load it again.
+static bool ReplaceMappedFile(const std::string &tmp, const std::string &filename) {
+#ifdef _WINDOWS
+	//fails while a zone on this box still has the old file mapped
+	if(!MoveFileEx(tmp.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+	if(rename(tmp.c_str(), filename.c_str()) != 0) {
+#endif
+		remove(tmp.c_str());
+		return false;
+	}
+	return true;
+}
+
+//Height fields (.hgt next to the .map) let FindBestZ skip the raycast. Each cell keeps every
+//walkable layer found by vertical raycasts through it (so bridges and caves keep all of their
+//floors) as the heights at its four corners. A cell is only stored if the surfaces at the edge
+//midpoints and center agree with the corners, anything else is left for the raycast.
+#define HEIGHT_FIELD_MAGIC 0x46484745	// "EGHF"
+#define HEIGHT_FIELD_VERSION 1
+#define HEIGHT_FIELD_MAX_LAYERS 16
+
+struct HeightFieldHeader
+{
+	uint32 magic;
+	uint32 version;
+	float min_x;
+	float min_y;
+	float cell_size;
+	float tolerance;	//the most the stored heights may be off, queries this close to a layer use the raycast
+	uint32 cols;
+	uint32 rows;
+	uint32 layer_count;
+	//uint32 first_layer[cols * rows]
+	//HeightFieldLayer layers[layer_count]
+	//uint8 layer_counts[cols * rows], 0 means the cell has to be raycast
+};
+
+struct HeightFieldLayer
+{
+	float z[4];	//at (min x, min y), (max x, min y), (min x, max y), (max x, max y)
+};
+
 struct Map::impl
 {
+	impl() : rm(nullptr), hf(nullptr), hf_first(nullptr), hf_layers(nullptr), hf_counts(nullptr), hf_hits(0), hf_fallbacks(0) {
+	}
+
+	~impl() {
+		Clear();
+	}
+
+	void Clear() {
+		if(rm) {
+			rm->release();
+			rm = nullptr;
+		}
+
+		mesh_file.Close();
+		ClearHeightField();
+	}
+
+	void ClearHeightField() {
+		height_file.Close();
+		hf = nullptr;
+		hf_first = nullptr;
+		hf_layers = nullptr;
+		hf_counts = nullptr;
+	}
+
 	RaycastMesh *rm;
+	//set when rm is used in place from a V3 file
+	MappedMapFile mesh_file;
+
+	MappedMapFile height_file;
+	const HeightFieldHeader *hf;
+	const uint32 *hf_first;
+	const HeightFieldLayer *hf_layers;
+	const uint8 *hf_counts;
+	uint32 hf_hits;
+	uint32 hf_fallbacks;
 };
 
 Map::Map() {
@@ -56,9 +234,7 @@ Map::Map() {
 }
 
 Map::~Map() {
-	if(imp) {
-		imp->rm->release();
-	}
+	safe_delete(imp);
 }
 
 float Map::FindBestZ(Vertex &start, Vertex *result) const {
@@ -70,6 +246,19 @@ float Map::FindBestZ(Vertex &start, Vertex *result) const {
 		result = &tmp;
 
 	start.z += RuleI(Map, FindBestZHeightAdjust);
+
+	if(imp->hf && RuleB(Map, UseHeightField)) {
+		float z;
+		if(HeightFieldBestZ(start, z)) {
+			imp->hf_hits++;
+			result->x = start.x;
+			result->y = start.y;
+			result->z = z;
+			return z;
+		}
+		imp->hf_fallbacks++;
+	}
+
 	Vertex from(start.x, start.y, start.z);
 	Vertex to(start.x, start.y, BEST_Z_INVALID);
 	float hit_distance;
@@ -195,10 +384,11 @@ Map *Map::LoadMapFile(std::string file) {
 	filename += "/";
 	std::transform(file.begin(), file.end(), file.begin(), ::tolower);
 	filename += file;
-	filename += ".map";
 
 	Map *m = new Map();
-	if (m->Load(filename)) {
+	if (m->Load(filename + ".map")) {
+		//optional, FindBestZ raycasts everything without it
+		m->LoadHeightField(filename + ".hgt");
 		return m;
 	}
 
@@ -215,14 +405,17 @@ bool Map::Load(std::string filename) {
 			return false;
 		}
 		
-		if(version == 0x01000000) {
+		if(version == MAP_VERSION_V1) {
 			bool v = LoadV1(f);
 			fclose(f);
 			return v;
-		} else if(version == 0x02000000) {
+		} else if(version == MAP_VERSION_V2) {
 			bool v = LoadV2(f);
 			fclose(f);
 			return v;
+		} else if(version == MAP_VERSION_V3) {
+			fclose(f);
+			return LoadV3(filename);
 		} else {
 			fclose(f);
 			return false;
@@ -284,8 +477,7 @@ bool Map::LoadV1(FILE *f) {
 	}
 	
 	if(imp) {
-		imp->rm->release();
-		imp->rm = nullptr;
+		imp->Clear();
 	} else {
 		imp = new impl;
 	}
@@ -840,8 +1032,7 @@ bool Map::LoadV2(FILE *f) {
 	uint32 face_count = indices.size() / 3;
 
 	if (imp) {
-		imp->rm->release();
-		imp->rm = nullptr;
+		imp->Clear();
 	}
 	else {
 		imp = new impl;
@@ -858,6 +1049,307 @@ bool Map::LoadV2(FILE *f) {
 	return true;
 }
 
+bool Map::LoadV3(std::string filename) {
+	MappedMapFile file;
+	if(!file.Open(filename)) {
+		return false;
+	}
+
+	const char *data = (const char*)file.data + sizeof(uint32);
+	RaycastMesh *rm = createRaycastMeshInPlace(data, (RmUint32)(file.size - sizeof(uint32)));
+	if(!rm) {
+		file.Close();
+		return false;
+	}
+
+	if(imp) {
+		imp->Clear();
+	} else {
+		imp = new impl;
+	}
+
+	imp->rm = rm;
+	imp->mesh_file = file;
+	return true;
+}
+
+bool Map::Save(std::string filename) const {
+	if(!imp || !imp->rm) {
+		return false;
+	}
+
+	std::vector<char> buffer(imp->rm->getSerializedSize());
+	imp->rm->serialize(&buffer[0]);
+
+	std::string tmp = filename + ".tmp";
+	FILE *f = fopen(tmp.c_str(), "wb");
+	if(!f) {
+		return false;
+	}
+
+	uint32 version = MAP_VERSION_V3;
+	bool ok = fwrite(&version, sizeof(version), 1, f) == 1 && fwrite(&buffer[0], buffer.size(), 1, f) == 1;
+	if(fclose(f) != 0) {
+		ok = false;
+	}
+
+	if(!ok) {
+		remove(tmp.c_str());
+		return false;
+	}
+
+	return ReplaceMappedFile(tmp, filename);
+}
+
+bool Map::IsMapped() const {
+	return imp && imp->mesh_file.data;
+}
+
+//answers FindBestZ from the height field, false if the raycast has to decide
+bool Map::HeightFieldBestZ(const Vertex &start, float &z) const {
+	const HeightFieldHeader *hf = imp->hf;
+	float fx = (start.x - hf->min_x) / hf->cell_size;
+	float fy = (start.y - hf->min_y) / hf->cell_size;
+	if(!(fx >= 0.0f) || !(fy >= 0.0f) || fx >= (float)hf->cols || fy >= (float)hf->rows) {
+		return false;
+	}
+
+	uint32 cx = (uint32)fx;
+	uint32 cy = (uint32)fy;
+	if(cx >= hf->cols || cy >= hf->rows) {
+		return false;
+	}
+
+	uint32 cell = cy * hf->cols + cx;
+	uint32 count = imp->hf_counts[cell];
+	if(count == 0) {
+		return false;
+	}
+
+	float u = fx - (float)cx;
+	float v = fy - (float)cy;
+	const HeightFieldLayer *layer = &imp->hf_layers[imp->hf_first[cell]];
+	bool below = false;
+	bool above = false;
+	float best_below = 0.0f;
+	float best_above = 0.0f;
+	for(uint32 i = 0; i < count; ++i, ++layer) {
+		float lz = layer->z[0] * (1.0f - u) * (1.0f - v) + layer->z[1] * u * (1.0f - v) +
+			layer->z[2] * (1.0f - u) * v + layer->z[3] * u * v;
+
+		//too close to tell which side of the surface we are on
+		if(fabs(lz - start.z) <= hf->tolerance) {
+			return false;
+		}
+
+		if(lz < start.z) {
+			if(!below || lz > best_below) {
+				best_below = lz;
+				below = true;
+			}
+		} else if(!above || lz < best_above) {
+			best_above = lz;
+			above = true;
+		}
+	}
+
+	if(below) {
+		z = best_below;
+		return true;
+	}
+
+	if(above) {
+		z = best_above;
+		return true;
+	}
+
+	return false;
+}
+
+bool Map::LoadHeightField(std::string filename) {
+	if(!imp) {
+		return false;
+	}
+
+	imp->ClearHeightField();
+	if(!imp->height_file.Open(filename)) {
+		return false;
+	}
+
+	const char *data = (const char*)imp->height_file.data;
+	size_t size = imp->height_file.size;
+	const HeightFieldHeader *hf = (const HeightFieldHeader*)data;
+	if(size < sizeof(HeightFieldHeader) || hf->magic != HEIGHT_FIELD_MAGIC || hf->version != HEIGHT_FIELD_VERSION ||
+		!(hf->cell_size > 0.0f) || !(hf->tolerance >= 0.0f)) {
+		imp->ClearHeightField();
+		return false;
+	}
+
+	uint64 cells = (uint64)hf->cols * hf->rows;
+	uint64 expected = sizeof(HeightFieldHeader) + cells * sizeof(uint32) + (uint64)hf->layer_count * sizeof(HeightFieldLayer) + cells;
+	if(expected != size) {
+		imp->ClearHeightField();
+		return false;
+	}
+
+	const uint32 *first = (const uint32*)(data + sizeof(HeightFieldHeader));
+	const HeightFieldLayer *layers = (const HeightFieldLayer*)(first + cells);
+	const uint8 *counts = (const uint8*)(layers + hf->layer_count);
+	for(uint64 i = 0; i < cells; ++i) {
+		if(counts[i] != 0 && ((uint64)first[i] + counts[i] > hf->layer_count)) {
+			imp->ClearHeightField();
+			return false;
+		}
+	}
+
+	imp->hf = hf;
+	imp->hf_first = first;
+	imp->hf_layers = layers;
+	imp->hf_counts = counts;
+	return true;
+}
+
+//every surface straight down through x, y, lowest first
+static void HeightFieldSample(RaycastMesh *rm, float x, float y, float top, float bottom, std::vector<float> &out) {
+	out.clear();
+	Map::Vertex from(x, y, top);
+	Map::Vertex to(x, y, bottom);
+	Map::Vertex hit;
+	while(out.size() <= HEIGHT_FIELD_MAX_LAYERS && rm->raycast((const RmReal*)&from, (const RmReal*)&to, (RmReal*)&hit, nullptr, nullptr)) {
+		out.push_back(hit.z);
+		from.z = hit.z - 0.05f;
+		if(from.z <= bottom) {
+			break;
+		}
+	}
+	std::reverse(out.begin(), out.end());
+}
+
+bool Map::SaveHeightField(std::string filename, float cell_size, float tolerance) const {
+	if(!imp || !imp->rm || !(cell_size > 0.0f) || !(tolerance >= 0.0f)) {
+		return false;
+	}
+
+	const RmReal *bmin = imp->rm->getBoundMin();
+	const RmReal *bmax = imp->rm->getBoundMax();
+	HeightFieldHeader hf;
+	hf.magic = HEIGHT_FIELD_MAGIC;
+	hf.version = HEIGHT_FIELD_VERSION;
+	hf.min_x = bmin[0];
+	hf.min_y = bmin[1];
+	hf.cell_size = cell_size;
+	hf.tolerance = tolerance;
+	hf.cols = (uint32)ceil((bmax[0] - bmin[0]) / cell_size) + 1;
+	hf.rows = (uint32)ceil((bmax[1] - bmin[1]) / cell_size) + 1;
+	float top = bmax[2] + 10.0f;
+	float bottom = bmin[2] - 10.0f;
+
+	std::vector<uint32> first(hf.cols * hf.rows, 0);
+	std::vector<uint8> counts(hf.cols * hf.rows, 0);
+	std::vector<HeightFieldLayer> layers;
+
+	//samples every half cell, only the three half rows a row of cells needs are kept
+	uint32 half_cols = hf.cols * 2 + 1;
+	std::vector<std::vector<float> > rows[3];
+	for(int i = 0; i < 3; ++i) {
+		rows[i].resize(half_cols);
+	}
+
+	float half = cell_size / 2.0f;
+	for(uint32 hx = 0; hx < half_cols; ++hx) {
+		HeightFieldSample(imp->rm, hf.min_x + hx * half, hf.min_y, top, bottom, rows[0][hx]);
+	}
+
+	for(uint32 cy = 0; cy < hf.rows; ++cy) {
+		for(uint32 hx = 0; hx < half_cols; ++hx) {
+			HeightFieldSample(imp->rm, hf.min_x + hx * half, hf.min_y + (cy * 2 + 1) * half, top, bottom, rows[1][hx]);
+			HeightFieldSample(imp->rm, hf.min_x + hx * half, hf.min_y + (cy * 2 + 2) * half, top, bottom, rows[2][hx]);
+		}
+
+		for(uint32 cx = 0; cx < hf.cols; ++cx) {
+			const std::vector<float> *s[3][3];
+			for(int a = 0; a < 3; ++a) {
+				for(int b = 0; b < 3; ++b) {
+					s[a][b] = &rows[b][cx * 2 + a];
+				}
+			}
+
+			size_t count = s[0][0]->size();
+			bool usable = count > 0 && count <= HEIGHT_FIELD_MAX_LAYERS;
+			for(int a = 0; a < 3 && usable; ++a) {
+				for(int b = 0; b < 3 && usable; ++b) {
+					usable = s[a][b]->size() == count;
+				}
+			}
+
+			for(size_t k = 0; k < count && usable; ++k) {
+				float c00 = (*s[0][0])[k];
+				float c10 = (*s[2][0])[k];
+				float c01 = (*s[0][2])[k];
+				float c11 = (*s[2][2])[k];
+				for(int a = 0; a < 3 && usable; ++a) {
+					for(int b = 0; b < 3 && usable; ++b) {
+						float u = a / 2.0f;
+						float v = b / 2.0f;
+						float expect = c00 * (1.0f - u) * (1.0f - v) + c10 * u * (1.0f - v) + c01 * (1.0f - u) * v + c11 * u * v;
+						usable = fabs(expect - (*s[a][b])[k]) <= tolerance;
+					}
+				}
+			}
+
+			if(!usable) {
+				continue;
+			}
+
+			uint32 cell = cy * hf.cols + cx;
+			first[cell] = (uint32)layers.size();
+			counts[cell] = (uint8)count;
+			for(size_t k = 0; k < count; ++k) {
+				HeightFieldLayer l;
+				l.z[0] = (*s[0][0])[k];
+				l.z[1] = (*s[2][0])[k];
+				l.z[2] = (*s[0][2])[k];
+				l.z[3] = (*s[2][2])[k];
+				layers.push_back(l);
+			}
+		}
+
+		rows[0].swap(rows[2]);
+	}
+
+	hf.layer_count = (uint32)layers.size();
+
+	std::string tmp = filename + ".tmp";
+	FILE *f = fopen(tmp.c_str(), "wb");
+	if(!f) {
+		return false;
+	}
+
+	bool ok = fwrite(&hf, sizeof(hf), 1, f) == 1 &&
+		fwrite(&first[0], sizeof(uint32), first.size(), f) == first.size() &&
+		(layers.empty() || fwrite(&layers[0], sizeof(HeightFieldLayer), layers.size(), f) == layers.size()) &&
+		fwrite(&counts[0], sizeof(uint8), counts.size(), f) == counts.size();
+	if(fclose(f) != 0) {
+		ok = false;
+	}
+
+	if(!ok) {
+		remove(tmp.c_str());
+		return false;
+	}
+
+	return ReplaceMappedFile(tmp, filename);
+}
+
+bool Map::HasHeightField() const {
+	return imp && imp->hf;
+}
+
+void Map::GetHeightFieldStats(uint32 &hits, uint32 &fallbacks) const {
+	hits = imp ? imp->hf_hits : 0;
+	fallbacks = imp ? imp->hf_fallbacks : 0;
+}
+
 void Map::RotateVertex(Vertex &v, float rx, float ry, float rz) {
 	Vertex nv = v;
 
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <string>
+#include "../common/types.h"
 
 #define BEST_Z_INVALID -99999
 
@@ -55,6 +56,15 @@ public:
 	bool LineIntersectsZoneNoZLeaps(Vertex start, Vertex end, float step_mag, Vertex *result) const;
 	bool CheckLoS(Vertex myloc, Vertex oloc) const;
 	bool Load(std::string filename);
+	//writes the loaded map out in the V3 (prebuilt, mappable) format
+	bool Save(std::string filename) const;
+	//true if the map is being queried in place from a mapped V3 file
+	bool IsMapped() const;
+	//the height field FindBestZ uses before raycasting, see Map::SaveHeightField
+	bool LoadHeightField(std::string filename);
+	bool SaveHeightField(std::string filename, float cell_size, float tolerance) const;
+	bool HasHeightField() const;
+	void GetHeightFieldStats(uint32 &hits, uint32 &fallbacks) const;
 	static Map *LoadMapFile(std::string file);
 private:
 	void RotateVertex(Vertex &v, float rx, float ry, float rz);
@@ -62,6 +72,8 @@ private:
 	void TranslateVertex(Vertex &v, float tx, float ty, float tz);
 	bool LoadV1(FILE *f);
 	bool LoadV2(FILE *f);
+	bool LoadV3(std::string filename);
+	bool HeightFieldBestZ(const Vertex &start, float &z) const;
 	
 	struct impl;
 	impl *imp;
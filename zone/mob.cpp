@@ -88,14 +88,12 @@ Mob::Mob(const char* in_name,
 		attack_timer(2000),
 		attack_dw_timer(2000),
 		ranged_timer(2000),
-		tic_timer(6000),
-		mana_timer(2000),
+		tic_timer(this, &Mob::TicExpired),
 		spellend_timer(0),
 		rewind_timer(30000), //Timer used for determining amount of time between actual player position updates for /rewind.
-		bindwound_timer(10000),
-		stunned_timer(0),
+		stunned_timer(this, &Mob::StunExpired),
 		spun_timer(0),
-		bardsong_timer(6000),
+		bardsong_timer(this, &Mob::BardSongExpired),
 		gravity_timer(1000),
 		viral_timer(0),
 		flee_timer(FLEE_CHECK_TIMER),
@@ -270,7 +268,6 @@ Mob::Mob(const char* in_name,
 	pRunAnimSpeed = 0;
 
 	spellend_timer.Disable();
-	bardsong_timer.Disable();
 	bardsong = 0;
 	bardsong_target_id = 0;
 	casting_spell_id = 0;
@@ -345,7 +342,6 @@ Mob::Mob(const char* in_name,
 	qglobal = in_qglobal != 0;
 
 	// Bind wound
-	bindwound_timer.Disable();
 	bindwound_target = 0;
 
 	trade = new Trade(this);
@@ -2339,10 +2335,8 @@ void Mob::FaceTarget(Mob* MobToFace) {
 		}
 	}
 
-	if(IsNPC() && !IsEngaged()) {
-		CastToNPC()->GetRefaceTimer()->Start(15000);
-		CastToNPC()->GetRefaceTimer()->Enable();
-	}
+	if(IsNPC() && !IsEngaged())
+		CastToNPC()->StartRefaceTimer();
 }
 
 bool Mob::RemoveFromHateList(Mob* mob)
@@ -4636,6 +4630,9 @@ void Mob::AddFactionBonus(uint32 pFactionID,int32 bonus) {
 			faction_bonuses.insert(NewFactionBonus(pFactionID,bonus));
 		}
 	}
+
+	if(IsClient())
+		CastToClient()->ClearFactionConCache();
 }
 
 // Faction Mods from items
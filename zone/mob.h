@@ -23,6 +23,7 @@
 #include "entity.h"
 #include "hate_list.h"
 #include "pathing.h"
+#include "../common/timer_wheel.h"
 #include <set>
 #include <vector>
 #include <string>
@@ -451,7 +452,7 @@ public:
 	void RemoveFromFeignMemory(Client* attacker);
 	void ClearFeignMemory();
 	void PrintHateListToClient(Client *who) { hate_list.PrintToClient(who); }
-	std::list<tHateEntry*>& GetHateList() { return hate_list.GetHateList(); }
+	std::vector<tHateEntry*>& GetHateList() { return hate_list.GetHateList(); }
 	bool CheckLosFN(Mob* other);
 	bool CheckLosFN(float posX, float posY, float posZ, float mobSize);
 	bool CheckRegion(Mob* other);
@@ -553,6 +554,10 @@ public:
 		uint32 in_drakkin_details = 0xFFFFFFFF, float in_size = 0xFFFFFFFF);
 	virtual void Stun(int duration);
 	virtual void UnStun();
+	//run from the zone's timer wheel instead of being polled by Process
+	void StunExpired();
+	virtual void TicExpired() { }
+	virtual void BardSongExpired() { }
 	inline void Silence(bool newval) { silenced = newval; }
 	inline void Amnesia(bool newval) { amnesiad = newval; }
 	void TemporaryPets(uint16 spell_id, Mob *target, const char *name_override = nullptr, uint32 duration_override = 0);
@@ -1040,8 +1045,7 @@ protected:
 	Timer ranged_timer;
 	float attack_speed; //% increase/decrease in attack speed (not haste)
 	float slow_mitigation; // Allows for a slow mitigation (100 = 100%, 50% = 50%)
-	Timer tic_timer;
-	Timer mana_timer;
+	TimerWheel::Callback<Mob> tic_timer;
 
 	//spell casting vars
 	Timer spellend_timer;
@@ -1106,12 +1110,11 @@ protected:
 	bool has_ProjectIllusion;
 
 	// Bind wound
-	Timer bindwound_timer;
 	Mob* bindwound_target;
 
-	Timer stunned_timer;
+	TimerWheel::Callback<Mob> stunned_timer;
 	Timer spun_timer;
-	Timer bardsong_timer;
+	TimerWheel::Callback<Mob> bardsong_timer;
 	Timer gravity_timer;
 	Timer viral_timer;
 	uint8 viral_timer_counter;
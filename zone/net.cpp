@@ -42,6 +42,8 @@
 #include "../common/memory_mapped_file.h"
 #include "../common/eqemu_exception.h"
 #include "../common/spdat.h"
+#include "../common/tick_profiler.h"
+#include "../common/timer_wheel.h"
 
 #include "ZoneConfig.h"
 #include "masterentity.h"
@@ -78,6 +80,8 @@
 	#include <process.h>
 #else
 	#include <pthread.h>
+	#include <sys/resource.h>
+	#include <unistd.h>
 	#include "../common/unix.h"
 #endif
 
@@ -97,6 +101,9 @@ npcDecayTimes_Struct npcCorpseDecayTimes[100];
 TitleManager title_manager;
 DBAsyncFinishedQueue MTdbafq;
 DBAsync *dbasync = nullptr;
+TickProfiler tick_profiler;
+//entity timers that fire from the main loop instead of being polled, see NPC::HPUpdateExpired
+TimerWheel timer_wheel;
 QuestParserCollection *parse = 0;
 
 const SPDat_Spell_Struct* spells;
@@ -104,6 +111,8 @@ void LoadSpells(EQEmu::MemoryMappedFile **mmf);
 int32 SPDAT_RECORDS = -1;
 
 void Shutdown();
+void SendTickProfile(uint32 interval);
+void SendLoadReport(uint32 interval);
 extern void MapOpcodes();
 
 int main(int argc, char** argv) {
@@ -115,8 +124,8 @@ int main(int argc, char** argv) {
 	if(argc == 3) {
 		worldserver.SetLauncherName(argv[2]);
 		worldserver.SetLaunchedName(argv[1]);
-		if(strncmp(argv[1], "dynamic_", 8) == 0) {
-			//dynamic zone with a launcher name correlation
+		if(strncmp(argv[1], "dynamic_", 8) == 0 || strncmp(argv[1], "warm_", 5) == 0) {
+			//dynamic or warm zone with a launcher name correlation
 			zone_name = ".";
 		} else {
 			zone_name = argv[1];
@@ -125,8 +134,8 @@ int main(int argc, char** argv) {
 	} else if (argc == 2) {
 		worldserver.SetLauncherName("NONE");
 		worldserver.SetLaunchedName(argv[1]);
-		if(strncmp(argv[1], "dynamic_", 8) == 0) {
-			//dynamic zone with a launcher name correlation
+		if(strncmp(argv[1], "dynamic_", 8) == 0 || strncmp(argv[1], "warm_", 5) == 0) {
+			//dynamic or warm zone with a launcher name correlation
 			zone_name = ".";
 		} else {
 			zone_name = argv[1];
@@ -162,7 +171,7 @@ int main(int argc, char** argv) {
 		_log(ZONE__INIT_ERR, "Cannot continue without a database connection.");
 		return 1;
 	}
-	dbasync = new DBAsync(&database);
+	dbasync = new DBAsync(&database, Config->DatabaseAsyncWorkers);
 	dbasync->AddFQ(&MTdbafq);
 	guild_mgr.SetDatabase(&database);
 
@@ -209,6 +218,12 @@ int main(int argc, char** argv) {
 		_log(ZONE__INIT, "Failed. But ignoring error and going on...");
 	}
 
+	_log(ZONE__INIT, "Loading npc types");
+	if (!database.LoadNPCTypes()) {
+		_log(ZONE__INIT_ERR, "Loading npc types FAILED!");
+		_log(ZONE__INIT, "Failed. NPC types will be read from the database as they are needed.");
+	}
+
 	_log(ZONE__INIT, "Loading npc faction lists");
 	if (!database.LoadNPCFactionLists()) {
 		_log(ZONE__INIT_ERR, "Loading npcs faction lists FAILED!");
@@ -330,14 +345,28 @@ int main(int argc, char** argv) {
 	uint8 ZONEUPDATE = 10;
 	Timer zoneupdate_timer(ZONEUPDATE);
 	zoneupdate_timer.Start();
+	Timer tick_profile_timer(RuleI(Zone, TickProfileReportInterval) * 1000);
+	uint32 tick_profile_sent = Timer::GetCurrentTime();
+	Timer load_report_timer(RuleI(Zone, LoadReportInterval) * 1000);
+	uint32 load_report_sent = Timer::GetCurrentTime();
 	while(RunLoops) {
 		{	//profiler block to omit the sleep from times
 
 		//Advance the timer to our current point in time
 		Timer::SetCurrentTime();
+		//keep the wheel's clock current while idle, so a zone booting below schedules against now
+		//instead of stepping through every millisecond since the last zone went down
+		if (!ZoneLoaded)
+			timer_wheel.Advance(Timer::GetCurrentTime());
 
 		//process stuff from world
-		worldserver.Process();
+		{
+			TickProfiler::Scope ps(tick_profiler, TickSectionWorld);
+			worldserver.Process();
+		}
+
+		{
+		TickProfiler::Scope ps(tick_profiler, TickSectionStreams);
 
 		if (!eqsf.IsOpen() && Config->ZonePort!=0) {
 			_log(ZONE__INIT, "Starting EQ Network server on port %d",Config->ZonePort);
@@ -383,6 +412,7 @@ int main(int argc, char** argv) {
 			Client* client = new Client(eqsi);
 			entity_list.AddClient(client);
 		}
+		}
 
 		if ( numclients < 1 && zoneupdate_timer.GetDuration() != IDLEZONEUPDATE )
 			zoneupdate_timer.SetTimer(IDLEZONEUPDATE);
@@ -406,6 +436,7 @@ int main(int argc, char** argv) {
 
 		if (ZoneLoaded && zoneupdate_timer.Check()) {
 			{
+				TickProfiler::Scope ps(tick_profiler, TickSectionEntityProcess);
 				if(net.group_timer.Enabled() && net.group_timer.Check())
 					entity_list.GroupProcess();
 
@@ -425,25 +456,55 @@ int main(int argc, char** argv) {
 					entity_list.RaidProcess();
 
 				entity_list.Process();
+			}
 
+			{
+				TickProfiler::Scope ps(tick_profiler, TickSectionMobProcess);
+				timer_wheel.Advance(Timer::GetCurrentTime());
 				entity_list.MobProcess();
 
 				entity_list.BeaconProcess();
+			}
 
+			{
+				TickProfiler::Scope ps(tick_profiler, TickSectionZoneProcess);
 				if (zone) {
 					if(!zone->Process()) {
 						Zone::Shutdown();
 					}
 				}
+			}
 
-				if(quest_timers.Check())
-					quest_manager.Process();
+			if(quest_timers.Check()) {
+				TickProfiler::Scope ps(tick_profiler, TickSectionQuestTimers);
+				quest_manager.Process();
+			}
 
+			tick_profiler.SetBudget(RuleI(Zone, TickProfileBudget) * 1000);
+			tick_profiler.EndTick();
+		}
+		{
+			TickProfiler::Scope ps(tick_profiler, TickSectionDBAsync);
+			DBAsyncWork* dbaw = 0;
+			while ((dbaw = MTdbafq.Pop())) {
+				DispatchFinishedDBAsync(dbaw);
 			}
+			dbasync->DispatchCallbacks();
+		}
+
+		if (!ZoneLoaded) {
+			tick_profiler.DiscardCurrent();
+		}
+		else if (tick_profile_timer.Check() && RuleI(Zone, TickProfileReportInterval) > 0) {
+			SendTickProfile(Timer::GetCurrentTime() - tick_profile_sent);
+			tick_profile_sent = Timer::GetCurrentTime();
+			tick_profile_timer.SetTimer(RuleI(Zone, TickProfileReportInterval) * 1000);
 		}
-		DBAsyncWork* dbaw = 0;
-		while ((dbaw = MTdbafq.Pop())) {
-			DispatchFinishedDBAsync(dbaw);
+		//idle zones report too, world places boots by their host's load
+		if (load_report_timer.Check() && RuleI(Zone, LoadReportInterval) > 0) {
+			SendLoadReport(Timer::GetCurrentTime() - load_report_sent);
+			load_report_sent = Timer::GetCurrentTime();
+			load_report_timer.SetTimer(RuleI(Zone, LoadReportInterval) * 1000);
 		}
 		if (InterserverTimer.Check()) {
 			InterserverTimer.Start();
@@ -520,6 +581,84 @@ void CatchSignal(int sig_num) {
 	RunLoops = false;
 }
 
+//sends the rolling main loop timings to world, where they can be read from the console and EQW
+void SendTickProfile(uint32 interval)
+{
+	if (!worldserver.Connected() || zone == nullptr)
+		return;
+
+	ServerPacket* pack = new ServerPacket(ServerOP_ZoneTickProfile, sizeof(ServerZoneTickProfile_Struct));
+	ServerZoneTickProfile_Struct* tp = (ServerZoneTickProfile_Struct*)pack->pBuffer;
+	tp->zone_id = zone->GetZoneID();
+	tp->instance_id = zone->GetInstanceID();
+	tp->ticks = tick_profiler.GetTickCount();
+	tp->budget = RuleI(Zone, TickProfileBudget) * 1000;
+	tp->over_budget = tick_profiler.GetOverBudget();
+	tp->interval = interval;
+	for (int i = 0; i < TickSectionCount; i++)
+		tick_profiler.Summarize((TickSection)i, tp->sections[i]);
+	tick_profiler.ResetOverBudget();
+
+	worldserver.SendPacket(pack);
+	safe_delete(pack);
+}
+
+//usec of cpu this process has used
+static uint64 ProcessCPUTime()
+{
+#ifdef _WINDOWS
+	FILETIME create_time, exit_time, kernel_time, user_time;
+	if (!GetProcessTimes(GetCurrentProcess(), &create_time, &exit_time, &kernel_time, &user_time))
+		return 0;
+	uint64 kernel = ((uint64)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime;
+	uint64 user = ((uint64)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime;
+	return (kernel + user) / 10;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return (uint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+void SendLoadReport(uint32 interval)
+{
+	static uint64 last_cpu = 0;
+	uint64 cpu = ProcessCPUTime();
+	uint64 used = cpu >= last_cpu ? cpu - last_cpu : 0;
+	bool first = last_cpu == 0;
+	last_cpu = cpu;
+
+	if (!worldserver.Connected() || interval == 0)
+		return;
+
+	ServerPacket* pack = new ServerPacket(ServerOP_ZoneLoad, sizeof(ServerZoneLoad_Struct));
+	ServerZoneLoad_Struct* zl = (ServerZoneLoad_Struct*)pack->pBuffer;
+	//usec used per ms of wall time is tenths of a percent, x100 percent is x10
+	zl->cpu = first ? 0 : (uint32)(used * 10 / interval);
+#ifdef _WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	zl->host_cpus = info.dwNumberOfProcessors;
+	zl->host_load = 0;
+#else
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	zl->host_cpus = cpus > 0 ? (uint32)cpus : 0;
+	double load[1];
+	zl->host_load = getloadavg(load, 1) == 1 ? (uint32)(load[0] * 100.0) : 0;
+#endif
+	if (ZoneLoaded && tick_profiler.GetTickCount() > 0) {
+		TickSectionSummary total;
+		tick_profiler.Summarize(TickSectionTotal, total);
+		zl->tick_avg = total.avg;
+		zl->tick_p99 = total.p99;
+	}
+	zl->clients = numclients;
+
+	worldserver.SendPacket(pack);
+	safe_delete(pack);
+}
+
 void Shutdown()
 {
 	Zone::Shutdown(true);
@@ -51,6 +51,7 @@
 extern Zone* zone;
 extern volatile bool ZoneLoaded;
 extern EntityList entity_list;
+extern TimerWheel timer_wheel;
 
 #include "QuestParserCollection.h"
 
@@ -110,9 +111,10 @@ NPC::NPC(const NPCType* d, Spawn2* in_respawn, float x, float y, float z, float
 	classattack_timer(1000),
 	knightattack_timer(1000),
 	assist_timer(AIassistcheck_delay),
-	qglobal_purge_timer(30000),
-	sendhpupdate_timer(1000),
+	qglobal_purge_timer(this, &NPC::QGlobalPurgeExpired),
+	sendhpupdate_timer(this, &NPC::HPUpdateExpired),
 	enraged_timer(1000),
+	reface_timer(this, &NPC::RefaceExpired),
 	taunt_timer(TauntReuseTime * 1000)
 {
 	//What is the point of this, since the names get mangled..
@@ -267,8 +269,6 @@ NPC::NPC(const NPCType* d, Spawn2* in_respawn, float x, float y, float z, float
 		skills[r] = database.GetSkillCap(GetClass(),(SkillUseTypes)r,moblevel);
 	}
 
-	reface_timer = new Timer(15000);
-	reface_timer->Disable();
 	qGlobals = nullptr;
 	guard_x_saved = 0;
 	guard_y_saved = 0;
@@ -277,6 +277,10 @@ NPC::NPC(const NPCType* d, Spawn2* in_respawn, float x, float y, float z, float
 	SetEmoteID(d->emoteid);
 	InitializeBuffSlots();
 	CalcBonuses();
+
+	timer_wheel.Schedule(&sendhpupdate_timer, 1000);
+	timer_wheel.Schedule(&qglobal_purge_timer, 30000);
+	timer_wheel.Schedule(&tic_timer, 6000);
 }
 
 NPC::~NPC()
@@ -312,7 +316,6 @@ NPC::~NPC()
 	faction_list.clear();
 	}
 
-	safe_delete(reface_timer);
 	safe_delete(swarmInfoPtr);
 	safe_delete(qGlobals);
 	UninitializeBuffSlots();
@@ -473,13 +476,6 @@ void NPC::RemoveCash() {
 
 bool NPC::Process()
 {
-	if (IsStunned() && stunned_timer.Check())
-	{
-		this->stunned = false;
-		this->stunned_timer.Disable();
-		this->spun_timer.Disable();
-	}
-
 	if (p_depop)
 	{
 		Mob* owner = entity_list.GetMob(this->ownerid);
@@ -495,50 +491,6 @@ bool NPC::Process()
 
 	SpellProcess();
 
-	if(tic_timer.Check())
-	{
-		BuffProcess();
-
-		if(curfp)
-			ProcessFlee();
-
-		uint32 bonus = 0;
-
-		if(GetAppearance() == eaSitting)
-			bonus+=3;
-
-		int32 OOCRegen = 0;
-		if(oocregen > 0){ //should pull from Mob class
-			OOCRegen += GetMaxHP() * oocregen / 100;
-			}
-		//Lieka Edit:Fixing NPC regen.NPCs should regen to full during a set duration, not based on their HPs.Increase NPC's HPs by % of total HPs / tick.
-		if((GetHP() < GetMaxHP()) && !IsPet()) {
-			if(!IsEngaged()) {//NPC out of combat
-				if(GetNPCHPRegen() > OOCRegen)
-					SetHP(GetHP() + GetNPCHPRegen());
-				else
-					SetHP(GetHP() + OOCRegen);
-			} else
-				SetHP(GetHP()+GetNPCHPRegen());
-		} else if(GetHP() < GetMaxHP() && GetOwnerID() !=0) {
-			if(!IsEngaged()) //pet
-				SetHP(GetHP()+GetNPCHPRegen()+bonus+(GetLevel()/5));
-			else
-				SetHP(GetHP()+GetNPCHPRegen()+bonus);
-		} else
-			SetHP(GetHP()+GetNPCHPRegen());
-
-		if(GetMana() < GetMaxMana()) {
-			SetMana(GetMana()+mana_regen+bonus);
-		}
-	}
-
-	if (sendhpupdate_timer.Check() && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient()))) {
-		if(!IsFullHP || cur_hp<max_hp){
-			SendHPUpdate();
-		}
-	}
-
 	if(HasVirus()) {
 		if(viral_timer.Check()) {
 			viral_timer_counter++;
@@ -559,12 +511,6 @@ bool NPC::Process()
 			DoGravityEffect();
 	}
 
-	if(reface_timer->Check() && !IsEngaged() && (guard_x == GetX() && guard_y == GetY() && guard_z == GetZ())) {
-		SetHeading(guard_heading);
-		SendPosition();
-		reface_timer->Disable();
-	}
-
 	if (IsMezzed())
 		return true;
 
@@ -583,17 +529,98 @@ bool NPC::Process()
 		entity_list.AIYellForHelp(this, GetTarget());
 	}
 
+	AI_Process();
+
+	return true;
+}
+
+void NPC::HPUpdateExpired()
+{
+	//being removed, Process won't run again either
+	if (p_depop)
+		return;
+
+	timer_wheel.Schedule(&sendhpupdate_timer, 1000);
+
+	if (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient())) {
+		if(!IsFullHP || cur_hp<max_hp){
+			SendHPUpdate();
+		}
+	}
+}
+
+void NPC::QGlobalPurgeExpired()
+{
+	if (p_depop)
+		return;
+
+	timer_wheel.Schedule(&qglobal_purge_timer, 30000);
+
 	if(qGlobals)
-	{
-		if(qglobal_purge_timer.Check())
-		{
-			qGlobals->PurgeExpiredGlobals();
+		qGlobals->PurgeExpiredGlobals();
+}
+
+void NPC::TicExpired()
+{
+	if (p_depop)
+		return;
+
+	timer_wheel.Schedule(&tic_timer, 6000);
+
+	BuffProcess();
+
+	if(curfp)
+		ProcessFlee();
+
+	uint32 bonus = 0;
+
+	if(GetAppearance() == eaSitting)
+		bonus+=3;
+
+	int32 OOCRegen = 0;
+	if(oocregen > 0){ //should pull from Mob class
+		OOCRegen += GetMaxHP() * oocregen / 100;
 		}
+	//Lieka Edit:Fixing NPC regen.NPCs should regen to full during a set duration, not based on their HPs.Increase NPC's HPs by % of total HPs / tick.
+	if((GetHP() < GetMaxHP()) && !IsPet()) {
+		if(!IsEngaged()) {//NPC out of combat
+			if(GetNPCHPRegen() > OOCRegen)
+				SetHP(GetHP() + GetNPCHPRegen());
+			else
+				SetHP(GetHP() + OOCRegen);
+		} else
+			SetHP(GetHP()+GetNPCHPRegen());
+	} else if(GetHP() < GetMaxHP() && GetOwnerID() !=0) {
+		if(!IsEngaged()) //pet
+			SetHP(GetHP()+GetNPCHPRegen()+bonus+(GetLevel()/5));
+		else
+			SetHP(GetHP()+GetNPCHPRegen()+bonus);
+	} else
+		SetHP(GetHP()+GetNPCHPRegen());
+
+	if(GetMana() < GetMaxMana()) {
+		SetMana(GetMana()+mana_regen+bonus);
 	}
+}
 
-	AI_Process();
+void NPC::StartRefaceTimer()
+{
+	timer_wheel.Schedule(&reface_timer, 15000);
+}
 
-	return true;
+void NPC::RefaceExpired()
+{
+	if (p_depop)
+		return;
+
+	//not back at the guard spot yet, look again later
+	if (IsEngaged() || guard_x != GetX() || guard_y != GetY() || guard_z != GetZ()) {
+		timer_wheel.Schedule(&reface_timer, 15000);
+		return;
+	}
+
+	SetHeading(guard_heading);
+	SendPosition();
 }
 
 uint32 NPC::CountLoot() {
@@ -31,6 +31,7 @@ class NPC;
 #include "zonedump.h"
 #include "QGlobals.h"
 #include "../common/rulesys.h"
+#include "../common/timer_wheel.h"
 
 #ifdef _WINDOWS
 	#define M_PI	3.141592
@@ -98,6 +99,11 @@ public:
 	virtual bool IsNPC() const { return true; }
 
 	virtual bool Process();
+	//run from the zone's timer wheel instead of being polled by Process
+	void HPUpdateExpired();
+	void QGlobalPurgeExpired();
+	void RefaceExpired();
+	virtual void TicExpired();
 	virtual void	AI_Init();
 	virtual void	AI_Start(uint32 iMoveDelay = 0);
 	virtual void	AI_Stop();
@@ -322,7 +328,7 @@ public:
 	void AddSpellToNPCList(int16 iPriority, int16 iSpellID, uint16 iType, int16 iManaCost, int32 iRecastDelay, int16 iResistAdjust);
 	void AddSpellEffectToNPCList(uint16 iSpellEffectID, int32 base, int32 limit, int32 max);
 	void RemoveSpellFromNPCList(int16 spell_id);
-	Timer *GetRefaceTimer() const { return reface_timer; }
+	void StartRefaceTimer();
 
 	NPC_Emote_Struct* GetNPCEmote(uint16 emoteid, uint8 event_);
 	void DoNPCEmote(uint8 event_, uint16 emoteid);
@@ -366,12 +372,12 @@ protected:
 	Timer	classattack_timer;
 	Timer	knightattack_timer;
 	Timer	assist_timer;		//ask for help from nearby mobs
-	Timer	qglobal_purge_timer;
+	TimerWheel::Callback<NPC>	qglobal_purge_timer;
 
 	bool	combat_event;	//true if we are in combat, false otherwise
-	Timer	sendhpupdate_timer;
+	TimerWheel::Callback<NPC>	sendhpupdate_timer;
 	Timer	enraged_timer;
-	Timer *reface_timer;
+	TimerWheel::Callback<NPC>	reface_timer;
 
 	uint32	npc_spells_id;
 	uint8	casting_spell_AIindex;
@@ -404,7 +410,8 @@ protected:
 	std::deque<int> signal_q;
 
 	//waypoint crap:
-	std::vector<wplist> Waypoints;
+	std::shared_ptr<const ZoneGrid> waypoint_grid;	//the zone's copy, shared by every npc on the grid
+	const std::vector<wplist> &GetWaypoints() const;
 	void _ClearWaypints();
 	int max_wp;
 	int save_wp;
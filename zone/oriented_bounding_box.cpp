@@ -1,4 +1,5 @@
 #include "oriented_bounding_box.h"
+#include <algorithm>
 #include <gtc/matrix_transform.hpp>
 #include <gtx/transform.hpp>
 
@@ -93,3 +94,22 @@ bool OrientedBoundingBox::ContainsPoint(glm::vec3 p) const {
 	
 	return false;
 }
+
+void OrientedBoundingBox::GetBounds(glm::vec3 &min, glm::vec3 &max) const {
+	for(int i = 0; i < 8; ++i) {
+		glm::vec4 corner((i & 1) ? max_x : min_x, (i & 2) ? max_y : min_y, (i & 4) ? max_z : min_z, 1);
+		glm::vec4 world = transformation * corner;
+
+		if(i == 0) {
+			min = max = glm::vec3(world.x, world.y, world.z);
+			continue;
+		}
+
+		min.x = std::min(min.x, world.x);
+		min.y = std::min(min.y, world.y);
+		min.z = std::min(min.z, world.z);
+		max.x = std::max(max.x, world.x);
+		max.y = std::max(max.y, world.y);
+		max.z = std::max(max.z, world.z);
+	}
+}
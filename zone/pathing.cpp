@@ -11,6 +11,7 @@
 #include "doors.h"
 #include "client.h"
 #include "zone.h"
+#include "../common/rdtsc.h"
 
 #ifdef _WINDOWS
 #define snprintf _snprintf
@@ -82,16 +83,19 @@ PathManager* PathManager::LoadPathFile(const char* ZoneName)
 PathManager::PathManager()
 {
 	PathNodes = nullptr;
-	ClosedListFlag = nullptr;
 	Head.PathNodeCount = 0;
 	Head.version = 2;
 	QuickConnectTarget = -1;
+	SearchGeneration = 0;
+	NodeGridDirty = true;
+	RouteCacheHits = 0;
+	RouteCacheMisses = 0;
+	RouteCacheInvalidations = 0;
 }
 
 PathManager::~PathManager()
 {
 	safe_delete_array(PathNodes);
-	safe_delete_array(ClosedListFlag);
 }
 
 bool PathManager::loadPaths(FILE *PathFile)
@@ -122,7 +126,8 @@ bool PathManager::loadPaths(FILE *PathFile)
 
 	fread(PathNodes, sizeof(PathNode), Head.PathNodeCount, PathFile);
 
-	ClosedListFlag = new int[Head.PathNodeCount];
+	NodeGridDirty = true;
+	ClearRouteCache();
 
 #ifdef PATHDEBUG
 	PrintPathing();
@@ -205,128 +210,326 @@ Map::Vertex PathManager::GetPathNodeCoordinates(int NodeNumber, bool BestZ)
 
 }
 
-std::list<int> PathManager::FindRoute(int startID, int endID)
+void PathManager::BeginSearch()
 {
-	_log(PATHING__DEBUG, "FindRoute from node %i to %i", startID, endID);
+	if(SearchNodes.size() != Head.PathNodeCount)
+	{
+		SearchNodes.clear();
+		SearchNodes.resize(Head.PathNodeCount);
+		SearchGeneration = 0;
+	}
 
-	memset(ClosedListFlag, 0, sizeof(int) * Head.PathNodeCount);
+	// Stamps from before a wrap could match again, so they are wiped once every 4 billion searches.
+	if(++SearchGeneration == 0)
+	{
+		for(size_t i = 0; i < SearchNodes.size(); ++i)
+			SearchNodes[i].Generation = 0;
 
-	std::list<AStarNode> OpenList, ClosedList;
+		SearchGeneration = 1;
+	}
 
-	std::list<int>Route;
+	OpenHeap.clear();
+}
 
-	AStarNode AStarEntry, CurrentNode;
+void PathManager::PushOpenNode(int NodeID)
+{
+	SearchNodes[NodeID].HeapIndex = OpenHeap.size();
+	OpenHeap.push_back(NodeID);
+	SiftOpenNodeUp(OpenHeap.size() - 1);
+}
+
+int PathManager::PopOpenNode()
+{
+	int NodeID = OpenHeap[0];
 
-	AStarEntry.PathNodeID = startID;
-	AStarEntry.Parent = -1;
-	AStarEntry.HCost = 0;
-	AStarEntry.GCost = 0;
-	AStarEntry.Teleport = false;
+	OpenHeap[0] = OpenHeap.back();
+	SearchNodes[OpenHeap[0]].HeapIndex = 0;
+	OpenHeap.pop_back();
 
-	OpenList.push_back(AStarEntry);
+	if(!OpenHeap.empty())
+		SiftOpenNodeDown(0);
+
+	SearchNodes[NodeID].HeapIndex = -1;
+	SearchNodes[NodeID].Closed = true;
+
+	return NodeID;
+}
 
-	while(OpenList.size() > 0)
+void PathManager::SiftOpenNodeUp(int HeapIndex)
+{
+	int NodeID = OpenHeap[HeapIndex];
+
+	float FCost = SearchNodes[NodeID].GCost + SearchNodes[NodeID].HCost;
+
+	while(HeapIndex > 0)
 	{
-		// The OpenList is maintained in sorted order, lowest to highest cost.
+		int ParentIndex = (HeapIndex - 1) / 2;
 
-		CurrentNode = (*OpenList.begin());
+		AStarSearchNode &Parent = SearchNodes[OpenHeap[ParentIndex]];
 
-		ClosedList.push_back(CurrentNode);
+		if(Parent.GCost + Parent.HCost <= FCost)
+			break;
 
-		ClosedListFlag[CurrentNode.PathNodeID] = true;
+		OpenHeap[HeapIndex] = OpenHeap[ParentIndex];
+		Parent.HeapIndex = HeapIndex;
+		HeapIndex = ParentIndex;
+	}
 
-		OpenList.pop_front();
+	OpenHeap[HeapIndex] = NodeID;
+	SearchNodes[NodeID].HeapIndex = HeapIndex;
+}
 
-		for(int i = 0; i < PATHNODENEIGHBOURS; ++i)
-		{
-			if(PathNodes[CurrentNode.PathNodeID].Neighbours[i].id == -1)
-				break;
+void PathManager::SiftOpenNodeDown(int HeapIndex)
+{
+	int NodeID = OpenHeap[HeapIndex];
 
-			if(PathNodes[CurrentNode.PathNodeID].Neighbours[i].id == CurrentNode.Parent)
-				continue;
+	float FCost = SearchNodes[NodeID].GCost + SearchNodes[NodeID].HCost;
+
+	int HeapSize = OpenHeap.size();
+
+	while(true)
+	{
+		int ChildIndex = HeapIndex * 2 + 1;
 
-			if(PathNodes[CurrentNode.PathNodeID].Neighbours[i].id == endID)
+		if(ChildIndex >= HeapSize)
+			break;
+
+		float ChildFCost = SearchNodes[OpenHeap[ChildIndex]].GCost + SearchNodes[OpenHeap[ChildIndex]].HCost;
+
+		if(ChildIndex + 1 < HeapSize)
+		{
+			float RightFCost = SearchNodes[OpenHeap[ChildIndex + 1]].GCost + SearchNodes[OpenHeap[ChildIndex + 1]].HCost;
+
+			if(RightFCost < ChildFCost)
 			{
-				Route.push_back(CurrentNode.PathNodeID);
+				++ChildIndex;
+				ChildFCost = RightFCost;
+			}
+		}
 
-				Route.push_back(endID);
+		if(FCost <= ChildFCost)
+			break;
 
-				std::list<AStarNode>::iterator RouteIterator;
+		OpenHeap[HeapIndex] = OpenHeap[ChildIndex];
+		SearchNodes[OpenHeap[HeapIndex]].HeapIndex = HeapIndex;
+		HeapIndex = ChildIndex;
+	}
 
-				while(CurrentNode.PathNodeID != startID)
-				{
-					for(RouteIterator = ClosedList.begin(); RouteIterator != ClosedList.end(); ++RouteIterator)
-					{
-						if((*RouteIterator).PathNodeID == CurrentNode.Parent)
-						{
-							if(CurrentNode.Teleport)
-								Route.insert(Route.begin(), -1);
+	OpenHeap[HeapIndex] = NodeID;
+	SearchNodes[NodeID].HeapIndex = HeapIndex;
+}
 
-							CurrentNode = (*RouteIterator);
+std::list<int> PathManager::FindRoute(int startID, int endID)
+{
+	uint32 RouteCacheSize = RuleI(Pathing, RouteCacheSize) > 0 ? RuleI(Pathing, RouteCacheSize) : 0;
 
-							Route.insert(Route.begin(), CurrentNode.PathNodeID);
+	if(RouteCacheSize == 0)
+		return SearchRoute(startID, endID);
 
-							break;
-						}
-					}
-				}
+	uint64 Key = ((uint64)(uint32)startID << 32) | (uint64)(uint32)endID;
 
-				return Route;
-			}
-			if(ClosedListFlag[PathNodes[CurrentNode.PathNodeID].Neighbours[i].id])
-				continue;
+	std::unordered_map<uint64, std::list<PathRouteCacheEntry>::iterator>::iterator Cached = RouteCacheIndex.find(Key);
 
-			AStarEntry.PathNodeID = PathNodes[CurrentNode.PathNodeID].Neighbours[i].id;
+	if(Cached != RouteCacheIndex.end())
+	{
+		++RouteCacheHits;
 
-			AStarEntry.Parent = CurrentNode.PathNodeID;
+		RouteCache.splice(RouteCache.begin(), RouteCache, Cached->second);
 
-			AStarEntry.Teleport = PathNodes[CurrentNode.PathNodeID].Neighbours[i].Teleport;
+		return Cached->second->Route;
+	}
 
-			// HCost is the estimated cost to get from this node to the end.
-			AStarEntry.HCost = VertexDistance(PathNodes[PathNodes[CurrentNode.PathNodeID].Neighbours[i].id].v,
-											PathNodes[endID].v);
+	++RouteCacheMisses;
 
-			AStarEntry.GCost = CurrentNode.GCost + PathNodes[CurrentNode.PathNodeID].Neighbours[i].distance;
+	std::list<int> Route = SearchRoute(startID, endID);
 
-			float FCost = AStarEntry.HCost + AStarEntry.GCost;
-#ifdef PATHDEBUG
-			printf("Node: %i, Open Neighbour %i has HCost %8.3f, GCost %8.3f (Total Cost: %8.3f)\n",
-					CurrentNode.PathNodeID,
-					PathNodes[CurrentNode.PathNodeID].Neighbours[i].id,
-					AStarEntry.HCost,
-					AStarEntry.GCost,
-					AStarEntry.HCost + AStarEntry.GCost);
-#endif
+	PathRouteCacheEntry Entry;
 
-			bool AlreadyInOpenList = false;
+	Entry.Key = Key;
 
-			std::list<AStarNode>::iterator OpenListIterator, InsertionPoint = OpenList.end();
+	Entry.Route = Route;
+
+	// Remember the doors on the route so only these entries go when a door changes state.
+	int Previous = -1;
+
+	for(std::list<int>::iterator Iterator = Route.begin(); Iterator != Route.end(); ++Iterator)
+	{
+		if((*Iterator) < 0)
+			continue;
 
-			for(OpenListIterator = OpenList.begin(); OpenListIterator != OpenList.end(); ++OpenListIterator)
+		if(Previous >= 0)
+		{
+			for(int i = 0; i < PATHNODENEIGHBOURS; ++i)
 			{
-				if((*OpenListIterator).PathNodeID == PathNodes[CurrentNode.PathNodeID].Neighbours[i].id)
+				if(PathNodes[Previous].Neighbours[i].id == -1)
+					break;
+
+				if((PathNodes[Previous].Neighbours[i].id == (*Iterator)) && (PathNodes[Previous].Neighbours[i].DoorID >= 0))
 				{
-					AlreadyInOpenList = true;
+					Entry.Doors.push_back(PathNodes[Previous].Neighbours[i].DoorID);
+					break;
+				}
+			}
+		}
 
-					float GCostToNode = CurrentNode.GCost + PathNodes[CurrentNode.PathNodeID].Neighbours[i].distance;
+		Previous = (*Iterator);
+	}
 
-					if(GCostToNode < (*OpenListIterator).GCost)
-					{
-						(*OpenListIterator).Parent = CurrentNode.PathNodeID;
+	RouteCache.push_front(Entry);
 
-						(*OpenListIterator).GCost = GCostToNode;
+	RouteCacheIndex[Key] = RouteCache.begin();
 
-						(*OpenListIterator).Teleport = PathNodes[CurrentNode.PathNodeID].Neighbours[i].Teleport;
-					}
-					break;
-				}
-				else if((InsertionPoint == OpenList.end()) && (((*OpenListIterator).HCost + (*OpenListIterator).GCost) > FCost))
+	while(RouteCacheIndex.size() > RouteCacheSize)
+	{
+		RouteCacheIndex.erase(RouteCache.back().Key);
+
+		RouteCache.pop_back();
+	}
+
+	return Route;
+}
+
+void PathManager::ClearRouteCache()
+{
+	if(RouteCacheIndex.empty())
+		return;
+
+	RouteCacheInvalidations += RouteCacheIndex.size();
+
+	RouteCache.clear();
+
+	RouteCacheIndex.clear();
+}
+
+void PathManager::InvalidateDoorRoutes(int DoorID)
+{
+	std::list<PathRouteCacheEntry>::iterator Iterator = RouteCache.begin();
+
+	while(Iterator != RouteCache.end())
+	{
+		if(std::find((*Iterator).Doors.begin(), (*Iterator).Doors.end(), DoorID) != (*Iterator).Doors.end())
+		{
+			++RouteCacheInvalidations;
+
+			RouteCacheIndex.erase((*Iterator).Key);
+
+			Iterator = RouteCache.erase(Iterator);
+		}
+		else
+			++Iterator;
+	}
+}
+
+void PathManager::ShowRouteCacheStats(Client *c)
+{
+	if(!c)
+		return;
+
+	uint32 Lookups = RouteCacheHits + RouteCacheMisses;
+
+	c->Message(0, "Route cache: %u of %i routes cached, %u hits, %u misses (%.1f%% hit rate), %u invalidated.",
+		(uint32)RouteCacheIndex.size(), RuleI(Pathing, RouteCacheSize), RouteCacheHits, RouteCacheMisses,
+		Lookups > 0 ? (float)RouteCacheHits * 100.0f / Lookups : 0.0f, RouteCacheInvalidations);
+}
+
+std::list<int> PathManager::SearchRoute(int startID, int endID)
+{
+	_log(PATHING__DEBUG, "FindRoute from node %i to %i", startID, endID);
+
+	std::list<int>Route;
+
+	int NodeCount = Head.PathNodeCount;
+
+	if(!PathNodes || (startID < 0) || (startID >= NodeCount) || (endID < 0) || (endID >= NodeCount))
+	{
+		_log(PATHING__DEBUG, "FindRoute node out of range.");
+		return Route;
+	}
+
+	BeginSearch();
+
+	AStarSearchNode &StartNode = SearchNodes[startID];
+	StartNode.Generation = SearchGeneration;
+	StartNode.Parent = -1;
+	StartNode.HCost = 0;
+	StartNode.GCost = 0;
+	StartNode.Closed = false;
+	StartNode.Teleport = false;
+
+	PushOpenNode(startID);
+
+	while(!OpenHeap.empty())
+	{
+		// The OpenHeap is a binary heap on FCost, the cheapest node is always at the top.
+
+		int CurrentID = PopOpenNode();
+
+		AStarSearchNode &CurrentNode = SearchNodes[CurrentID];
+
+		for(int i = 0; i < PATHNODENEIGHBOURS; ++i)
+		{
+			NeighbourNode &Neighbour = PathNodes[CurrentID].Neighbours[i];
+
+			if(Neighbour.id == -1)
+				break;
+
+			if(Neighbour.id == CurrentNode.Parent)
+				continue;
+
+			if(Neighbour.id == endID)
+			{
+				Route.push_back(CurrentID);
+
+				Route.push_back(endID);
+
+				while(CurrentID != startID)
 				{
-					InsertionPoint = OpenListIterator;
+					if(SearchNodes[CurrentID].Teleport)
+						Route.push_front(-1);
+
+					CurrentID = SearchNodes[CurrentID].Parent;
+
+					Route.push_front(CurrentID);
 				}
+
+				return Route;
+			}
+
+			if((Neighbour.id < 0) || (Neighbour.id >= NodeCount))
+				continue;
+
+			AStarSearchNode &NeighbourState = SearchNodes[Neighbour.id];
+
+			float GCostToNode = CurrentNode.GCost + Neighbour.distance;
+
+			if(NeighbourState.Generation != SearchGeneration)
+			{
+				NeighbourState.Generation = SearchGeneration;
+				NeighbourState.Parent = CurrentID;
+				NeighbourState.Closed = false;
+				NeighbourState.Teleport = Neighbour.Teleport;
+				NeighbourState.GCost = GCostToNode;
+
+				// HCost is the estimated cost to get from this node to the end.
+				NeighbourState.HCost = VertexDistance(PathNodes[Neighbour.id].v, PathNodes[endID].v);
+#ifdef PATHDEBUG
+				printf("Node: %i, Open Neighbour %i has HCost %8.3f, GCost %8.3f (Total Cost: %8.3f)\n",
+						CurrentID,
+						Neighbour.id,
+						NeighbourState.HCost,
+						NeighbourState.GCost,
+						NeighbourState.HCost + NeighbourState.GCost);
+#endif
+				PushOpenNode(Neighbour.id);
+			}
+			else if(!NeighbourState.Closed && (GCostToNode < NeighbourState.GCost))
+			{
+				NeighbourState.Parent = CurrentID;
+				NeighbourState.Teleport = Neighbour.Teleport;
+				NeighbourState.GCost = GCostToNode;
+
+				SiftOpenNodeUp(NeighbourState.HeapIndex);
 			}
-			if(!AlreadyInOpenList)
-				OpenList.insert(InsertionPoint, AStarEntry);
 		}
 
 	}
@@ -350,41 +553,66 @@ bool SortPathNodesByDistance(PathNodeSortStruct n1, PathNodeSortStruct n2)
 	return n1.Distance < n2.Distance;
 }
 
-std::list<int> PathManager::FindRoute(Map::Vertex Start, Map::Vertex End)
+void PathManager::FindCandidateNodes(Map::Vertex Position, std::vector<PathNodeSortStruct> &Candidates)
 {
-	_log(PATHING__DEBUG, "FindRoute(%8.3f, %8.3f, %8.3f, %8.3f, %8.3f, %8.3f)", Start.x, Start.y, Start.z, End.x, End.y, End.z);
-
-	std::list<int> noderoute;
-
 	float CandidateNodeRangeXY = RuleR(Pathing, CandidateNodeRangeXY);
 
 	float CandidateNodeRangeZ = RuleR(Pathing, CandidateNodeRangeZ);
 
-	// Find the nearest PathNode the Start has LOS to.
-	//
-	//
-	int ClosestPathNodeToStart = -1;
+	Candidates.clear();
+
+	if(!PathNodes)
+		return;
 
-	std::list<PathNodeSortStruct> SortedByDistance;
+	if(NodeGridDirty)
+	{
+		NodeGrid.clear();
+
+		for(uint32 i = 0; i < Head.PathNodeCount; ++i)
+			NodeGrid.insert(i, i, PathNodes[i].v.x, PathNodes[i].v.y);
+
+		NodeGridDirty = false;
+	}
+
+	std::vector<int> InRange;
+
+	NodeGrid.query(Position.x, Position.y, CandidateNodeRangeXY, InRange);
 
 	PathNodeSortStruct TempNode;
 
-	for(uint32 i = 0 ; i < Head.PathNodeCount; ++i)
+	for(size_t i = 0; i < InRange.size(); ++i)
 	{
-		if((ABS(Start.x - PathNodes[i].v.x) <= CandidateNodeRangeXY) &&
-			(ABS(Start.y - PathNodes[i].v.y) <= CandidateNodeRangeXY) &&
-			(ABS(Start.z - PathNodes[i].v.z) <= CandidateNodeRangeZ))
-		{
-			TempNode.id = i;
-			TempNode.Distance = VertexDistanceNoRoot(Start, PathNodes[i].v);
-			SortedByDistance.push_back(TempNode);
+		int id = InRange[i];
 
+		if((ABS(Position.x - PathNodes[id].v.x) <= CandidateNodeRangeXY) &&
+			(ABS(Position.y - PathNodes[id].v.y) <= CandidateNodeRangeXY) &&
+			(ABS(Position.z - PathNodes[id].v.z) <= CandidateNodeRangeZ))
+		{
+			TempNode.id = id;
+			TempNode.Distance = VertexDistanceNoRoot(Position, PathNodes[id].v);
+			Candidates.push_back(TempNode);
 		}
 	}
 
-	SortedByDistance.sort(SortPathNodesByDistance);
+	std::sort(Candidates.begin(), Candidates.end(), SortPathNodesByDistance);
+}
+
+std::list<int> PathManager::FindRoute(Map::Vertex Start, Map::Vertex End)
+{
+	_log(PATHING__DEBUG, "FindRoute(%8.3f, %8.3f, %8.3f, %8.3f, %8.3f, %8.3f)", Start.x, Start.y, Start.z, End.x, End.y, End.z);
 
-	for(std::list<PathNodeSortStruct>::iterator Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
+	std::list<int> noderoute;
+
+	// Find the nearest PathNode the Start has LOS to.
+	//
+	//
+	int ClosestPathNodeToStart = -1;
+
+	std::vector<PathNodeSortStruct> SortedByDistance;
+
+	FindCandidateNodes(Start, SortedByDistance);
+
+	for(std::vector<PathNodeSortStruct>::iterator Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
 	{
 		_log(PATHING__DEBUG, "Checking Reachability of Node %i from Start Position.", PathNodes[(*Iterator).id].id);
 
@@ -408,21 +636,9 @@ std::list<int> PathManager::FindRoute(Map::Vertex Start, Map::Vertex End)
 
 	SortedByDistance.clear();
 
-	for(uint32 i = 0 ; i < Head.PathNodeCount; ++i)
-	{
-		if((ABS(End.x - PathNodes[i].v.x) <= CandidateNodeRangeXY) &&
-			(ABS(End.y - PathNodes[i].v.y) <= CandidateNodeRangeXY) &&
-			(ABS(End.z - PathNodes[i].v.z) <= CandidateNodeRangeZ))
-		{
-			TempNode.id = i;
-			TempNode.Distance = VertexDistanceNoRoot(End, PathNodes[i].v);
-			SortedByDistance.push_back(TempNode);
-		}
-	}
+	FindCandidateNodes(End, SortedByDistance);
 
-	SortedByDistance.sort(SortPathNodesByDistance);
-
-	for(std::list<PathNodeSortStruct>::iterator Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
+	for(std::vector<PathNodeSortStruct>::iterator Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
 	{
 		_log(PATHING__DEBUG, "Checking Reachability of Node %i from End Position.", PathNodes[(*Iterator).id].id);
 		_log(PATHING__DEBUG, " (%8.3f, %8.3f, %8.3f) to (%8.3f, %8.3f, %8.3f)",
@@ -652,6 +868,65 @@ void PathManager::SimpleMeshTest()
 	fflush(stdout);
 }
 
+void PathManager::RouteBenchmark(Client *c, int Count)
+{
+	// Replays Count random node to node searches, then nearest node lookups from the same nodes.
+
+	if(!c || !PathNodes || (Head.PathNodeCount < 2))
+		return;
+
+	if(Count < 1)
+		Count = 1000;
+
+	std::vector<int> Starts, Ends;
+
+	for(int i = 0; i < Count; ++i)
+	{
+		Starts.push_back(GetRandomPathNode());
+		Ends.push_back(GetRandomPathNode());
+	}
+
+	int Found = 0;
+
+	int RouteNodes = 0;
+
+	RDTSC_Timer RouteTimer(true);
+
+	for(int i = 0; i < Count; ++i)
+	{
+		std::list<int> Route = SearchRoute(Starts[i], Ends[i]);
+
+		if(Route.size() > 0)
+		{
+			++Found;
+			RouteNodes += Route.size();
+		}
+	}
+
+	RouteTimer.stop();
+
+	RDTSC_Timer CandidateTimer(true);
+
+	std::vector<PathNodeSortStruct> Candidates;
+
+	int CandidateCount = 0;
+
+	for(int i = 0; i < Count; ++i)
+	{
+		FindCandidateNodes(PathNodes[Starts[i]].v, Candidates);
+		CandidateCount += Candidates.size();
+	}
+
+	CandidateTimer.stop();
+
+	c->Message(0, "Route benchmark: %i searches over %u nodes in %.3f ms (%.3f us per search), %i found, average length %.1f.",
+		Count, Head.PathNodeCount, RouteTimer.getDuration(), RouteTimer.getDuration() * 1000.0 / Count,
+		Found, Found > 0 ? (float)RouteNodes / Found : 0.0f);
+	c->Message(0, "Candidate node lookups: %i in %.3f ms (%.3f us per lookup), average %.1f candidates.",
+		Count, CandidateTimer.getDuration(), CandidateTimer.getDuration() * 1000.0 / Count,
+		(float)CandidateCount / Count);
+}
+
 Map::Vertex Mob::UpdatePath(float ToX, float ToY, float ToZ, float Speed, bool &WaypointChanged, bool &NodeReached)
 {
 	WaypointChanged = false;
@@ -1097,32 +1372,13 @@ int PathManager::FindNearestPathNode(Map::Vertex Position)
 	//
 	//
 
-	float CandidateNodeRangeXY = RuleR(Pathing, CandidateNodeRangeXY);
-
-	float CandidateNodeRangeZ = RuleR(Pathing, CandidateNodeRangeZ);
-
 	int ClosestPathNodeToStart = -1;
 
-	std::list<PathNodeSortStruct> SortedByDistance;
+	std::vector<PathNodeSortStruct> SortedByDistance;
 
-	PathNodeSortStruct TempNode;
-
-	for(uint32 i = 0 ; i < Head.PathNodeCount; ++i)
-	{
-		if((ABS(Position.x - PathNodes[i].v.x) <= CandidateNodeRangeXY) &&
-			(ABS(Position.y - PathNodes[i].v.y) <= CandidateNodeRangeXY) &&
-			(ABS(Position.z - PathNodes[i].v.z) <= CandidateNodeRangeZ))
-		{
-			TempNode.id = i;
-			TempNode.Distance = VertexDistanceNoRoot(Position, PathNodes[i].v);
-			SortedByDistance.push_back(TempNode);
-
-		}
-	}
+	FindCandidateNodes(Position, SortedByDistance);
 
-	SortedByDistance.sort(SortPathNodesByDistance);
-
-	for(std::list<PathNodeSortStruct>::iterator Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
+	for(std::vector<PathNodeSortStruct>::iterator Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
 	{
 		_log(PATHING__DEBUG, "Checking Reachability of Node %i from Start Position.", PathNodes[(*Iterator).id].id);
 
@@ -1548,8 +1804,8 @@ int32 PathManager::AddNode(float x, float y, float z, float best_z, int32 reques
 		npc->GiveNPCTypeData(npc_type);
 		entity_list.AddNPC(npc, true, true);
 
-		safe_delete_array(ClosedListFlag);
-		ClosedListFlag = new int[Head.PathNodeCount];
+		NodeGridDirty = true;
+		ClearRouteCache();
 		return new_id;
 	}
 	else
@@ -1608,7 +1864,8 @@ int32 PathManager::AddNode(float x, float y, float z, float best_z, int32 reques
 		npc->GiveNPCTypeData(npc_type);
 		entity_list.AddNPC(npc, true, true);
 
-		ClosedListFlag = new int[Head.PathNodeCount];
+		NodeGridDirty = true;
+		ClearRouteCache();
 
 		return new_id;
 	}
@@ -1684,14 +1941,14 @@ bool PathManager::DeleteNode(int32 id)
 				}
 			}
 		}
-		safe_delete_array(ClosedListFlag);
-		ClosedListFlag = new int[Head.PathNodeCount];
 	}
 	else
 	{
 		delete[] PathNodes;
 		PathNodes = nullptr;
 	}
+	NodeGridDirty = true;
+	ClearRouteCache();
 	return true;
 }
 
@@ -1724,6 +1981,8 @@ void PathManager::ConnectNodeToNode(Client *c, int32 Node2, int32 teleport, int3
 
 void PathManager::ConnectNodeToNode(int32 Node1, int32 Node2, int32 teleport, int32 doorid)
 {
+	ClearRouteCache();
+
 	PathNode *a = nullptr;
 	PathNode *b = nullptr;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
@@ -1814,6 +2073,8 @@ void PathManager::ConnectNode(Client *c, int32 Node2, int32 teleport, int32 door
 
 void PathManager::ConnectNode(int32 Node1, int32 Node2, int32 teleport, int32 doorid)
 {
+	ClearRouteCache();
+
 	PathNode *a = nullptr;
 	PathNode *b = nullptr;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
@@ -1879,6 +2140,8 @@ void PathManager::DisconnectNodeToNode(Client *c, int32 Node2)
 
 void PathManager::DisconnectNodeToNode(int32 Node1, int32 Node2)
 {
+	ClearRouteCache();
+
 	PathNode *a = nullptr;
 	PathNode *b = nullptr;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
@@ -1961,6 +2224,8 @@ void PathManager::MoveNode(Client *c)
 	Node->v.x = c->GetX();
 	Node->v.y = c->GetY();
 	Node->v.z = c->GetZ();
+	NodeGridDirty = true;
+	ClearRouteCache();
 
 	if(zone->zonemap)
 	{
@@ -1992,6 +2257,8 @@ void PathManager::DisconnectAll(Client *c)
 		return;
 	}
 
+	ClearRouteCache();
+
 	for(int x = 0; x < PATHNODENEIGHBOURS; ++x)
 	{
 		Node->Neighbours[x].distance = 0;
@@ -2104,6 +2371,8 @@ void PathManager::ProcessNodesAndSave(std::string filename)
 
 void PathManager::ResortConnections()
 {
+	ClearRouteCache();
+
 	NeighbourNode Neigh[PATHNODENEIGHBOURS];
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
 	{
@@ -2187,6 +2456,8 @@ struct InternalPathSort
 
 void PathManager::SortNodes()
 {
+	ClearRouteCache();
+
 	std::vector<InternalPathSort> sorted_vals;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
 	{
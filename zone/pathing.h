@@ -3,8 +3,10 @@
 #include <algorithm>
 #include "map.h"
 #include "../common/timer.h"
+#include "../common/spatial_grid.h"
 #include <list>
 #include <vector>
+#include <unordered_map>
 #include <algorithm>
 
 class Client;
@@ -43,6 +45,27 @@ struct PathFileHeader {
 
 #pragma pack()
 
+// Per node A* state. It is kept between searches and only considered valid when
+// Generation matches the current search, so nothing has to be cleared per search.
+struct AStarSearchNode
+{
+	uint32 Generation;
+	int Parent;
+	float HCost;
+	float GCost;
+	int HeapIndex;
+	bool Closed;
+	bool Teleport;
+};
+
+// A node to node route remembered by FindRoute, along with the doors it passes through.
+struct PathRouteCacheEntry
+{
+	uint64 Key;
+	std::list<int> Route;
+	std::vector<int> Doors;
+};
+
 struct PathNodeSortStruct
 {
 	int id;
@@ -69,6 +92,10 @@ public:
 	void SpawnPathNodes();
 	void MeshTest();
 	void SimpleMeshTest();
+	void RouteBenchmark(Client *c, int Count);
+	void ClearRouteCache();
+	void InvalidateDoorRoutes(int DoorID);
+	void ShowRouteCacheStats(Client *c);
 	int FindNearestPathNode(Map::Vertex Position);
 	bool NoHazards(Map::Vertex From, Map::Vertex To);
 	bool NoHazardsAccurate(Map::Vertex From, Map::Vertex To);
@@ -102,7 +129,28 @@ private:
 	PathNode *PathNodes;
 	int QuickConnectTarget;
 
-	int *ClosedListFlag;
+	std::list<int> SearchRoute(int startID, int endID);
+	void BeginSearch();
+	void PushOpenNode(int NodeID);
+	int PopOpenNode();
+	void SiftOpenNodeUp(int HeapIndex);
+	void SiftOpenNodeDown(int HeapIndex);
+	void FindCandidateNodes(Map::Vertex Position, std::vector<PathNodeSortStruct> &Candidates);
+
+	std::vector<AStarSearchNode> SearchNodes;
+	std::vector<int> OpenHeap;
+	uint32 SearchGeneration;
+
+	// Nodes by x/y position, rebuilt on the next lookup after the node set changes.
+	EQEmu::SpatialGrid<int> NodeGrid;
+	bool NodeGridDirty;
+
+	// Most recently used route at the front.
+	std::list<PathRouteCacheEntry> RouteCache;
+	std::unordered_map<uint64, std::list<PathRouteCacheEntry>::iterator> RouteCacheIndex;
+	uint32 RouteCacheHits;
+	uint32 RouteCacheMisses;
+	uint32 RouteCacheInvalidations;
 };
 
 
@@ -6576,7 +6576,7 @@ XS(XS_Mob_GetHateList)
 		if(THIS == nullptr)
 			Perl_croak(aTHX_ "THIS is nullptr, avoiding crash.");
 
-		auto hate_list = THIS->GetHateList();
+		auto &hate_list = THIS->GetHateList();
 		auto iter = hate_list.begin();
 
 		while(iter != hate_list.end())
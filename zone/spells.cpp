@@ -96,6 +96,7 @@ Copyright (C) 2001-2002 EQEMu Development Team (http://eqemu.org)
 extern Zone* zone;
 extern volatile bool ZoneLoaded;
 extern WorldServer worldserver;
+extern TimerWheel timer_wheel;
 
 // this is run constantly for every mob
 void Mob::SpellProcess()
@@ -957,7 +958,7 @@ void Mob::CastedSpellFinished(uint16 spell_id, uint32 target_id, uint16 slot,
 					bardsong_target_id = GetID();
 				else
 					bardsong_target_id = spell_target->GetID();
-				bardsong_timer.Start(6000);
+				timer_wheel.Schedule(&bardsong_timer, 6000);
 				mlog(SPELLS__BARDS, "Bard song %d started: slot %d, target id %d", bardsong, bardsong_slot, bardsong_target_id);
 				bard_song_mode = true;
 			}
@@ -4509,17 +4510,22 @@ void Mob::Stun(int duration)
 	if(duration > 0)
 	{
 		stunned = true;
-		stunned_timer.Start(duration);
+		timer_wheel.Schedule(&stunned_timer, duration);
 	}
 }
 
 void Mob::UnStun() {
-	if(stunned && stunned_timer.Enabled()) {
+	if(stunned && stunned_timer.Scheduled()) {
 		stunned = false;
-		stunned_timer.Disable();
+		timer_wheel.Cancel(&stunned_timer);
 	}
 }
 
+void Mob::StunExpired() {
+	stunned = false;
+	spun_timer.Disable();
+}
+
 // Stuns "this"
 void Client::Stun(int duration)
 {
@@ -5027,7 +5033,7 @@ void Mob::_StopSong()
 	bardsong = 0;
 	bardsong_target_id = 0;
 	bardsong_slot = 0;
-	bardsong_timer.Disable();
+	timer_wheel.Cancel(&bardsong_timer);
 }
 
 //This member function sets the buff duration on the client
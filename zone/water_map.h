@@ -21,7 +21,7 @@ class WaterMap
 {
 public:
 	WaterMap() { }
-	~WaterMap() { }
+	virtual ~WaterMap() { }
 	
 	static WaterMap* LoadWaterMapfile(std::string zone_name);
 	virtual WaterRegionType ReturnRegionType(float y, float x, float z) const { return RegionTypeNormal; }
@@ -1,4 +1,7 @@
 #include "water_map_v2.h"
+#include <algorithm>
+
+#define WATER_MAP_LEAF_REGIONS 4
 
 WaterMapV2::WaterMapV2() {
 }
@@ -7,14 +10,47 @@ WaterMapV2::~WaterMapV2() {
 }
 
 WaterRegionType WaterMapV2::ReturnRegionType(float y, float x, float z) const {
-	size_t sz = regions.size();
-	for(size_t i = 0; i < sz; ++i) {
-		auto const &region = regions[i];
-		if (region.second.ContainsPoint(glm::vec3(x, y, z))) {
-			return region.first;
+	if(nodes.empty()) {
+		return RegionTypeNormal;
+	}
+
+	glm::vec3 p(x, y, z);
+	uint32 best = (uint32)regions.size();
+	//the tree is split at the median so it is never deeper than log2 of the region count
+	uint32 stack[64];
+	uint32 top = 0;
+	stack[top++] = 0;
+	while(top > 0) {
+		const RegionNode &node = nodes[stack[--top]];
+		if(node.first_region >= best ||
+			p.x < node.min[0] || p.x > node.max[0] ||
+			p.y < node.min[1] || p.y > node.max[1] ||
+			p.z < node.min[2] || p.z > node.max[2]) {
+			continue;
+		}
+
+		if(node.count > 0) {
+			for(uint32 i = node.first; i < node.first + node.count; ++i) {
+				uint32 r = region_order[i];
+				if(r < best && regions[r].second.ContainsPoint(p)) {
+					best = r;
+				}
+			}
+			continue;
+		}
+
+		//visit the child holding the earlier regions first, it is the likelier to end the search
+		uint32 early = node.first;
+		uint32 late = node.first + 1;
+		if(nodes[late].first_region < nodes[early].first_region) {
+			std::swap(early, late);
 		}
+
+		stack[top++] = late;
+		stack[top++] = early;
 	}
-	return RegionTypeNormal;
+
+	return best < regions.size() ? regions[best].first : RegionTypeNormal;
 }
 
 bool WaterMapV2::InWater(float y, float x, float z) const {
@@ -30,7 +66,8 @@ bool WaterMapV2::InLava(float y, float x, float z) const {
 }
 
 bool WaterMapV2::InLiquid(float y, float x, float z) const {
-	return InWater(y, x, z) || InLava(y, x, z);
+	WaterRegionType type = ReturnRegionType(y, x, z);
+	return type == RegionTypeWater || type == RegionTypeLava;
 }
 
 bool WaterMapV2::Load(FILE *fp) {
@@ -110,5 +147,85 @@ bool WaterMapV2::Load(FILE *fp) {
 			OrientedBoundingBox(glm::vec3(x, y, z), glm::vec3(x_rot, y_rot, z_rot), glm::vec3(x_scale, y_scale, z_scale), glm::vec3(x_extent, y_extent, z_extent))));
 	}
 
+	BuildTree();
 	return true;
 }
+
+void WaterMapV2::BuildTree() {
+	nodes.clear();
+	region_order.clear();
+	if(regions.empty()) {
+		return;
+	}
+
+	std::vector<glm::vec3> mins(regions.size());
+	std::vector<glm::vec3> maxs(regions.size());
+	std::vector<uint32> items(regions.size());
+	for(size_t i = 0; i < regions.size(); ++i) {
+		regions[i].second.GetBounds(mins[i], maxs[i]);
+		items[i] = (uint32)i;
+	}
+
+	nodes.reserve(regions.size() * 2 / WATER_MAP_LEAF_REGIONS + 1);
+	region_order.reserve(regions.size());
+	nodes.push_back(RegionNode());
+	BuildNode(0, items, 0, items.size(), mins, maxs);
+}
+
+//fills in nodes[index] for items[begin, end)
+void WaterMapV2::BuildNode(uint32 index, std::vector<uint32> &items, size_t begin, size_t end, const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs) {
+	glm::vec3 bmin = mins[items[begin]];
+	glm::vec3 bmax = maxs[items[begin]];
+	glm::vec3 cmin = (mins[items[begin]] + maxs[items[begin]]) * 0.5f;
+	glm::vec3 cmax = cmin;
+	uint32 first_region = items[begin];
+	for(size_t i = begin + 1; i < end; ++i) {
+		uint32 r = items[i];
+		bmin = glm::min(bmin, mins[r]);
+		bmax = glm::max(bmax, maxs[r]);
+		glm::vec3 c = (mins[r] + maxs[r]) * 0.5f;
+		cmin = glm::min(cmin, c);
+		cmax = glm::max(cmax, c);
+		first_region = std::min(first_region, r);
+	}
+
+	RegionNode node;
+	node.min[0] = bmin.x;
+	node.min[1] = bmin.y;
+	node.min[2] = bmin.z;
+	node.max[0] = bmax.x;
+	node.max[1] = bmax.y;
+	node.max[2] = bmax.z;
+	node.first_region = first_region;
+
+	glm::vec3 extent = cmax - cmin;
+	int axis = 0;
+	if(extent.y > extent.x) {
+		axis = 1;
+	}
+	if(extent.z > extent[axis]) {
+		axis = 2;
+	}
+
+	//all the centers on top of each other can't be split any further either
+	if(end - begin <= WATER_MAP_LEAF_REGIONS || !(extent[axis] > 0.0f)) {
+		node.first = (uint32)region_order.size();
+		node.count = (uint32)(end - begin);
+		region_order.insert(region_order.end(), items.begin() + begin, items.begin() + end);
+		nodes[index] = node;
+		return;
+	}
+
+	size_t mid = begin + (end - begin) / 2;
+	std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+		[&](uint32 a, uint32 b) { return mins[a][axis] + maxs[a][axis] < mins[b][axis] + maxs[b][axis]; });
+
+	node.first = (uint32)nodes.size();
+	node.count = 0;
+	nodes[index] = node;
+
+	nodes.push_back(RegionNode());
+	nodes.push_back(RegionNode());
+	BuildNode(node.first, items, begin, mid, mins, maxs);
+	BuildNode(node.first + 1, items, mid, end, mins, maxs);
+}
@@ -21,7 +21,24 @@ public:
 protected:
 	virtual bool Load(FILE *fp);
 
+	//bounding volume hierarchy over the regions' world space boxes. Leaves hold a run of
+	//region_order, interior nodes (count == 0) have their children at first and first + 1.
+	//first_region is the lowest region index under the node, the earliest region in the
+	//file containing the point wins so subtrees that can't beat the current match are skipped.
+	struct RegionNode {
+		float min[3];
+		float max[3];
+		uint32 first;
+		uint32 count;
+		uint32 first_region;
+	};
+
+	void BuildTree();
+	void BuildNode(uint32 index, std::vector<uint32> &items, size_t begin, size_t end, const std::vector<glm::vec3> &mins, const std::vector<glm::vec3> &maxs);
+
 	std::vector<std::pair<WaterRegionType, OrientedBoundingBox>> regions;
+	std::vector<RegionNode> nodes;
+	std::vector<uint32> region_order;
 	friend class WaterMap;
 };
 
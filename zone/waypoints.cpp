@@ -71,9 +71,10 @@ void NPC::DisplayWaypointInfo(Client *c) {
 		GetMaxWp() );
 
 
-	std::vector<wplist>::iterator cur, end;
-	cur = Waypoints.begin();
-	end = Waypoints.end();
+	const std::vector<wplist> &waypoints = GetWaypoints();
+	std::vector<wplist>::const_iterator cur, end;
+	cur = waypoints.begin();
+	end = waypoints.end();
 	for(; cur != end; ++cur) {
 		c->Message(0,"Waypoint %d: (%.2f,%.2f,%.2f,%.2f) pause %d",
 				cur->index,
@@ -213,12 +214,13 @@ void NPC::MoveTo(float mtx, float mty, float mtz, float mth, bool saveguardspot)
 
 void NPC::UpdateWaypoint(int wp_index)
 {
-	if(wp_index >= static_cast<int>(Waypoints.size())) {
+	const std::vector<wplist> &waypoints = GetWaypoints();
+	if(wp_index < 0 || wp_index >= static_cast<int>(waypoints.size())) {
 		mlog(AI__WAYPOINTS, "Update to waypoint %d failed. Not found.", wp_index);
 		return;
 	}
-	std::vector<wplist>::iterator cur;
-	cur = Waypoints.begin();
+	std::vector<wplist>::const_iterator cur;
+	cur = waypoints.begin();
 	cur += wp_index;
 
 	cur_wp_x = cur->x;
@@ -282,10 +284,10 @@ void NPC::CalculateNewWaypoint()
 	}
 	case 2: //random
 	{
-		cur_wp = MakeRandomInt(0, Waypoints.size() - 1);
+		cur_wp = MakeRandomInt(0, GetWaypoints().size() - 1);
 		if(cur_wp == old_wp)
 		{
-			if(cur_wp == (Waypoints.size() - 1))
+			if(cur_wp == (GetWaypoints().size() - 1))
 			{
 				if(cur_wp > 0)
 				{
@@ -294,7 +296,7 @@ void NPC::CalculateNewWaypoint()
 			}
 			else if(cur_wp == 0)
 			{
-				if((Waypoints.size() - 1) > 0)
+				if((GetWaypoints().size() - 1) > 0)
 				{
 					cur_wp++;
 				}
@@ -369,23 +371,24 @@ bool wp_distance_pred(const wp_distance& left, const wp_distance& right)
 void NPC::GetClosestWaypoint(std::list<wplist> &wp_list, int count, float m_x, float m_y, float m_z)
 {
 	wp_list.clear();
-	if(Waypoints.size() <= count)
+	const std::vector<wplist> &waypoints = GetWaypoints();
+	if(waypoints.size() <= count)
 	{
-		for(int i = 0; i < Waypoints.size(); ++i)
+		for(int i = 0; i < waypoints.size(); ++i)
 		{
-			wp_list.push_back(Waypoints[i]);
+			wp_list.push_back(waypoints[i]);
 		}
 		return;
 	}
 
 	std::list<wp_distance> distances;
-	for(int i = 0; i < Waypoints.size(); ++i)
+	for(int i = 0; i < waypoints.size(); ++i)
 	{
-		float cur_x = (Waypoints[i].x - m_x);
+		float cur_x = (waypoints[i].x - m_x);
 		cur_x *= cur_x;
-		float cur_y = (Waypoints[i].y - m_y);
+		float cur_y = (waypoints[i].y - m_y);
 		cur_y *= cur_y;
-		float cur_z = (Waypoints[i].z - m_z);
+		float cur_z = (waypoints[i].z - m_z);
 		cur_z *= cur_z;
 		float cur_dist = cur_x + cur_y + cur_z;
 		wp_distance w_dist;
@@ -398,7 +401,7 @@ void NPC::GetClosestWaypoint(std::list<wplist> &wp_list, int count, float m_x, f
 	std::list<wp_distance>::iterator iter = distances.begin();
 	for(int i = 0; i < count; ++i)
 	{
-		wp_list.push_back(Waypoints[(*iter).index]);
+		wp_list.push_back(waypoints[(*iter).index]);
 		++iter;
 	}
 }
@@ -859,6 +862,13 @@ bool Mob::CalculateNewPosition(float x, float y, float z, float speed, bool chec
 	return true;
 }
 
+const std::vector<wplist> &NPC::GetWaypoints() const {
+	static const std::vector<wplist> none;
+	if(!waypoint_grid)
+		return(none);
+	return(waypoint_grid->waypoints);
+}
+
 void NPC::AssignWaypoints(int32 grid) {
 	if(grid == 0)
 		return;		//grid ID 0 not supported
@@ -869,96 +879,29 @@ void NPC::AssignWaypoints(int32 grid) {
 		return;
 	}
 
-	char errbuf[MYSQL_ERRMSG_SIZE];
-	char *query = 0;
-	MYSQL_RES *result;
-	MYSQL_ROW row;
-
-	bool GridErr = false, WPErr = false;
-	Waypoints.clear();
+	waypoint_grid.reset();
 
-	// Retrieve the wander and pause types for this grid
-	if(database.RunQuery(query,MakeAnyLenString(&query,"SELECT `type`,`type2` FROM `grid` WHERE `id`=%i AND `zoneid`=%i",grid,zone->GetZoneID()),errbuf, &result))
-	{
-		if((row = mysql_fetch_row(result)))
-		{
-			if(row[0] != 0)
-				wandertype = atoi(row[0]);
-			else
-				wandertype = 0;
-			if(row[1] != 0)
-				pausetype = atoi(row[1]);
-			else
-				pausetype = 0;
-		}
-		else	// No grid record found in this zone for the given ID
-		GridErr = true;
-		mysql_free_result(result);
-	}
-	else	// DB query error!
-	{
-		GridErr = true;
-		LogFile->write(EQEMuLog::Error, "MySQL Error while trying to assign grid %u to mob %s: %s", grid, name, errbuf);
+	// The zone loads its grids once at boot and every npc on a grid shares the zone's copy
+	std::shared_ptr<const ZoneGrid> zg = zone->GetGrid(grid);
+	if(!zg) {	// No grid record found in this zone for the given ID
+		roamer = false;
+		return;
 	}
-	safe_delete_array(query);
-
-	if(!GridErr)
-	{
-		this->CastToNPC()->SetGrid(grid);	// Assign grid number
-
-		// Retrieve all waypoints for this grid
-		if(database.RunQuery(query,MakeAnyLenString(&query,"SELECT `x`,`y`,`z`,`pause`,`heading` FROM grid_entries WHERE `gridid`=%i AND `zoneid`=%i ORDER BY `number`",grid,zone->GetZoneID()),errbuf,&result))
-		{
-			roamer = true;
-			max_wp = -1;	// Initialize it; will increment it for each waypoint successfully added to the list
 
-			while((row = mysql_fetch_row(result)))
-			{
-				if(row[0] != 0 && row[1] != 0 && row[2] != 0 && row[3] != 0)
-				{
-					wplist newwp;
-					newwp.index = ++max_wp;
-					newwp.x = atof(row[0]);
-					newwp.y = atof(row[1]);
-					newwp.z = atof(row[2]);
-
-					if(zone->HasMap() && RuleB(Map, FixPathingZWhenLoading) )
-					{
-						if(!RuleB(Watermap, CheckWaypointsInWaterWhenLoading) || !zone->HasWaterMap() ||
-						(zone->HasWaterMap() && !zone->watermap->InWater(newwp.x, newwp.y, newwp.z)))
-						{
-							Map::Vertex dest(newwp.x, newwp.y, newwp.z);
+	wandertype = zg->wandertype;
+	pausetype = zg->pausetype;
+	this->CastToNPC()->SetGrid(grid);	// Assign grid number
+	waypoint_grid = zg;
+	max_wp = static_cast<int>(zg->waypoints.size()) - 1;
 
-							float newz = zone->zonemap->FindBestZ(dest, nullptr);
-
-							if( (newz > -2000) && ABS(newz-dest.z) < RuleR(Map, FixPathingZMaxDeltaLoading))
-								newwp.z = newz + 1;
-						}
-					}
-
-					newwp.pause = atoi(row[3]);
-					newwp.heading = atof(row[4]);
-					Waypoints.push_back(newwp);
-				}
-			}
-			mysql_free_result(result);
-		}
-		else	// DB query error!
-		{
-			WPErr = true;
-			LogFile->write(EQEMuLog::Error, "MySQL Error while trying to assign waypoints from grid %u to mob %s: %s", grid, name, errbuf);
-		}
-		safe_delete_array(query);
-	} // end if (!GridErr)
-	if(Waypoints.size() < 2) {
+	if(zg->waypoints.size() < 2) {
 		roamer = false;
-	} else if(!GridErr && !WPErr) {
+	} else {
+		roamer = true;
 		UpdateWaypoint(0);
 		SetWaypointPause();
 		if (wandertype == 1 || wandertype == 2 || wandertype == 5)
 			CalculateNewWaypoint();
-	} else {
-		roamer = false;
 	}
 }
 
@@ -1097,6 +1040,71 @@ bool ZoneDatabase::GetWaypoints(uint32 grid, uint16 zoneid, uint32 num, wplist*
 	return false;
 }
 
+bool ZoneDatabase::LoadGrids(uint32 zoneid, std::unordered_map<uint32, std::shared_ptr<ZoneGrid> > &grids, uint32 grid_id) {
+	char *query = 0;
+	char errbuf[MYSQL_ERRMSG_SIZE];
+	MYSQL_RES *result;
+	MYSQL_ROW row;
+	std::string grid_filter;
+	if(grid_id != 0)
+		StringFormat(grid_filter, " AND `id`=%u", grid_id);
+
+	if(!RunQuery(query, MakeAnyLenString(&query, "SELECT `id`,`type`,`type2` FROM `grid` WHERE `zoneid`=%u%s", zoneid, grid_filter.c_str()), errbuf, &result)) {
+		LogFile->write(EQEMuLog::Error, "Error in LoadGrids query '%s': %s", query, errbuf);
+		safe_delete_array(query);
+		return false;
+	}
+	safe_delete_array(query);
+
+	while((row = mysql_fetch_row(result))) {
+		std::shared_ptr<ZoneGrid> grid(new ZoneGrid);
+		grid->wandertype = row[1] ? atoi(row[1]) : 0;
+		grid->pausetype = row[2] ? atoi(row[2]) : 0;
+		grids[atoi(row[0])] = grid;
+	}
+	mysql_free_result(result);
+
+	if(grid_id != 0)
+		StringFormat(grid_filter, " AND `gridid`=%u", grid_id);
+
+	// one pass over every entry in the zone, ordered so each grid's waypoints arrive in sequence
+	if(!RunQuery(query, MakeAnyLenString(&query, "SELECT `gridid`,`x`,`y`,`z`,`pause`,`heading` FROM `grid_entries` WHERE `zoneid`=%u%s ORDER BY `gridid`,`number`",
+		zoneid, grid_filter.c_str()), errbuf, &result)) {
+		LogFile->write(EQEMuLog::Error, "Error in LoadGrids query '%s': %s", query, errbuf);
+		safe_delete_array(query);
+		return false;
+	}
+	safe_delete_array(query);
+
+	uint32 last_id = 0;
+	ZoneGrid *grid = nullptr;
+	while((row = mysql_fetch_row(result))) {
+		if(row[1] == 0 || row[2] == 0 || row[3] == 0 || row[4] == 0)
+			continue;
+
+		uint32 id = atoi(row[0]);
+		if(grid == nullptr || id != last_id) {
+			last_id = id;
+			std::unordered_map<uint32, std::shared_ptr<ZoneGrid> >::iterator iter = grids.find(id);
+			grid = (iter != grids.end()) ? iter->second.get() : nullptr;
+		}
+		if(grid == nullptr)	// entries without a grid row were never used
+			continue;
+
+		wplist wp;
+		wp.index = grid->waypoints.size();
+		wp.x = atof(row[1]);
+		wp.y = atof(row[2]);
+		wp.z = atof(row[3]);
+		wp.pause = atoi(row[4]);
+		wp.heading = atof(row[5]);
+		grid->waypoints.push_back(wp);
+	}
+	mysql_free_result(result);
+
+	return true;
+}
+
 void ZoneDatabase::AssignGrid(Client *client, float x, float y, uint32 grid)
 {
 	char *query = 0;
@@ -1240,6 +1248,9 @@ void ZoneDatabase::ModifyGrid(Client *c, bool remove, uint32 id, uint8 type, uin
 		}
 		safe_delete_array(query);
 	}
+
+	if(zone && zone->GetZoneID() == zoneid)
+		zone->ReloadGrid(id);
 } /*** END ZoneDatabase::ModifyGrid() ***/
 
 /**************************************
@@ -1257,6 +1268,9 @@ void ZoneDatabase::AddWP(Client *c, uint32 gridid, uint32 wpnum, float xpos, flo
 		if(c) c->LogSQL(query);
 	}
 	safe_delete_array(query);
+
+	if(zone && zone->GetZoneID() == zoneid)
+		zone->ReloadGrid(gridid);
 } /*** END ZoneDatabase::AddWP() ***/
 
 
@@ -1282,6 +1296,9 @@ void ZoneDatabase::DeleteWaypoint(Client *c, uint32 grid_num, uint32 wp_num, uin
 		if(c) c->LogSQL(query);
 	}
 	safe_delete_array(query);
+
+	if(zone && zone->GetZoneID() == zoneid)
+		zone->ReloadGrid(grid_num);
 } /*** END ZoneDatabase::DeleteWaypoint() ***/
 
 
@@ -1372,6 +1389,9 @@ uint32 ZoneDatabase::AddWPForSpawn(Client *c, uint32 spawn2id, float xpos, float
 	}
 	safe_delete_array(query);
 
+	if(zone && zone->GetZoneID() == zoneid)
+		zone->ReloadGrid(grid_num);
+
 	if(CreatedNewGrid)
 		return grid_num;
 
@@ -409,6 +409,14 @@ void WorldServer::Process() {
 			if (zst->adminname[0] != 0)
 				std::cout << "Zone bootup by " << zst->adminname << std::endl;
 
+			//a warm process becomes the static zone it was attached to, so it is known
+			//by that name if we reconnect to world
+			if (zst->makestatic && strncmp(GetLaunchedName(), "warm_", 5) == 0) {
+				const char *zn = database.GetZoneName(zst->zoneid);
+				if (zn)
+					SetLaunchedName(zn);
+			}
+
 			if (!(Zone::Bootup(zst->zoneid, zst->instanceid, zst->makestatic))) {
 				SendChannelMessage(0, 0, 10, 0, 0, "%s:%i Zone::Bootup failed: %s", net.GetZoneAddress(), net.GetZonePort(), database.GetZoneName(zst->zoneid));
 			}
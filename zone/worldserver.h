@@ -46,6 +46,7 @@ public:
 	uint32 NextGroupID();
 
 	void SetLaunchedName(const char *n) { m_launchedName = n; }
+	const char *GetLaunchedName() const { return(m_launchedName.c_str()); }
 	void SetLauncherName(const char *n) { m_launcherName = n; }
 
 private:
@@ -58,6 +58,7 @@
 #include "../common/rulesys.h"
 #include "guild_mgr.h"
 #include "QuestParserCollection.h"
+#include "zone_boot.h"
 
 #ifdef _WINDOWS
 #define snprintf	_snprintf
@@ -103,9 +104,6 @@ bool Zone::Bootup(uint32 iZoneID, uint32 iInstanceID, bool iStaticZone) {
 		worldserver.SetZone(0);
 		return false;
 	}
-	zone->zonemap = Map::LoadMapFile(zone->map_name);
-	zone->watermap = WaterMap::LoadWaterMapfile(zone->map_name);
-	zone->pathing = PathManager::LoadPathFile(zone->map_name);
 
 	char tmp[10];
 	if (database.GetVariable("loglevel",tmp, 9)) {
@@ -698,6 +696,7 @@ Zone::Zone(uint32 in_zoneid, uint32 in_instanceid, const char* in_short_name)
 	zoneid = in_zoneid;
 	instanceid = in_instanceid;
 	instanceversion = database.GetInstanceVersion(instanceid);
+	all_npc_types_stale = false;
 	zonemap = nullptr;
 	watermap = nullptr;
 	pathing = nullptr;
@@ -820,38 +819,111 @@ Zone::~Zone() {
 }
 
 //Modified for timezones.
+//the boot jobs Zone::Init runs beside the rest of the boot. File loads hand their result
+//back to be set on the zone after the join, DB loads fill lists nothing else touches
+//until the boot is done.
+class MapLoadJob : public ZoneBootJob {
+public:
+	MapLoadJob(const char *map_name) : ZoneBootJob("map", false), map_name(map_name), map(nullptr) { }
+	virtual bool Run(ZoneDatabase *db) { map = Map::LoadMapFile(map_name); return(true); }
+	~MapLoadJob() { safe_delete(map); }
+	std::string map_name;
+	Map *map;
+};
+
+class WaterMapLoadJob : public ZoneBootJob {
+public:
+	WaterMapLoadJob(const char *map_name) : ZoneBootJob("water map", false), map_name(map_name), watermap(nullptr) { }
+	virtual bool Run(ZoneDatabase *db) { watermap = WaterMap::LoadWaterMapfile(map_name); return(true); }
+	~WaterMapLoadJob() { safe_delete(watermap); }
+	std::string map_name;
+	WaterMap *watermap;
+};
+
+class PathLoadJob : public ZoneBootJob {
+public:
+	PathLoadJob(const char *map_name) : ZoneBootJob("path file", false), map_name(map_name), pathing(nullptr) { }
+	virtual bool Run(ZoneDatabase *db) { pathing = PathManager::LoadPathFile(map_name.c_str()); return(true); }
+	~PathLoadJob() { safe_delete(pathing); }
+	std::string map_name;
+	PathManager *pathing;
+};
+
+class ZonePointsLoadJob : public ZoneBootJob {
+public:
+	ZonePointsLoadJob(Zone *z) : ZoneBootJob("static zone points", true), z(z) { }
+	virtual bool Run(ZoneDatabase *db) { return(db->LoadStaticZonePoints(&z->zone_point_list, z->GetShortName(), z->GetInstanceVersion())); }
+	Zone *z;
+};
+
+class SpawnGroupsLoadJob : public ZoneBootJob {
+public:
+	SpawnGroupsLoadJob(Zone *z) : ZoneBootJob("spawn groups", true), z(z) { }
+	virtual bool Run(ZoneDatabase *db) { return(db->LoadSpawnGroups(z->GetShortName(), z->GetInstanceVersion(), &z->spawn_group_list)); }
+	Zone *z;
+};
+
+class GridsLoadJob : public ZoneBootJob {
+public:
+	GridsLoadJob(Zone *z) : ZoneBootJob("grids", true), z(z) { }
+	virtual bool Run(ZoneDatabase *db) { return(db->LoadGrids(z->GetZoneID(), z->grids)); }
+	Zone *z;
+};
+
+class Spawn2LoadJob : public ZoneBootJob {
+public:
+	Spawn2LoadJob(Zone *z) : ZoneBootJob("spawn2 points", true), z(z) { }
+	virtual bool Run(ZoneDatabase *db) { return(db->PopulateZoneSpawnList(z->GetZoneID(), z->spawn2_list, z->GetInstanceVersion())); }
+	Zone *z;
+};
+
 bool Zone::Init(bool iStaticZone) {
 	SetStaticZone(iStaticZone);
 
-	LogFile->write(EQEMuLog::Status, "Loading spawn conditions...");
-	if(!spawn_conditions.LoadSpawnConditions(short_name, instanceid)) {
-		LogFile->write(EQEMuLog::Error, "Loading spawn conditions failed, continuing without them.");
-	}
+	ZoneBootPipeline boot(short_name, RuleB(Zone, ParallelBoot));
 
-	LogFile->write(EQEMuLog::Status, "Loading static zone points...");
-	if (!database.LoadStaticZonePoints(&zone_point_list, short_name, GetInstanceVersion())) {
-		LogFile->write(EQEMuLog::Error, "Loading static zone points failed.");
-		return false;
-	}
+	//the zone config comes first, it names the map files the boot jobs load
+	if (!LoadZoneCFG(zone->GetShortName(), zone->GetInstanceVersion(), true)) // try loading the zone name...
+		LoadZoneCFG(zone->GetFileName(), zone->GetInstanceVersion()); // if that fails, try the file name, then load defaults
 
-	LogFile->write(EQEMuLog::Status, "Loading spawn groups...");
-	if (!database.LoadSpawnGroups(short_name, GetInstanceVersion(), &spawn_group_list)) {
-		LogFile->write(EQEMuLog::Error, "Loading spawn groups failed.");
-		return false;
+	if(RuleManager::Instance()->GetActiveRulesetID() != default_ruleset)
+	{
+		std::string r_name = RuleManager::Instance()->GetRulesetName(&database, default_ruleset);
+		if(r_name.size() > 0)
+		{
+			RuleManager::Instance()->LoadRules(&database, r_name.c_str());
+		}
 	}
+	boot.Stage("zone config");
+
+	const char *map_file = map_name ? map_name : short_name;
+	MapLoadJob *map_job = new MapLoadJob(map_file);
+	WaterMapLoadJob *water_job = new WaterMapLoadJob(map_file);
+	PathLoadJob *path_job = new PathLoadJob(map_file);
+	ZonePointsLoadJob *zone_points_job = new ZonePointsLoadJob(this);
+	SpawnGroupsLoadJob *spawn_groups_job = new SpawnGroupsLoadJob(this);
+	Spawn2LoadJob *spawn2_job = new Spawn2LoadJob(this);
+	GridsLoadJob *grids_job = new GridsLoadJob(this);
+	boot.Start(map_job);
+	boot.Start(water_job);
+	boot.Start(path_job);
+	boot.Start(zone_points_job);
+	boot.Start(spawn_groups_job);
+	boot.Start(spawn2_job);
+	boot.Start(grids_job);
 
-	LogFile->write(EQEMuLog::Status, "Loading spawn2 points...");
-	if (!database.PopulateZoneSpawnList(zoneid, spawn2_list, GetInstanceVersion()))
-	{
-		LogFile->write(EQEMuLog::Error, "Loading spawn2 points failed.");
-		return false;
+	LogFile->write(EQEMuLog::Status, "Loading spawn conditions...");
+	if(!spawn_conditions.LoadSpawnConditions(short_name, instanceid)) {
+		LogFile->write(EQEMuLog::Error, "Loading spawn conditions failed, continuing without them.");
 	}
+	boot.Stage("spawn conditions");
 
 	LogFile->write(EQEMuLog::Status, "Loading player corpses...");
 	if (!database.LoadPlayerCorpses(zoneid, instanceid)) {
 		LogFile->write(EQEMuLog::Error, "Loading player corpses failed.");
 		return false;
 	}
+	boot.Stage("player corpses");
 
 	LogFile->write(EQEMuLog::Status, "Loading traps...");
 	if (!database.LoadTraps(short_name, GetInstanceVersion()))
@@ -859,22 +931,26 @@ bool Zone::Init(bool iStaticZone) {
 		LogFile->write(EQEMuLog::Error, "Loading traps failed.");
 		return false;
 	}
+	boot.Stage("traps");
 
 	LogFile->write(EQEMuLog::Status, "Loading ground spawns...");
 	if (!LoadGroundSpawns())
 	{
 		LogFile->write(EQEMuLog::Error, "Loading ground spawns failed. continuing.");
 	}
+	boot.Stage("ground spawns");
 
 	LogFile->write(EQEMuLog::Status, "Loading World Objects from DB...");
 	if (!LoadZoneObjects())
 	{
 		LogFile->write(EQEMuLog::Error, "Loading World Objects failed. continuing.");
 	}
+	boot.Stage("objects");
 
 	//load up the zone's doors (prints inside)
 	zone->LoadZoneDoors(zone->GetShortName(), zone->GetInstanceVersion());
 	zone->LoadBlockedSpells(zone->GetZoneID());
+	boot.Stage("doors, blocked spells");
 
 	//clear trader items if we are loading the bazaar
 	if(strncasecmp(short_name,"bazaar",6)==0) {
@@ -883,10 +959,12 @@ bool Zone::Init(bool iStaticZone) {
 	}
 
 	zone->LoadNPCEmotes(&NPCEmoteList);
+	boot.Stage("npc emotes");
 
 	//Load AA information
 	adverrornum = 500;
 	LoadAAs();
+	boot.Stage("aas");
 
 	//Load merchant data
 	adverrornum = 501;
@@ -895,6 +973,7 @@ bool Zone::Init(bool iStaticZone) {
 	//Load temporary merchant data
 	adverrornum = 502;
 	zone->LoadTempMerchantData();
+	boot.Stage("merchants");
 
 	if (RuleB(Zone, LevelBasedEXPMods))
 		zone->LoadLevelEXPMods();
@@ -903,32 +982,117 @@ bool Zone::Init(bool iStaticZone) {
 	petition_list.ClearPetitions();
 	petition_list.ReadDatabase();
 
-	//load the zone config file.
-	if (!LoadZoneCFG(zone->GetShortName(), zone->GetInstanceVersion(), true)) // try loading the zone name...
-		LoadZoneCFG(zone->GetFileName(), zone->GetInstanceVersion()); // if that fails, try the file name, then load defaults
+	LogFile->write(EQEMuLog::Status, "Loading timezone data...");
+	zone->zone_time.setEQTimeZone(database.GetZoneTZ(zoneid, GetInstanceVersion()));
 
-	if(RuleManager::Instance()->GetActiveRulesetID() != default_ruleset)
-	{
-		std::string r_name = RuleManager::Instance()->GetRulesetName(&database, default_ruleset);
-		if(r_name.size() > 0)
-		{
-			RuleManager::Instance()->LoadRules(&database, r_name.c_str());
-		}
+	LoadTickItems();
+	boot.Stage("petitions, tz, tick items");
+
+	//everything from here on may use what the jobs loaded
+	boot.Join();
+	zonemap = map_job->map;
+	map_job->map = nullptr;
+	watermap = water_job->watermap;
+	water_job->watermap = nullptr;
+	pathing = path_job->pathing;
+	path_job->pathing = nullptr;
+
+	if (!zone_points_job->GetResult()) {
+		LogFile->write(EQEMuLog::Error, "Loading static zone points failed.");
+		return false;
+	}
+	if (!spawn_groups_job->GetResult()) {
+		LogFile->write(EQEMuLog::Error, "Loading spawn groups failed.");
+		return false;
+	}
+	if (!spawn2_job->GetResult()) {
+		LogFile->write(EQEMuLog::Error, "Loading spawn2 points failed.");
+		return false;
+	}
+	if (!grids_job->GetResult()) {
+		//not fatal, GetGrid will try each grid again as it is asked for
+		LogFile->write(EQEMuLog::Error, "Loading grids failed.");
+		grids.clear();
 	}
 
-	LogFile->write(EQEMuLog::Status, "Loading timezone data...");
-	zone->zone_time.setEQTimeZone(database.GetZoneTZ(zoneid, GetInstanceVersion()));
+	//needs the map, so only once the jobs are done
+	std::unordered_map<uint32, std::shared_ptr<ZoneGrid> >::iterator grid_iter;
+	for(grid_iter = grids.begin(); grid_iter != grids.end(); ++grid_iter) {
+		if(grid_iter->second)
+			FixGridZ(*grid_iter->second);
+	}
+	boot.Stage("grid z");
 
 	LogFile->write(EQEMuLog::Status, "Init Finished: ZoneID = %d, Time Offset = %d", zoneid, zone->zone_time.getEQTimeZone());
 
-	LoadTickItems();
-
 	//MODDING HOOK FOR ZONE INIT
 	mod_init();
+	boot.Stage("mod init");
+
+	boot.LogTimings();
 
 	return true;
 }
 
+void Zone::LoadGrids() {
+	grids.clear();
+	if(!database.LoadGrids(zoneid, grids)) {
+		LogFile->write(EQEMuLog::Error, "Loading grids failed.");
+		grids.clear();
+		return;
+	}
+
+	std::unordered_map<uint32, std::shared_ptr<ZoneGrid> >::iterator iter;
+	for(iter = grids.begin(); iter != grids.end(); ++iter) {
+		if(iter->second)
+			FixGridZ(*iter->second);
+	}
+}
+
+std::shared_ptr<const ZoneGrid> Zone::GetGrid(uint32 grid_id) {
+	std::unordered_map<uint32, std::shared_ptr<ZoneGrid> >::iterator iter = grids.find(grid_id);
+	if(iter != grids.end())
+		return(iter->second);
+
+	std::unordered_map<uint32, std::shared_ptr<ZoneGrid> > loaded;
+	if(!database.LoadGrids(zoneid, loaded, grid_id))
+		return(std::shared_ptr<const ZoneGrid>());	//db error, don't remember it so the next spawn tries again
+
+	//remember grids that don't exist too, so a bad pathgrid doesn't query on every spawn
+	std::shared_ptr<ZoneGrid> grid;
+	iter = loaded.find(grid_id);
+	if(iter != loaded.end()) {
+		grid = iter->second;
+		FixGridZ(*grid);
+	}
+	grids[grid_id] = grid;
+	return(grid);
+}
+
+void Zone::ReloadGrid(uint32 grid_id) {
+	grids.erase(grid_id);
+}
+
+void Zone::FixGridZ(ZoneGrid &grid) {
+	if(!HasMap() || !RuleB(Map, FixPathingZWhenLoading))
+		return;
+
+	std::vector<wplist>::iterator cur, end;
+	cur = grid.waypoints.begin();
+	end = grid.waypoints.end();
+	for(; cur != end; ++cur) {
+		if(RuleB(Watermap, CheckWaypointsInWaterWhenLoading) && HasWaterMap() && watermap->InWater(cur->x, cur->y, cur->z))
+			continue;
+
+		Map::Vertex dest(cur->x, cur->y, cur->z);
+
+		float newz = zonemap->FindBestZ(dest, nullptr);
+
+		if( (newz > -2000) && fabs(newz-dest.z) < RuleR(Map, FixPathingZMaxDeltaLoading))
+			cur->z = newz + 1;
+	}
+}
+
 void Zone::ReloadStaticData() {
 	LogFile->write(EQEMuLog::Status, "Reloading Zone Static Data...");
 
@@ -965,6 +1129,9 @@ void Zone::ReloadStaticData() {
 	NPCEmoteList.Clear();
 	zone->LoadNPCEmotes(&NPCEmoteList);
 
+	LogFile->write(EQEMuLog::Status, "Reloading grids...");
+	LoadGrids();
+
 	//load the zone config file.
 	if (!LoadZoneCFG(zone->GetShortName(), zone->GetInstanceVersion(), true)) // try loading the zone name...
 		LoadZoneCFG(zone->GetFileName(), zone->GetInstanceVersion()); // if that fails, try the file name, then load defaults
@@ -1335,6 +1502,12 @@ std::map<uint32,NPCType *>::iterator itr;
 }
 
 void Zone::ClearNPCTypeCache(int id) {
+	// the shared copy can only be refreshed by rerunning shared_memory, so skip it from now on
+	if (id <= 0)
+		all_npc_types_stale = true;
+	else
+		stale_npc_types.insert((uint32)id);
+
 	if (id <= 0) {
 		auto iter = npctable.begin();
 		while (iter != npctable.end()) {
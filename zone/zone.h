@@ -31,7 +31,10 @@
 #include "zonedump.h"
 #include "spawn2.h"
 #include "pathing.h"
+#include "los_cache.h"
 #include "QGlobals.h"
+#include <memory>
+#include <set>
 #include <unordered_map>
 
 class Map;
@@ -145,6 +148,8 @@ public:
 	bool	Depop(bool StartSpawnTimer = false);
 	void	Repop(uint32 delay = 0);
 	void	ClearNPCTypeCache(int id);
+	//true if the shared memory copy of this npc type was cleared and it has to come from the db
+	bool	IsNPCTypeStale(uint32 id) const { return all_npc_types_stale || stale_npc_types.count(id) != 0; }
 	void	SpawnStatus(Mob* client);
 	void	ShowEnabledSpawnStatus(Mob* client);
 	void	ShowDisabledSpawnStatus(Mob* client);
@@ -182,6 +187,8 @@ public:
 	void SetInstanceTimer(uint32 new_duration);
 
 	std::map<uint32,NPCType *> npctable;
+	std::set<uint32> stale_npc_types;
+	bool all_npc_types_stale;
 	std::map<uint32,std::list<MerchantList> > merchanttable;
 	std::map<uint32,std::list<TempMerchantList> > tmpmerchanttable;
 	std::map<uint32, ZoneEXPModInfo> level_exp_mod;
@@ -192,6 +199,7 @@ public:
 	Map*	zonemap;
 	WaterMap* watermap;
 	PathManager *pathing;
+	LOSCache los_cache;
 	NewZone_Struct	newzone_data;
 
 	SpawnConditionManager spawn_conditions;
@@ -239,6 +247,15 @@ public:
 	LinkedList<ZonePoint*> zone_point_list;
 	uint32	numzonepoints;
 
+	//every grid in the zone, loaded in one pass at boot. NPCs hold a reference to their
+	//grid rather than a copy, so a reload only replaces the entry here.
+	std::unordered_map<uint32, std::shared_ptr<ZoneGrid> > grids;
+	//null if the zone has no such grid, grids missing from the table are loaded on demand
+	std::shared_ptr<const ZoneGrid> GetGrid(uint32 grid_id);
+	//drops the cached copy of a grid so the next GetGrid reads it again
+	void	ReloadGrid(uint32 grid_id);
+	void	LoadGrids();
+
 	LinkedList<NPC_Emote_Struct*> NPCEmoteList;
 
     void    LoadTickItems();
@@ -251,6 +268,8 @@ public:
 	void mod_repop();
 
 private:
+	void	FixGridZ(ZoneGrid &grid);
+
 	uint32	zoneid;
 	uint32	instanceid;
 	uint16	instanceversion;
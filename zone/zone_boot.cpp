@@ -0,0 +1,186 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "../common/debug.h"
+#include "../common/tick_profiler.h"
+#include "zone_boot.h"
+#include "zonedb.h"
+#include "ZoneConfig.h"
+
+#ifdef _WINDOWS
+	#include <process.h>
+#else
+	#include <pthread.h>
+#endif
+
+extern ZoneDatabase database;
+
+ZoneBootJob::ZoneBootJob(const char *name, bool uses_db)
+:	name(name),
+	uses_db(uses_db),
+	result(false),
+	elapsed(0),
+	pipeline(nullptr)
+{
+}
+
+ThreadReturnType ZoneBootJobLoop(void *tmp) {
+	ZoneBootJob *job = (ZoneBootJob *) tmp;
+	ZoneBootPipeline *pipeline = job->pipeline;
+
+	ZoneBootPipeline::RunJob(job);
+
+	//signalled under the lock, once it is released the pipeline may already be gone
+	pipeline->CJobDone.Lock();
+	pipeline->running--;
+	pipeline->CJobDone.SignalLocked();
+	pipeline->CJobDone.Unlock();
+
+	THREAD_RETURN(nullptr);
+}
+
+ZoneBootPipeline::ZoneBootPipeline(const char *zone_name, bool parallel)
+:	zone_name(zone_name),
+	parallel(parallel),
+	join_wait(0),
+	running(0)
+{
+	start = TickProfiler::Now();
+	stage_start = start;
+}
+
+ZoneBootPipeline::~ZoneBootPipeline() {
+	Join();
+
+	std::vector<ZoneBootJob *>::iterator cur, end;
+	cur = jobs.begin();
+	end = jobs.end();
+	for(; cur != end; ++cur) {
+		safe_delete(*cur);
+	}
+}
+
+void ZoneBootPipeline::RunJob(ZoneBootJob *job) {
+	uint64 begin = TickProfiler::Now();
+
+	ZoneDatabase *db = nullptr;
+	ZoneDatabase *own_db = nullptr;
+	if(job->uses_db) {
+		const ZoneConfig *Config = ZoneConfig::get();
+		own_db = new ZoneDatabase();
+		if(own_db->Connect(Config->DatabaseHost.c_str(), Config->DatabaseUsername.c_str(),
+			Config->DatabasePassword.c_str(), Config->DatabaseDB.c_str(), Config->DatabasePort)) {
+			db = own_db;
+		} else {
+			//the shared connection serializes its queries, slower but still correct
+			LogFile->write(EQEMuLog::Error, "Zone boot job %s could not open its own database connection, using the shared one.", job->GetName());
+			safe_delete(own_db);
+			db = &database;
+		}
+	}
+
+	job->result = job->Run(db);
+	safe_delete(own_db);
+
+	job->elapsed = TickProfiler::Now() - begin;
+}
+
+void ZoneBootPipeline::Start(ZoneBootJob *job) {
+	if(job == nullptr)
+		return;
+
+	job->pipeline = this;
+	jobs.push_back(job);
+
+	if(!parallel) {
+		RunJob(job);
+		return;
+	}
+
+	CJobDone.Lock();
+	running++;
+	CJobDone.Unlock();
+
+#ifdef _WINDOWS
+	if(_beginthread(ZoneBootJobLoop, 0, job) == -1L) {
+#else
+	pthread_t thread;
+	if(pthread_create(&thread, nullptr, ZoneBootJobLoop, job) == 0) {
+		pthread_detach(thread);
+	} else {
+#endif
+		LogFile->write(EQEMuLog::Error, "Unable to start a thread for zone boot job %s, running it in place.", job->GetName());
+		CJobDone.Lock();
+		running--;
+		CJobDone.Unlock();
+		RunJob(job);
+	}
+}
+
+void ZoneBootPipeline::Stage(const char *name) {
+	uint64 now = TickProfiler::Now();
+	StageTime s;
+	s.name = name;
+	s.elapsed = now - stage_start;
+	stages.push_back(s);
+	stage_start = now;
+}
+
+bool ZoneBootPipeline::Join() {
+	uint64 begin = TickProfiler::Now();
+
+	//checked and waited on under the same lock the jobs signal under, so a finish can't slip in between
+	CJobDone.Lock();
+	while(running > 0)
+		CJobDone.WaitLocked();
+	CJobDone.Unlock();
+
+	uint64 now = TickProfiler::Now();
+	join_wait += now - begin;
+	stage_start = now;
+
+	bool res = true;
+	std::vector<ZoneBootJob *>::iterator cur, end;
+	cur = jobs.begin();
+	end = jobs.end();
+	for(; cur != end; ++cur) {
+		if(!(*cur)->result)
+			res = false;
+	}
+	return(res);
+}
+
+void ZoneBootPipeline::LogTimings() {
+	uint64 total = TickProfiler::Now() - start;
+	LogFile->write(EQEMuLog::Status, "Boot of %s took %u ms, %u ms of it waiting on %d parallel jobs.",
+		zone_name.c_str(), (uint32)(total / 1000), (uint32)(join_wait / 1000), (int)jobs.size());
+
+	std::vector<StageTime>::iterator scur, send;
+	scur = stages.begin();
+	send = stages.end();
+	for(; scur != send; ++scur) {
+		LogFile->write(EQEMuLog::Status, "  %-24s %6u ms", scur->name.c_str(), (uint32)(scur->elapsed / 1000));
+	}
+
+	std::vector<ZoneBootJob *>::iterator jcur, jend;
+	jcur = jobs.begin();
+	jend = jobs.end();
+	for(; jcur != jend; ++jcur) {
+		LogFile->write(EQEMuLog::Status, "  %-24s %6u ms%s%s", (*jcur)->GetName(), (uint32)((*jcur)->GetElapsed() / 1000),
+			parallel ? " (parallel)" : "", (*jcur)->GetResult() ? "" : " FAILED");
+	}
+}
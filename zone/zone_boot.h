@@ -0,0 +1,108 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef ZONE_BOOT_H
+#define ZONE_BOOT_H
+
+#include "../common/types.h"
+#include "../common/Condition.h"
+#include <string>
+#include <vector>
+
+class ZoneDatabase;
+class ZoneBootPipeline;
+
+//one independent piece of a zone boot, see ZoneBootPipeline
+class ZoneBootJob
+{
+public:
+	ZoneBootJob(const char *name, bool uses_db);
+	virtual ~ZoneBootJob() { }
+
+	//db is a connection of the job's own (or the shared one if that could not be
+	//opened), nullptr for jobs which do not use the database
+	virtual bool Run(ZoneDatabase *db) = 0;
+
+	inline const char *GetName() const { return(name.c_str()); }
+	inline bool GetResult() const { return(result); }
+	//usec the job took, connecting included
+	inline uint64 GetElapsed() const { return(elapsed); }
+
+private:
+	std::string name;
+	bool uses_db;
+	bool result;
+	uint64 elapsed;
+	ZoneBootPipeline *pipeline;
+
+	friend class ZoneBootPipeline;
+	friend ThreadReturnType ZoneBootJobLoop(void *tmp);
+};
+
+/*
+	Runs the independent parts of a zone boot side by side. File loads and DB loads which
+	only fill something the rest of the boot does not touch are started as jobs on their
+	own threads, DB jobs each with a connection of their own, while the boot carries on
+	with everything else on the main thread. Join waits for all of them, the destructor
+	does too so a boot failing part way can't leave a job writing into a deleted zone.
+
+	Jobs must not touch entity_list, the shared database connection's state or anything
+	the main thread works on before the Join.
+
+	Main thread work is timed with Stage, and every stage and job time is logged with
+	LogTimings once the boot is done.
+*/
+class ZoneBootPipeline
+{
+public:
+	//parallel false runs every job on the calling thread as it is started
+	ZoneBootPipeline(const char *zone_name, bool parallel = true);
+	~ZoneBootPipeline();
+
+	//takes ownership of job, which stays valid until the pipeline is destroyed
+	void Start(ZoneBootJob *job);
+	//records the main thread time since the previous Stage call as name
+	void Stage(const char *name);
+	//waits for every started job, false if any of them failed
+	bool Join();
+	void LogTimings();
+
+private:
+	ZoneBootPipeline(const ZoneBootPipeline &);
+	ZoneBootPipeline &operator=(const ZoneBootPipeline &);
+
+	static void RunJob(ZoneBootJob *job);
+	friend ThreadReturnType ZoneBootJobLoop(void *tmp);
+
+	struct StageTime {
+		std::string name;
+		uint64 elapsed;
+	};
+
+	std::string zone_name;
+	bool parallel;
+	uint64 start;
+	uint64 stage_start;
+	uint64 join_wait;
+	std::vector<StageTime> stages;
+	std::vector<ZoneBootJob *> jobs;
+
+	uint32 running;	//guarded by CJobDone's lock
+	Condition CJobDone;
+};
+
+#endif
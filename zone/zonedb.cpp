@@ -961,9 +961,9 @@ bool ZoneDatabase::NoRentExpired(const char* name){
 	return false;
 }
 
-/* Searches npctable for matching id, and returns the item if found,
- * or nullptr otherwise. If id passed is 0, loads all npc_types for
- * the current zone, returning the last item added.
+/* Searches npctable for matching id, then the shared npc_types built by
+ * shared_memory, and finally the database. Rows read from the database are
+ * kept in npctable. Returns nullptr if the id doesnt exist.
  */
 const NPCType* ZoneDatabase::GetNPCType (uint32 id) {
 	const NPCType *npc=nullptr;
@@ -973,281 +973,28 @@ const NPCType* ZoneDatabase::GetNPCType (uint32 id) {
 	if((itr = zone->npctable.find(id)) != zone->npctable.end())
 		return itr->second;
 
+	// Types cleared with ClearNPCTypeCache since we mapped the shared copy are reread from the db.
+	if(!zone->IsNPCTypeStale(id)) {
+		npc = GetSharedNPCType(id);
+		if(npc)
+			return npc;
+	}
+
 		// Otherwise, get NPCs from database.
 		char errbuf[MYSQL_ERRMSG_SIZE];
 		char *query = 0;
 		MYSQL_RES *result;
 		MYSQL_ROW row;
 
-
-		// If id is 0, load all npc_types for the current zone,
-		// according to spawn2.
-		const char *basic_query = "SELECT "
-			"npc_types.id,"
-			"npc_types.name,"
-			"npc_types.level,"
-			"npc_types.race,"
-			"npc_types.class,"
-			"npc_types.hp,"
-			"npc_types.mana,"
-			"npc_types.gender,"
-			"npc_types.texture,"
-			"npc_types.helmtexture,"
-			"npc_types.size,"
-			"npc_types.loottable_id,"
-			"npc_types.merchant_id,"
-			"npc_types.trap_template,"
-			"npc_types.attack_speed,"
-			"npc_types.STR,"
-			"npc_types.STA,"
-			"npc_types.DEX,"
-			"npc_types.AGI,"
-			"npc_types._INT,"
-			"npc_types.WIS,"
-			"npc_types.CHA,"
-			"npc_types.MR,"
-			"npc_types.CR,"
-			"npc_types.DR,"
-			"npc_types.FR,"
-			"npc_types.PR,"
-			"npc_types.Corrup,"
-			"npc_types.PhR,"
-			"npc_types.mindmg,"
-			"npc_types.maxdmg,"
-			"npc_types.attack_count,"
-			"npc_types.special_abilities,"
-			"npc_types.npc_spells_id,"
-			"npc_types.npc_spells_effects_id,"
-			"npc_types.d_meele_texture1,"
-			"npc_types.d_meele_texture2,"
-			"npc_types.prim_melee_type,"
-			"npc_types.sec_melee_type,"
-			"npc_types.runspeed,"
-			"npc_types.findable,"
-			"npc_types.trackable,"
-			"npc_types.hp_regen_rate,"
-			"npc_types.mana_regen_rate,"
-			"npc_types.aggroradius,"
-			"npc_types.assistradius,"
-			"npc_types.bodytype,"
-			"npc_types.npc_faction_id,"
-			"npc_types.face,"
-			"npc_types.luclin_hairstyle,"
-			"npc_types.luclin_haircolor,"
-			"npc_types.luclin_eyecolor,"
-			"npc_types.luclin_eyecolor2,"
-			"npc_types.luclin_beardcolor,"
-			"npc_types.luclin_beard,"
-			"npc_types.drakkin_heritage,"
-			"npc_types.drakkin_tattoo,"
-			"npc_types.drakkin_details,"
-			"npc_types.armortint_id,"
-			"npc_types.armortint_red,"
-			"npc_types.armortint_green,"
-			"npc_types.armortint_blue,"
-			"npc_types.see_invis,"
-			"npc_types.see_invis_undead,"
-			"npc_types.lastname,"
-			"npc_types.qglobal,"
-			"npc_types.AC,"
-			"npc_types.npc_aggro,"
-			"npc_types.spawn_limit,"
-			"npc_types.see_hide,"
-			"npc_types.see_improved_hide,"
-			"npc_types.ATK,"
-			"npc_types.Accuracy,"
-			"npc_types.slow_mitigation,"
-			"npc_types.maxlevel,"
-			"npc_types.scalerate,"
-			"npc_types.private_corpse,"
-			"npc_types.unique_spawn_by_name,"
-			"npc_types.underwater,"
-			"npc_types.emoteid,"
-			"npc_types.spellscale,"
-			"npc_types.healscale,"
-			"npc_types.no_target_hotkey";
-
-		MakeAnyLenString(&query, "%s FROM npc_types WHERE id=%d", basic_query, id);
+		MakeAnyLenString(&query, "%s WHERE id=%d", NPCTypesQuery(), id);
 
 		if (RunQuery(query, strlen(query), errbuf, &result)) {
 			// Process each row returned.
 			while((row = mysql_fetch_row(result))) {
 				NPCType *tmpNPCType;
 				tmpNPCType = new NPCType;
-				memset (tmpNPCType, 0, sizeof *tmpNPCType);
-
-				int r = 0;
-				tmpNPCType->npc_id = atoi(row[r++]);
-
-				strn0cpy(tmpNPCType->name, row[r++], 50);
-
-				tmpNPCType->level = atoi(row[r++]);
-				tmpNPCType->race = atoi(row[r++]);
-				tmpNPCType->class_ = atoi(row[r++]);
-				tmpNPCType->max_hp = atoi(row[r++]);
-				tmpNPCType->cur_hp = tmpNPCType->max_hp;
-				tmpNPCType->Mana = atoi(row[r++]);
-				tmpNPCType->gender = atoi(row[r++]);
-				tmpNPCType->texture = atoi(row[r++]);
-				tmpNPCType->helmtexture = atoi(row[r++]);
-				tmpNPCType->size = atof(row[r++]);
-				tmpNPCType->loottable_id = atoi(row[r++]);
-				tmpNPCType->merchanttype = atoi(row[r++]);
-				tmpNPCType->trap_template = atoi(row[r++]);
-				tmpNPCType->attack_speed = atof(row[r++]);
-				tmpNPCType->STR = atoi(row[r++]);
-				tmpNPCType->STA = atoi(row[r++]);
-				tmpNPCType->DEX = atoi(row[r++]);
-				tmpNPCType->AGI = atoi(row[r++]);
-				tmpNPCType->INT = atoi(row[r++]);
-				tmpNPCType->WIS = atoi(row[r++]);
-				tmpNPCType->CHA = atoi(row[r++]);
-				tmpNPCType->MR = atoi(row[r++]);
-				tmpNPCType->CR = atoi(row[r++]);
-				tmpNPCType->DR = atoi(row[r++]);
-				tmpNPCType->FR = atoi(row[r++]);
-				tmpNPCType->PR = atoi(row[r++]);
-				tmpNPCType->Corrup = atoi(row[r++]);
-				tmpNPCType->PhR = atoi(row[r++]);
-				tmpNPCType->min_dmg = atoi(row[r++]);
-				tmpNPCType->max_dmg = atoi(row[r++]);
-				tmpNPCType->attack_count = atoi(row[r++]);
-				strn0cpy(tmpNPCType->special_abilities, row[r++], 512);
-				tmpNPCType->npc_spells_id = atoi(row[r++]);
-				tmpNPCType->npc_spells_effects_id = atoi(row[r++]);
-				tmpNPCType->d_meele_texture1 = atoi(row[r++]);
-				tmpNPCType->d_meele_texture2 = atoi(row[r++]);
-				tmpNPCType->prim_melee_type = atoi(row[r++]);
-				tmpNPCType->sec_melee_type = atoi(row[r++]);
-				tmpNPCType->runspeed= atof(row[r++]);
-				tmpNPCType->findable = atoi(row[r++]) == 0? false : true;
-				tmpNPCType->trackable = atoi(row[r++]) == 0? false : true;
-				tmpNPCType->hp_regen = atoi(row[r++]);
-				tmpNPCType->mana_regen = atoi(row[r++]);
-
-				tmpNPCType->aggroradius = (int32)atoi(row[r++]);
-				// set defaultvalue for aggroradius
-				if (tmpNPCType->aggroradius <= 0)
-					tmpNPCType->aggroradius = 70;
-				tmpNPCType->assistradius = (int32)atoi(row[r++]);
-				if (tmpNPCType->assistradius <= 0)
-					tmpNPCType->assistradius = tmpNPCType->aggroradius;
-
-				if (row[r] && strlen(row[r]))
-					tmpNPCType->bodytype = (uint8)atoi(row[r]);
-				else
-					tmpNPCType->bodytype = 0;
-				r++;
-
-				tmpNPCType->npc_faction_id = atoi(row[r++]);
-
-				tmpNPCType->luclinface = atoi(row[r++]);
-				tmpNPCType->hairstyle = atoi(row[r++]);
-				tmpNPCType->haircolor = atoi(row[r++]);
-				tmpNPCType->eyecolor1 = atoi(row[r++]);
-				tmpNPCType->eyecolor2 = atoi(row[r++]);
-				tmpNPCType->beardcolor = atoi(row[r++]);
-				tmpNPCType->beard = atoi(row[r++]);
-				tmpNPCType->drakkin_heritage = atoi(row[r++]);
-				tmpNPCType->drakkin_tattoo = atoi(row[r++]);
-				tmpNPCType->drakkin_details = atoi(row[r++]);
-				uint32 armor_tint_id = atoi(row[r++]);
-				tmpNPCType->armor_tint[0] = (atoi(row[r++]) & 0xFF) << 16;
-				tmpNPCType->armor_tint[0] |= (atoi(row[r++]) & 0xFF) << 8;
-				tmpNPCType->armor_tint[0] |= (atoi(row[r++]) & 0xFF);
-				tmpNPCType->armor_tint[0] |= (tmpNPCType->armor_tint[0]) ? (0xFF << 24) : 0;
-				
-				int i;
-				if (armor_tint_id > 0)
-				{
-					if (tmpNPCType->armor_tint[0] == 0)
-					{
-						char at_errbuf[MYSQL_ERRMSG_SIZE];
-						char *at_query = nullptr;
-						MYSQL_RES *at_result = nullptr;
-						MYSQL_ROW at_row;
-
-						MakeAnyLenString(&at_query,
-						"SELECT "
-						"red1h,grn1h,blu1h,"
-						"red2c,grn2c,blu2c,"
-						"red3a,grn3a,blu3a,"
-						"red4b,grn4b,blu4b,"
-						"red5g,grn5g,blu5g,"
-						"red6l,grn6l,blu6l,"
-						"red7f,grn7f,blu7f,"
-						"red8x,grn8x,blu8x,"
-						"red9x,grn9x,blu9x "
-						"FROM npc_types_tint WHERE id=%d", armor_tint_id);
-
-						if (RunQuery(at_query, strlen(at_query), at_errbuf, &at_result))
-						{
-							if ((at_row = mysql_fetch_row(at_result)))
-							{
-								for (i = 0; i < _MaterialCount; i++)
-								{
-									tmpNPCType->armor_tint[i] = atoi(at_row[i * 3]) << 16;
-									tmpNPCType->armor_tint[i] |= atoi(at_row[i * 3 + 1]) << 8;
-									tmpNPCType->armor_tint[i] |= atoi(at_row[i * 3 + 2]);
-									tmpNPCType->armor_tint[i] |= (tmpNPCType->armor_tint[i]) ? (0xFF << 24) : 0;
-								}
-							}
-							else
-							{
-								armor_tint_id = 0;
-							}
-						}
-						else
-						{
-							armor_tint_id = 0;
-						}
-
-						if (at_result)
-						{
-							mysql_free_result(at_result);
-						}
-
-						safe_delete_array(at_query);
-					}
-					else
-					{
-						armor_tint_id = 0;
-					}
-				}
-
-				if (armor_tint_id == 0)
-				{
-					for (i = 1; i < _MaterialCount; i++)
-					{
-						tmpNPCType->armor_tint[i] = tmpNPCType->armor_tint[0];
-					}
-				}
+				LoadNPCTypeRow(row, tmpNPCType);
 
-				tmpNPCType->see_invis = atoi(row[r++]);
-				tmpNPCType->see_invis_undead = atoi(row[r++])==0?false:true;	// Set see_invis_undead flag
-				if (row[r] != nullptr)
-					strn0cpy(tmpNPCType->lastname, row[r], 32);
-				r++;
-
-				tmpNPCType->qglobal = atoi(row[r++])==0?false:true;	// qglobal
-				tmpNPCType->AC = atoi(row[r++]);
-				tmpNPCType->npc_aggro = atoi(row[r++])==0?false:true;
-				tmpNPCType->spawn_limit = atoi(row[r++]);
-				tmpNPCType->see_hide = atoi(row[r++])==0?false:true;
-				tmpNPCType->see_improved_hide = atoi(row[r++])==0?false:true;
-				tmpNPCType->ATK = atoi(row[r++]);
-				tmpNPCType->accuracy_rating = atoi(row[r++]);
-				tmpNPCType->slow_mitigation = atoi(row[r++]);
-				tmpNPCType->maxlevel = atoi(row[r++]);
-				tmpNPCType->scalerate = atoi(row[r++]);
-				tmpNPCType->private_corpse = atoi(row[r++]) == 1 ? true : false;
-				tmpNPCType->unique_spawn_by_name = atoi(row[r++]) == 1 ? true : false;
-				tmpNPCType->underwater = atoi(row[r++]) == 1 ? true : false;
-				tmpNPCType->emoteid = atoi(row[r++]);
-				tmpNPCType->spellscale = atoi(row[r++]);
-				tmpNPCType->healscale = atoi(row[r++]);
-				tmpNPCType->no_target_hotkey = atoi(row[r++]) == 1 ? true : false;
-				
 				// If NPC with duplicate NPC id already in table,
 				// free item we attempted to add.
 				if (zone->npctable.find(tmpNPCType->npc_id) != zone->npctable.end())
@@ -1795,29 +1542,37 @@ void ZoneDatabase::InsertDoor(uint32 ddoordbid, uint16 ddoorid, const char* ddoo
 	safe_delete_array(query);
 }
 
-void ZoneDatabase::SaveBuffs(Client *c) {
+//adds a query's length to a running total and passes it on, used to count what a save writes
+static inline uint32 CountQuery(uint32 &total, uint32 len) {
+	total += len;
+	return len;
+}
+
+uint32 ZoneDatabase::SaveBuffs(Client *c) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char* query = 0;
+	uint32 written = 0;
 
-	database.RunQuery(query, MakeAnyLenString(&query, "DELETE FROM `character_buffs` WHERE `character_id`='%u'", c->CharacterID()),
+	database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query, "DELETE FROM `character_buffs` WHERE `character_id`='%u'", c->CharacterID())),
 		errbuf);
 
 	uint32 buff_count = c->GetMaxBuffSlots();
 	Buffs_Struct *buffs = c->GetBuffs();
 	for (int i = 0; i < buff_count; i++) {
 		if(buffs[i].spellid != SPELL_UNKNOWN) {
-			if(!database.RunQuery(query, MakeAnyLenString(&query, "INSERT INTO `character_buffs` (character_id, slot_id, spell_id, "
+			if(!database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query, "INSERT INTO `character_buffs` (character_id, slot_id, spell_id, "
 				"caster_level, caster_name, ticsremaining, counters, numhits, melee_rune, magic_rune, persistent, dot_rune, "
 				"caston_x, caston_y, caston_z, ExtraDIChance) VALUES('%u', '%u', '%u', '%u', '%s', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%i', '%i', '%i', '%i')",
 				c->CharacterID(), i, buffs[i].spellid, buffs[i].casterlevel, buffs[i].caster_name, buffs[i].ticsremaining,
 				buffs[i].counters, buffs[i].numhits, buffs[i].melee_rune, buffs[i].magic_rune, buffs[i].persistant_buff,
-				buffs[i].dot_rune, buffs[i].caston_x, buffs[i].caston_y, buffs[i].caston_z, buffs[i].ExtraDIChance),
+				buffs[i].dot_rune, buffs[i].caston_x, buffs[i].caston_y, buffs[i].caston_z, buffs[i].ExtraDIChance)),
 				errbuf)) {
 				LogFile->write(EQEMuLog::Error, "Error in SaveBuffs query '%s': %s", query, errbuf);
 			}
 		}
 	}
 	safe_delete_array(query);
+	return written;
 }
 
 void ZoneDatabase::LoadBuffs(Client *c) {
@@ -1927,58 +1682,59 @@ void ZoneDatabase::LoadBuffs(Client *c) {
 	}
 }
 
-void ZoneDatabase::SavePetInfo(Client *c) {
+uint32 ZoneDatabase::SavePetInfo(Client *c) {
 	char errbuf[MYSQL_ERRMSG_SIZE];
 	char* query = 0;
+	uint32 written = 0;
 	int i = 0;
 	PetInfo *petinfo = c->GetPetInfo(0);
 	PetInfo *suspended = c->GetPetInfo(1);
 
-	if(!database.RunQuery(query, MakeAnyLenString(&query, "DELETE FROM `character_pet_buffs` WHERE `char_id`=%u", c->CharacterID()),
+	if(!database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query, "DELETE FROM `character_pet_buffs` WHERE `char_id`=%u", c->CharacterID())),
 		errbuf)) {
 		safe_delete_array(query);
-		return;
+		return written;
 	}
 	safe_delete_array(query);
-	if (!database.RunQuery(query, MakeAnyLenString(&query, "DELETE FROM `character_pet_inventory` WHERE `char_id`=%u", c->CharacterID()),
+	if (!database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query, "DELETE FROM `character_pet_inventory` WHERE `char_id`=%u", c->CharacterID())),
 		errbuf)) {
 		safe_delete_array(query);
 		// error report
-		return;
+		return written;
 	}
 	safe_delete_array(query);
 
-	if(!database.RunQuery(query, MakeAnyLenString(&query,
+	if(!database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query,
 		"INSERT INTO `character_pet_info` (`char_id`, `pet`, `petname`, `petpower`, `spell_id`, `hp`, `mana`, `size`) "
 		"values (%u, 0, '%s', %i, %u, %u, %u, %f) "
 		"ON DUPLICATE KEY UPDATE `petname`='%s', `petpower`=%i, `spell_id`=%u, `hp`=%u, `mana`=%u, `size`=%f",
 		c->CharacterID(), petinfo->Name, petinfo->petpower, petinfo->SpellID, petinfo->HP, petinfo->Mana, petinfo->size,
-		petinfo->Name, petinfo->petpower, petinfo->SpellID, petinfo->HP, petinfo->Mana, petinfo->size),
+		petinfo->Name, petinfo->petpower, petinfo->SpellID, petinfo->HP, petinfo->Mana, petinfo->size)),
 		errbuf))
 	{
 		safe_delete_array(query);
-		return;
+		return written;
 	}
 	safe_delete_array(query);
 
 	for(i=0; i < RuleI(Spells, MaxTotalSlotsPET); i++) {
 		if (petinfo->Buffs[i].spellid != SPELL_UNKNOWN && petinfo->Buffs[i].spellid != 0) {
-			database.RunQuery(query, MakeAnyLenString(&query,
+			database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query,
 				"INSERT INTO `character_pet_buffs` (`char_id`, `pet`, `slot`, `spell_id`, `caster_level`, "
 				"`ticsremaining`, `counters`) values "
 				"(%u, 0, %u, %u, %u, %u, %d)",
 				c->CharacterID(), i, petinfo->Buffs[i].spellid, petinfo->Buffs[i].level, petinfo->Buffs[i].duration,
-				petinfo->Buffs[i].counters),
+				petinfo->Buffs[i].counters)),
 				errbuf);
 			safe_delete_array(query);
 		}
 		if (suspended->Buffs[i].spellid != SPELL_UNKNOWN && suspended->Buffs[i].spellid != 0) {
-			database.RunQuery(query, MakeAnyLenString(&query,
+			database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query,
 				"INSERT INTO `character_pet_buffs` (`char_id`, `pet`, `slot`, `spell_id`, `caster_level`, "
 				"`ticsremaining`, `counters`) values "
 				"(%u, 1, %u, %u, %u, %u, %d)",
 				c->CharacterID(), i, suspended->Buffs[i].spellid, suspended->Buffs[i].level, suspended->Buffs[i].duration,
-				suspended->Buffs[i].counters),
+				suspended->Buffs[i].counters)),
 				errbuf);
 			safe_delete_array(query);
 		}
@@ -1986,38 +1742,39 @@ void ZoneDatabase::SavePetInfo(Client *c) {
 
 	for(i=0; i<MAX_WORN_INVENTORY; i++) {
 		if(petinfo->Items[i]) {
-			database.RunQuery(query, MakeAnyLenString(&query,
+			database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query,
 				"INSERT INTO `character_pet_inventory` (`char_id`, `pet`, `slot`, `item_id`) values (%u, 0, %u, %u)",
-				c->CharacterID(), i, petinfo->Items[i]), errbuf);
+				c->CharacterID(), i, petinfo->Items[i])), errbuf);
 			// should check for errors
 			safe_delete_array(query);
 		}
 	}
 
 
-	if(!database.RunQuery(query, MakeAnyLenString(&query,
+	if(!database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query,
 		"INSERT INTO `character_pet_info` (`char_id`, `pet`, `petname`, `petpower`, `spell_id`, `hp`, `mana`, `size`) "
 		"values (%u, 1, '%s', %u, %u, %u, %u, %f) "
 		"ON DUPLICATE KEY UPDATE `petname`='%s', `petpower`=%i, `spell_id`=%u, `hp`=%u, `mana`=%u, `size`=%f",
 		c->CharacterID(), suspended->Name, suspended->petpower, suspended->SpellID, suspended->HP, suspended->Mana, suspended->size,
-		suspended->Name, suspended->petpower, suspended->SpellID, suspended->HP, suspended->Mana, suspended->size),
+		suspended->Name, suspended->petpower, suspended->SpellID, suspended->HP, suspended->Mana, suspended->size)),
 		errbuf))
 	{
 		safe_delete_array(query);
-		return;
+		return written;
 	}
 	safe_delete_array(query);
 
 	for(i=0; i<MAX_WORN_INVENTORY; i++) {
 		if(suspended->Items[i]) {
-			database.RunQuery(query, MakeAnyLenString(&query,
+			database.RunQuery(query, CountQuery(written, MakeAnyLenString(&query,
 				"INSERT INTO `character_pet_inventory` (`char_id`, `pet`, `slot`, `item_id`) values (%u, 1, %u, %u)",
-				c->CharacterID(), i, suspended->Items[i]), errbuf);
+				c->CharacterID(), i, suspended->Items[i])), errbuf);
 			// should check for errors
 			safe_delete_array(query);
 		}
 	}
 
+	return written;
 }
 
 void ZoneDatabase::RemoveTempFactions(Client *c){
@@ -2155,57 +1912,30 @@ void ZoneDatabase::LoadPetInfo(Client *c) {
 	}
 }
 
+//the mod for id from the faction's slot table, 0 if there is none
+static inline int16 FactionModForSlot(const Faction *f, const std::vector<int16> &slots, uint32 id) {
+	if(id == 0 || id >= slots.size())
+		return 0;
+	int16 slot = slots[id];
+	if(slot < 0 || slot >= (int16)f->mods.size())
+		return 0;
+	return f->mods[slot];
+}
+
+//called for every aggro check against a client, so just a few array reads
 bool ZoneDatabase::GetFactionData(FactionMods* fm, uint32 class_mod, uint32 race_mod, uint32 deity_mod, int32 faction_id) {
 	if (faction_id <= 0 || faction_id > (int32) max_faction)
 		return false;
 
-	if (faction_array[faction_id] == 0){
+	const Faction *f = faction_array[faction_id];
+	if (f == 0){
 		return false;
 	}
 
-	fm->base = faction_array[faction_id]->base;
-
-	if(class_mod > 0) {
-		char str[32];
-		sprintf(str, "c%u", class_mod);
-
-		std::map<std::string, int16>::const_iterator iter = faction_array[faction_id]->mods.find(str);
-		if(iter != faction_array[faction_id]->mods.end()) {
-			fm->class_mod = iter->second;
-		} else {
-			fm->class_mod = 0;
-		}
-	} else {
-		fm->class_mod = 0;
-	}
-
-	if(race_mod > 0) {
-		char str[32];
-		sprintf(str, "r%u", race_mod);
-
-		std::map<std::string, int16>::iterator iter = faction_array[faction_id]->mods.find(str);
-		if(iter != faction_array[faction_id]->mods.end()) {
-			fm->race_mod = iter->second;
-		} else {
-			fm->race_mod = 0;
-		}
-	} else {
-		fm->race_mod = 0;
-	}
-
-	if(deity_mod > 0) {
-		char str[32];
-		sprintf(str, "d%u", deity_mod);
-
-		std::map<std::string, int16>::iterator iter = faction_array[faction_id]->mods.find(str);
-		if(iter != faction_array[faction_id]->mods.end()) {
-			fm->deity_mod = iter->second;
-		} else {
-			fm->deity_mod = 0;
-		}
-	} else {
-		fm->deity_mod = 0;
-	}
+	fm->base = f->base;
+	fm->class_mod = FactionModForSlot(f, faction_class_slot, class_mod);
+	fm->race_mod = FactionModForSlot(f, faction_race_slot, race_mod);
+	fm->deity_mod = FactionModForSlot(f, faction_deity_slot, deity_mod);
 
 	return true;
 }
@@ -2342,7 +2072,7 @@ bool ZoneDatabase::LoadFactionData()
 		{
 			max_faction = atoi(row[0]);
 			faction_array = new Faction*[max_faction+1];
-			for(unsigned int i=0; i<max_faction; i++)
+			for(unsigned int i=0; i<=max_faction; i++)
 			{
 				faction_array[i] = nullptr;
 			}
@@ -2355,24 +2085,16 @@ bool ZoneDatabase::LoadFactionData()
 				while((row = mysql_fetch_row(result)))
 				{
 					uint32 index = atoi(row[0]);
+					if (index > max_faction)
+						continue;
 					faction_array[index] = new Faction;
+					faction_array[index]->id = index;
 					strn0cpy(faction_array[index]->name, row[1], 50);
 					faction_array[index]->base = atoi(row[2]);
-
-					char sec_errbuf[MYSQL_ERRMSG_SIZE];
-					MYSQL_RES *sec_result;
-					MYSQL_ROW sec_row;
-					MakeAnyLenString(&query, "SELECT `mod`, `mod_name` FROM `faction_list_mod` WHERE faction_id=%u", index);
-					if (RunQuery(query, strlen(query), sec_errbuf, &sec_result)) {
-						while((sec_row = mysql_fetch_row(sec_result)))
-						{
-							faction_array[index]->mods[sec_row[1]] = atoi(sec_row[0]);
-						}
-						mysql_free_result(sec_result);
-					}
-					safe_delete_array(query);
 				}
 				mysql_free_result(result);
+
+				LoadFactionMods();
 			}
 			else {
 				std::cerr << "Error in LoadFactionData '" << query << "' " << errbuf << std::endl;
@@ -2392,6 +2114,77 @@ bool ZoneDatabase::LoadFactionData()
 	return true;
 }
 
+//every faction's mods in one query. Each class, race and deity named in a mod_name
+//("c1", "r128", "d201") gets a slot, and every faction with mods gets a flat table
+//of them so GetFactionData never has to build or look up a string.
+void ZoneDatabase::LoadFactionMods()
+{
+	char errbuf[MYSQL_ERRMSG_SIZE];
+	char *query = 0;
+	MYSQL_RES *result;
+	MYSQL_ROW row;
+
+	faction_class_slot.clear();
+	faction_race_slot.clear();
+	faction_deity_slot.clear();
+
+	if (!RunQuery(query, MakeAnyLenString(&query, "SELECT `faction_id`, `mod`, `mod_name` FROM `faction_list_mod`"), errbuf, &result)) {
+		std::cerr << "Error in LoadFactionMods '" << query << "' " << errbuf << std::endl;
+		safe_delete_array(query);
+		return;
+	}
+	safe_delete_array(query);
+
+	struct ModRow {
+		uint32 faction_id;
+		std::vector<int16> *slots;
+		uint32 id;
+		int16 mod;
+	};
+	std::vector<ModRow> rows;
+	int16 slot_count = 0;
+
+	while((row = mysql_fetch_row(result)))
+	{
+		if (row[0] == nullptr || row[1] == nullptr || row[2] == nullptr)
+			continue;
+
+		ModRow r;
+		r.faction_id = atoi(row[0]);
+		if (r.faction_id > max_faction || faction_array[r.faction_id] == nullptr)
+			continue;
+
+		switch(row[2][0]) {
+			case 'c': r.slots = &faction_class_slot; break;
+			case 'r': r.slots = &faction_race_slot; break;
+			case 'd': r.slots = &faction_deity_slot; break;
+			default: continue;
+		}
+		r.id = atoi(row[2] + 1);
+		if (r.id == 0 || r.id > 0xFFFF)
+			continue;
+		r.mod = atoi(row[1]);
+
+		if (r.id >= r.slots->size())
+			r.slots->resize(r.id + 1, -1);
+		if ((*r.slots)[r.id] < 0)
+			(*r.slots)[r.id] = slot_count++;
+
+		rows.push_back(r);
+	}
+	mysql_free_result(result);
+
+	std::vector<ModRow>::iterator cur, end;
+	cur = rows.begin();
+	end = rows.end();
+	for(; cur != end; ++cur) {
+		Faction *f = faction_array[cur->faction_id];
+		if (f->mods.empty())
+			f->mods.resize(slot_count, 0);
+		f->mods[(*cur->slots)[cur->id]] = cur->mod;
+	}
+}
+
 bool ZoneDatabase::GetFactionIdsForNPC(uint32 nfl_id, std::list<struct NPCFaction*> *faction_list, int32* primary_faction) {
 	if (nfl_id <= 0) {
 		std::list<struct NPCFaction*>::iterator cur,end;
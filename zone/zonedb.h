@@ -7,6 +7,9 @@
 #include "zonedump.h"
 #include "../common/faction.h"
 //#include "doors.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 struct wplist {
 	int index;
@@ -17,6 +20,13 @@ struct wplist {
 	float heading;
 };
 
+//a grid and its waypoints in order, a waypoint's index is its position in waypoints
+struct ZoneGrid {
+	int wandertype;
+	int pausetype;
+	std::vector<wplist> waypoints;
+};
+
 #pragma pack(1)
 struct DBnpcspells_entries_Struct {
 	int16	spellid;
@@ -173,10 +183,11 @@ public:
 	bool	GetCharacterInfoForLogin(const char* name, uint32* character_id = 0, char* current_zone = 0,
 				PlayerProfile_Struct* pp = 0, Inventory* inv = 0, ExtendedProfile_Struct *ext = 0, uint32* pplen = 0,
 				uint32* guilddbid = 0, uint8* guildrank = 0, uint8 *class_ = 0, uint8 *level = 0, uint8* firstlogon = 0);
-	void SaveBuffs(Client *c);
+	//these return the number of query bytes sent
+	uint32 SaveBuffs(Client *c);
 	void LoadBuffs(Client *c);
 	void LoadPetInfo(Client *c);
-	void SavePetInfo(Client *c);
+	uint32 SavePetInfo(Client *c);
 	void RemoveTempFactions(Client *c);
 
 	/*
@@ -190,6 +201,7 @@ public:
 	bool	GetDecayTimes(npcDecayTimes_Struct* npcCorpseDecayTimes);
 	uint32	CreatePlayerCorpse(uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading);
 	bool	CreatePlayerCorpseBackup(uint32 dbid, uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading);
+	uint32	UpdatePlayerCorpse_MQ(char** query, uint32 dbid, uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading, bool rezzed = false);
 	uint32	UpdatePlayerCorpse(uint32 dbid, uint32 charid, const char* charname, uint32 zoneid, uint16 instanceid, uchar* data, uint32 datasize, float x, float y, float z, float heading, bool rezzed = false);
 	void	MarkCorpseAsRezzed(uint32 dbid);
 	bool	BuryPlayerCorpse(uint32 dbid);
@@ -221,6 +233,7 @@ public:
 	bool	GetFactionIdsForNPC(uint32 nfl_id, std::list<struct NPCFaction*> *faction_list, int32* primary_faction = 0); // neotokyo: improve faction handling
 	bool	SetCharacterFactionLevel(uint32 char_id, int32 faction_id, int32 value, uint8 temp, faction_map &val_list); // rembrant, needed for factions Dec, 16 2001
 	bool	LoadFactionData();
+	void	LoadFactionMods();
 	bool	LoadFactionValues(uint32 char_id, faction_map & val_list);
 	bool	LoadFactionValues_result(MYSQL_RES* result, faction_map & val_list);
 
@@ -264,6 +277,8 @@ public:
 	/*
 	* Grids/Paths
 	*/
+	//all of the zone's grids and their entries in two queries, or only grid_id if it is set
+	bool	LoadGrids(uint32 zoneid, std::unordered_map<uint32, std::shared_ptr<ZoneGrid> > &grids, uint32 grid_id = 0);
 	uint32	GetFreeGrid(uint16 zoneid);
 	void	DeleteGrid(Client *c, uint32 sg2, uint32 grid_num, bool grid_too,uint16 zoneid);
 	void	DeleteWaypoint(Client *c, uint32 grid_num, uint32 wp_num,uint16 zoneid);
@@ -392,6 +407,10 @@ protected:
 
 	uint32				max_faction;
 	Faction**			faction_array;
+	//class, race and deity id to its slot in Faction::mods, -1 if no faction has a mod for it
+	std::vector<int16>	faction_class_slot;
+	std::vector<int16>	faction_race_slot;
+	std::vector<int16>	faction_deity_slot;
 	uint32 npc_spells_maxid;
 	uint32 npc_spellseffects_maxid;
 	DBnpcspells_Struct** npc_spells_cache;
@@ -10,6 +10,10 @@ bool DBAsyncCB_CharacterBackup(DBAsyncWork* iWork);
 #define DBA_b4_Zone			3
 #define DBA_b4_Entity		4
 
+// DBAsyncWork coalesce key kinds, see DBAsyncWork::MakeCoalesceKey
+#define DBA_Coalesce_Character	1
+#define DBA_Coalesce_Corpse		2
+
 #define DBA_b1_Entity_SeeQPT				0
 #define DBA_b1_Entity_Client_InfoForLogin	1
 #define DBA_b1_Entity_Client_Save			2
@@ -17,6 +21,7 @@ bool DBAsyncCB_CharacterBackup(DBAsyncWork* iWork);
 #define DBA_b1_Entity_Corpse_Backup			4
 #define DBA_b1_Zone_MerchantLists			5
 #define DBA_b1_Zone_MerchantListsTemp		6
+#define DBA_b1_Entity_Corpse_Save			7
 
 #endif
 
@@ -29,99 +29,10 @@ spawn2 mediumblob, npcs mediumblob, npc_loot mediumblob, gmspawntype mediumblob,
 #include "../common/faction.h"
 #include "../common/eq_packet_structs.h"
 #include "../common/Item.h"
+#include "../common/npc_type.h"
 
 #pragma pack(1)
 
-struct NPCType
-{
-	char	name[64];
-	char	lastname[70];
-
-	int32	cur_hp;
-	int32	max_hp;
-
-	float	size;
-	float	runspeed;
-	uint8	gender;
-	uint16	race;
-	uint8	class_;
-	uint8	bodytype;	// added for targettype support
-	uint8	deity;		//not loaded from DB
-	uint8	level;
-	uint32	npc_id;
-	uint8	texture;
-	uint8	helmtexture;
-	uint32	loottable_id;
-	uint32	npc_spells_id;
-	uint32	npc_spells_effects_id;
-	int32	npc_faction_id;
-	uint32	merchanttype;
-	uint32	trap_template;
-	uint8	light;		//not loaded from DB
-	uint16	AC;
-	uint32	Mana;	//not loaded from DB
-	uint16	ATK;	//not loaded from DB
-	uint16	STR;
-	uint16	STA;
-	uint16	DEX;
-	uint16	AGI;
-	uint16	INT;
-	uint16	WIS;
-	uint16	CHA;
-	int16	MR;
-	int16	FR;
-	int16	CR;
-	int16	PR;
-	int16	DR;
-	int16	Corrup;
-	int16   PhR;
-	uint8	haircolor;
-	uint8	beardcolor;
-	uint8	eyecolor1;			// the eyecolors always seem to be the same, maybe left and right eye?
-	uint8	eyecolor2;
-	uint8	hairstyle;
-	uint8	luclinface;			//
-	uint8	beard;				//
-	uint32	drakkin_heritage;
-	uint32	drakkin_tattoo;
-	uint32	drakkin_details;
-	uint32	armor_tint[_MaterialCount];
-	uint32	min_dmg;
-	uint32	max_dmg;
-	int16	attack_count;
-	char special_abilities[512];
-	uint16	d_meele_texture1;
-	uint16	d_meele_texture2;
-	uint8	prim_melee_type;
-	uint8	sec_melee_type;
-	int32	hp_regen;
-	int32	mana_regen;
-	int32	aggroradius; // added for AI improvement - neotokyo
-	int32	assistradius; // assist radius, defaults to aggroradis if not set
-	uint8	see_invis;			// See Invis flag added
-	bool	see_invis_undead;	// See Invis vs. Undead flag added
-	bool	see_hide;
-	bool	see_improved_hide;
-	bool	qglobal;
-	bool	npc_aggro;
-	uint8	spawn_limit;	//only this many may be in zone at a time (0=no limit)
-	uint8	mount_color;	//only used by horse class
-	float	attack_speed;	//%+- on attack delay of the mob.
-	int		accuracy_rating;	//10 = 1% accuracy
-	bool	findable;		//can be found with find command
-	bool	trackable;
-	int16	slow_mitigation;	
-	uint8	maxlevel;
-	uint32	scalerate;
-	bool	private_corpse;
-	bool	unique_spawn_by_name;
-	bool	underwater;
-	uint32	emoteid;
-	float	spellscale;
-	float	healscale;
-	bool	no_target_hotkey;
-};
-
 /*
 Below are the blob structures for saving player corpses to the database
 -Quagmire